@@ -0,0 +1,1057 @@
+// SPDX-FileCopyrightText: 2022 Cem Geçgel <gecgelcem@outlook.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Measures the features of the parsing runtime on inputs that are made for
+// each of them, against parsing the same inputs without the feature. The
+// arguments are the features to measure.
+
+#include "dil/buffer.c"
+#include "dil/incremental.c"
+#include "dil/iterative.c"
+#include "dil/machine.c"
+#include "dil/memo.c"
+#include "dil/parallel.c"
+#include "dil/parser.c"
+#include "dil/program.c"
+#include "dil/push.c"
+#include "dil/source.c"
+#include "dil/string.c"
+#include "dil/tree.c"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Amount of times each process is run, of which the fastest is measured. */
+#define BENCHMARK_ROUNDS 3
+
+/* Amount of levels of the choices in the grammar of the memo benchmark. Each
+ * level doubles the attempts without the memo. */
+#define BENCHMARK_MEMO_DEPTH 12
+
+/* Amount of times the comments of the skip benchmark are repeated. */
+#define BENCHMARK_SKIP_TIMES 20000
+
+/* Amount of times the rules of the iterative benchmark are repeated. */
+#define BENCHMARK_ITERATIVE_TIMES 20000
+
+/* Amount of groups each rule of the iterative benchmark nests. */
+#define BENCHMARK_ITERATIVE_DEPTH 1000
+
+/* Amount of random edits the edit benchmark applies to each source file. */
+#define BENCHMARK_EDITS 100
+
+/* Amount of times the rules of the parallel benchmark are repeated. */
+#define BENCHMARK_PARALLEL_TIMES 40000
+
+/* Most threads the parallel benchmark parses on, which are doubled from one
+ * up to it. */
+#define BENCHMARK_PARALLEL_THREADS 8
+
+/* Function that parses a source file into a tree. */
+typedef DilTree (*BenchmarkParse)(DilSource source, DilParseOptions options);
+
+/* Function that tries to skip once. */
+typedef bool (*BenchmarkSkip)(DilParseContext* context);
+
+/* Program the machine runs, or null. */
+DilProgram const* benchmark_program = NULL;
+
+/* Amount of threads the parallel parser parses on. */
+size_t benchmark_threads = 1;
+
+/* Current time in seconds. */
+double benchmark_now(void)
+{
+    struct timespec now;
+    (void)timespec_get(&now, TIME_UTC);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+/* Add the null terminated text to the end of the buffer. */
+void benchmark_append(DilBuffer* buffer, char const* text)
+{
+    size_t size = strlen(text);
+    dil_buffer_reserve(buffer, size);
+    memcpy(buffer->last, text, size);
+    buffer->last += size;
+}
+
+/* Source file at the path whose contents are the buffer. */
+DilSource benchmark_source(DilBuffer const* buffer, char const* path)
+{
+    return (DilSource){
+        .path     = path,
+        .contents = {.first = buffer->first, .last = buffer->last}};
+}
+
+/* Parse the source file by running the program with the machine. */
+DilTree benchmark_machine(DilSource source, DilParseOptions options)
+{
+    return dil_machine_parse_with(benchmark_program, source, options);
+}
+
+/* Seconds the fastest of the rounds of parsing the source file took. Puts
+ * the amount of nodes in the tree to the nodes. */
+double benchmark_time(
+    BenchmarkParse  parse,
+    DilSource       source,
+    DilParseOptions options,
+    size_t*         nodes)
+{
+    double fastest = 0;
+    for (int i = 0; i < BENCHMARK_ROUNDS; i++) {
+        double  start   = benchmark_now();
+        DilTree tree    = parse(source, options);
+        double  seconds = benchmark_now() - start;
+        if (i == 0 || seconds < fastest) {
+            fastest = seconds;
+        }
+        *nodes = dil_tree_size(&tree);
+        dil_tree_free(&tree);
+    }
+    return fastest;
+}
+
+/* Parse the source file with the parallel parser on the amount of threads
+ * of the benchmark. */
+DilTree benchmark_parallel_parse(DilSource source, DilParseOptions options)
+{
+    return dil_parse_parallel(source, options, benchmark_threads);
+}
+
+/* Add a grammar whose start pattern goes through the amount of levels of
+ * choices, whose alternatives start with the rule of the next level. The
+ * last level rejects `zy` only at its second character, so at each offset
+ * every level is rejected twice unless the rejections are memoized. */
+void benchmark_memo_grammar(DilBuffer* grammar, size_t depth)
+{
+    benchmark_append(grammar, "start *Statement;\n");
+    benchmark_append(grammar, "Statement = La 'x' | \"zy\";\n");
+    for (size_t i = 0; i < depth; i++) {
+        char const current[] = {'L', (char)('a' + i), 0};
+        char const next[]    = {'L', (char)('a' + i + 1), 0};
+        benchmark_append(grammar, current);
+        benchmark_append(grammar, " = ");
+        benchmark_append(grammar, next);
+        benchmark_append(grammar, " 'p' | ");
+        benchmark_append(grammar, next);
+        benchmark_append(grammar, " 'q';\n");
+    }
+    char const last[] = {'L', (char)('a' + depth), 0};
+    benchmark_append(grammar, last);
+    benchmark_append(grammar, " = \"zz\";\n");
+}
+
+/* Run the grammar of the memo benchmark on growing inputs with and without
+ * the memo. Without it the time per statement grows exponentially with the
+ * depth of the grammar, while with it the time stays linear in the input.
+ * Returns whether the trees were the same. */
+bool benchmark_memo(void)
+{
+    DilBuffer          grammar    = {0};
+    DilParseStatistics statistics = {0};
+    DilProgram         program    = {0};
+    benchmark_memo_grammar(&grammar, BENCHMARK_MEMO_DEPTH);
+    DilTree tree = dil_parse_with(
+        benchmark_source(&grammar, "memo.dil"),
+        (DilParseOptions){.statistics = &statistics});
+
+    bool same = statistics.errors == 0 && dil_program_compile(&program, &tree);
+    dil_tree_free(&tree);
+    dil_buffer_free(&grammar);
+    if (!same) {
+        printf("memo.dil: error: Could not compile the grammar!\n");
+        dil_program_free(&program);
+        return false;
+    }
+    benchmark_program = &program;
+
+    printf("Memo, %d levels of choices:\n", BENCHMARK_MEMO_DEPTH);
+    printf(
+        "%-12s %12s %12s %12s %10s\n",
+        "Statements",
+        "Without ms",
+        "With ms",
+        "With ns/B",
+        "Hit rate");
+    DilBuffer input = {0};
+    for (size_t statements = 250; statements <= 2000 && same;
+         statements *= 2) {
+        dil_buffer_clear(&input);
+        for (size_t i = 0; i < statements; i++) {
+            benchmark_append(&input, "zy");
+        }
+        DilSource source = benchmark_source(&input, "memo");
+        DilMemo   memo   = {0};
+        size_t    plain  = 0;
+        size_t    nodes  = 0;
+
+        double without = benchmark_time(
+            &benchmark_machine,
+            source,
+            (DilParseOptions){.quiet = true},
+            &plain);
+        double with    = benchmark_time(
+            &benchmark_machine,
+            source,
+            (DilParseOptions){.memo = &memo, .quiet = true},
+            &nodes);
+        size_t lookups = memo.hits + memo.misses;
+        printf(
+            "%-12llu %12.2f %12.2f %12.1f %9.1f%%\n",
+            statements,
+            without * 1e3,
+            with * 1e3,
+            with * 1e9 / (double)dil_buffer_size(&input),
+            lookups == 0 ? 0.0 : 100.0 * (double)memo.hits / (double)lookups);
+        dil_memo_free(&memo);
+        same = plain == nodes;
+    }
+    printf("\n");
+    if (!same) {
+        printf("memo: error: Trees differ with the memo!\n");
+    }
+
+    dil_buffer_free(&input);
+    dil_program_free(&program);
+    benchmark_program = NULL;
+    return same;
+}
+
+/* Try to skip once by calling the whitespace and comment rules in skip mode,
+ * which builds and removes their nodes. This is how the parser skipped
+ * before it recognized the rules directly on the contents. */
+bool benchmark_skip_rules(DilParseContext* context)
+{
+    static DilParseFirst const FIRST = {
+        ['\t'] = 1 << 0,
+        ['\n'] = 1 << 0,
+        [' ']  = 1 << 0,
+        ['/']  = 1 << 1};
+
+    unsigned viable = dil_parse__viable(context, FIRST);
+    context->skip   = true;
+    bool accept =
+        (dil_parse__try(context, viable, 0) && dil_parse_whitespace(context)) ||
+        (dil_parse__try(context, viable, 1) && dil_parse_comment(context));
+    context->skip = false;
+    return accept;
+}
+
+/* Skip as much as possible with the scanner, which is how the parser skips
+ * between the elements. Fails if nothing is skipped. */
+bool benchmark_skip_scanner(DilParseContext* context)
+{
+    char const* first = context->remaining.first;
+    dil_parse__skip_0(context);
+    return context->remaining.first != first;
+}
+
+/* Whether a rule with an error that is followed by spaces ends after the
+ * single space the error skips to, like it did when the spaces were skipped
+ * one at a time. */
+bool benchmark_skip_error(void)
+{
+    char const text[] = "A = )    ;\n";
+    DilSource  source = {
+         .path     = "skip",
+         .contents = {.first = text, .last = text + sizeof(text) - 1}};
+    DilTree tree = dil_parse_with(source, (DilParseOptions){.quiet = true});
+    DilString const* rule = NULL;
+    for (size_t i = 0; i < dil_tree_size(&tree); i++) {
+        DilObject const* object = &dil_tree_at(&tree, i)->object;
+        if (object->symbol == DIL_SYMBOL_RULE) {
+            rule = &object->value;
+            break;
+        }
+    }
+
+    bool same = rule != NULL && rule->last == text + 6;
+    if (!same) {
+        printf("skip: error: Rule with an error ends after the spaces!\n");
+    }
+    dil_tree_free(&tree);
+    return same;
+}
+
+/* Seconds the fastest of the rounds of skipping the source file with the
+ * skipper took. Returns a negative amount if it did not skip all of it. */
+double benchmark_skip_time(BenchmarkSkip skip, DilSource source)
+{
+    double fastest = 0;
+    for (int i = 0; i < BENCHMARK_ROUNDS; i++) {
+        DilParseContext context = {
+            .builder   = {.built = &context.built},
+            .remaining = source.contents,
+            .source    = source,
+            .options   = {.quiet = true}};
+
+        double start = benchmark_now();
+        dil_parse__open(&context);
+        while (skip(&context)) {}
+        bool   all     = !dil_string_finite(&context.remaining);
+        double seconds = benchmark_now() - start;
+
+        dil_parse__close(&context);
+        DilTree tree = dil_parse__conclude(&context);
+        dil_tree_free(&tree);
+        if (!all) {
+            return -1;
+        }
+        if (i == 0 || seconds < fastest) {
+            fastest = seconds;
+        }
+    }
+    return fastest;
+}
+
+/* Skip a source file that only has comments and whitespace, by recognizing
+ * them directly and by calling their rules in skip mode. Returns whether
+ * both skipped all of it. */
+bool benchmark_skip(void)
+{
+    DilBuffer input = {0};
+    for (size_t i = 0; i < BENCHMARK_SKIP_TIMES; i++) {
+        benchmark_append(
+            &input,
+            "\n// Comment that explains the rule that comes after it.\n"
+            "    // Indented comment with some more words in it.\n");
+    }
+    DilSource source  = benchmark_source(&input, "skip");
+    double    bytes   = (double)dil_buffer_size(&input);
+    double    scanner = benchmark_skip_time(&benchmark_skip_scanner, source);
+    double    rules   = benchmark_skip_time(&benchmark_skip_rules, source);
+
+    printf("Skip, %.0f bytes of comments:\n", bytes);
+    printf("%-12s %10s\n", "Skipper", "MB/s");
+    printf("%-12s %10.1f\n", "scanner", bytes / scanner / 1e6);
+    printf("%-12s %10.1f\n", "rules", bytes / rules / 1e6);
+    printf("\n");
+
+    bool same = scanner > 0 && rules > 0;
+    if (!same) {
+        printf("skip: error: Did not skip all of the comments!\n");
+    }
+    dil_buffer_free(&input);
+    return benchmark_skip_error() && same;
+}
+
+/* Add a few ordinary rules the amount of times. */
+void benchmark_rules(DilBuffer* input, size_t times)
+{
+    for (size_t i = 0; i < times; i++) {
+        benchmark_append(
+            input,
+            "Rule = Identifier '=' Pattern ';';\n"
+            "Unit = Set | String | Reference | 2'0~9' ?Unit;\n");
+    }
+}
+
+/* Add the rules of the iterative benchmark, which are flat or nest the
+ * amount of groups in each rule. */
+void benchmark_iterative_input(DilBuffer* input, size_t depth)
+{
+    if (depth == 0) {
+        benchmark_rules(input, BENCHMARK_ITERATIVE_TIMES);
+        return;
+    }
+    for (size_t i = 0; i < BENCHMARK_ITERATIVE_TIMES / depth; i++) {
+        benchmark_append(input, "Deep = ");
+        for (size_t j = 0; j < depth; j++) {
+            benchmark_append(input, "(");
+        }
+        benchmark_append(input, "'a'");
+        for (size_t j = 0; j < depth; j++) {
+            benchmark_append(input, ")");
+        }
+        benchmark_append(input, ";\n");
+    }
+}
+
+/* Amount of rules the iterative parser nests for a rule with the amount of
+ * groups, which are `Statement` and `Rule`, a `Pattern`, an `Alternative`
+ * and a `Unit` for the rule and each group, and a `Group` for each group.
+ * The set in the innermost group does not nest. */
+size_t benchmark_iterative_levels(size_t depth)
+{
+    return 2 + 3 * (depth + 1) + depth;
+}
+
+/* Whether the iterative parser parses the nested rules without errors when
+ * its depth limit is exactly the rules they nest, and reports an error when
+ * it is one less. */
+bool benchmark_iterative_limit(void)
+{
+    DilBuffer input = {0};
+    benchmark_iterative_input(&input, BENCHMARK_ITERATIVE_DEPTH);
+    DilSource          source  = benchmark_source(&input, "iterative");
+    size_t             levels  = benchmark_iterative_levels(
+        BENCHMARK_ITERATIVE_DEPTH);
+    DilParseStatistics reached = {0};
+    DilParseStatistics stopped = {0};
+    DilTree            full    = dil_parse_with(
+        source,
+        (DilParseOptions){.quiet = true});
+    DilTree at = dil_parse_iterative(
+        source,
+        (DilParseOptions){
+            .statistics = &reached,
+            .depth      = levels,
+            .quiet      = true});
+    DilTree below = dil_parse_iterative(
+        source,
+        (DilParseOptions){
+            .statistics = &stopped,
+            .depth      = levels - 1,
+            .quiet      = true});
+
+    bool exact = reached.errors == 0 &&
+                 dil_tree_size(&at) == dil_tree_size(&full) &&
+                 stopped.errors != 0;
+    if (!exact) {
+        printf(
+            "iterative: error: Found %llu errors at the limit of %llu rules "
+            "and %llu errors below it!\n",
+            reached.errors,
+            levels,
+            stopped.errors);
+    }
+    dil_tree_free(&full);
+    dil_tree_free(&at);
+    dil_tree_free(&below);
+    dil_buffer_free(&input);
+    return exact;
+}
+
+/* Parse flat and nested rules with the recursive and the iterative parsers.
+ * Returns whether the trees were the same size, and the depth limit of the
+ * iterative parser is exact. */
+bool benchmark_iterative(void)
+{
+    size_t const depths[] = {0, BENCHMARK_ITERATIVE_DEPTH};
+    bool         same     = true;
+
+    printf("Iterative:\n");
+    printf(
+        "%-12s %10s %10s %12s\n",
+        "Input",
+        "Recursive",
+        "Iterative",
+        "Nodes");
+    for (size_t i = 0; i < sizeof(depths) / sizeof(depths[0]); i++) {
+        DilBuffer input = {0};
+        benchmark_iterative_input(&input, depths[i]);
+        DilSource       source  = benchmark_source(&input, "iterative");
+        DilParseOptions options = {.quiet = true};
+        size_t          nodes   = 0;
+        size_t          stacked = 0;
+        double          bytes   = (double)dil_buffer_size(&input);
+
+        double recursive =
+            benchmark_time(&dil_parse_with, source, options, &nodes);
+        double iterative =
+            benchmark_time(&dil_parse_iterative, source, options, &stacked);
+        printf(
+            "%-12s %10.1f %10.1f %12llu\n",
+            depths[i] == 0 ? "flat" : "nested",
+            bytes / recursive / 1e6,
+            bytes / iterative / 1e6,
+            nodes);
+        dil_buffer_free(&input);
+        same = same && nodes == stacked;
+    }
+    printf("\n");
+    if (!same) {
+        printf("iterative: error: Trees differ between the parsers!\n");
+    }
+    return benchmark_iterative_limit() && same;
+}
+
+/* Parse rules that nest more and more groups with and without the memo.
+ * Every group is remembered with all the groups in it, so the memo must not
+ * copy their subtrees. Returns whether the trees were the same size. */
+bool benchmark_memo_nested(void)
+{
+    static size_t const depths[] = {10, 100, 1000};
+    bool                same     = true;
+    printf("Memo, nested groups:\n");
+    printf("%-12s %12s %12s\n", "Depth", "Without ms", "With ms");
+    for (size_t i = 0; i < sizeof(depths) / sizeof(depths[0]); i++) {
+        DilBuffer input = {0};
+        benchmark_iterative_input(&input, depths[i]);
+        DilSource source = benchmark_source(&input, "nested");
+        DilMemo   memo   = {0};
+        size_t    plain  = 0;
+        size_t    nodes  = 0;
+
+        double without = benchmark_time(
+            &dil_parse_with,
+            source,
+            (DilParseOptions){.quiet = true},
+            &plain);
+        double with = benchmark_time(
+            &dil_parse_with,
+            source,
+            (DilParseOptions){.memo = &memo, .quiet = true},
+            &nodes);
+        printf(
+            "%-12llu %12.2f %12.2f\n",
+            depths[i],
+            without * 1e3,
+            with * 1e3);
+        dil_memo_free(&memo);
+        dil_buffer_free(&input);
+        same = same && plain == nodes;
+    }
+    printf("\n");
+    if (!same) {
+        printf("memo: error: Trees of nested groups differ with the memo!\n");
+    }
+    return same;
+}
+
+/* Parse a group with an error twice at the same characters under parents
+ * that are rejected, and once more under one that is accepted. The memo
+ * gives the group from its copy after the first parent removed it, and must
+ * report its error again. Returns whether the errors and the trees were the
+ * same as without the memo. */
+bool benchmark_memo_errors(void)
+{
+    static char const TEXT[] = "( ;";
+    DilSource         source = {
+        .path     = "errors",
+        .contents = {.first = TEXT, .last = TEXT + sizeof(TEXT) - 1}
+    };
+    size_t errors[2] = {0};
+    size_t nodes[2]  = {0};
+    for (size_t i = 0; i < 2; i++) {
+        DilMemo         memo    = {0};
+        DilParseContext context = {
+            .builder   = {.built = &context.built},
+            .remaining = source.contents,
+            .source    = source,
+            .options   = {.memo = i == 0 ? NULL : &memo, .quiet = true}};
+        dil_parse__open(&context);
+        for (size_t j = 0; j < 3; j++) {
+            dil_parse__create(&context, DIL_SYMBOL_STATEMENT);
+            (void)dil_parse_group(&context);
+            (void)dil_parse__return(&context, j == 2);
+        }
+        dil_parse__close(&context);
+        errors[i]    = context.source.error;
+        DilTree tree = dil_parse__conclude(&context);
+        nodes[i]     = dil_tree_size(&tree);
+        dil_tree_free(&tree);
+        dil_memo_free(&memo);
+    }
+
+    bool same = errors[0] == errors[1] && nodes[0] == nodes[1];
+    if (!same) {
+        printf(
+            "memo: error: Found %llu errors and %llu nodes instead of %llu "
+            "and %llu with the memo!\n",
+            errors[1],
+            nodes[1],
+            errors[0],
+            nodes[0]);
+    }
+    return same;
+}
+
+/* Whether the trees are the same. Prints the first difference otherwise. */
+bool benchmark_compare(
+    DilSource const* source,
+    DilTree const*   expected,
+    DilTree const*   actual)
+{
+    for (size_t i = 0; i < dil_tree_size(expected); i++) {
+        if (i == dil_tree_size(actual)) {
+            break;
+        }
+        DilNode const* lhs = dil_tree_at(expected, i);
+        DilNode const* rhs = dil_tree_at(actual, i);
+        if (lhs->object.symbol != rhs->object.symbol ||
+            lhs->childeren != rhs->childeren ||
+            lhs->object.value.first != rhs->object.value.first ||
+            lhs->object.value.last != rhs->object.value.last) {
+            printf(
+                "%s: error: Node %llu differs from a full parse!\n",
+                source->path,
+                i);
+            return false;
+        }
+    }
+    if (dil_tree_size(expected) != dil_tree_size(actual)) {
+        printf(
+            "%s: error: Tree has %llu nodes instead of %llu!\n",
+            source->path,
+            dil_tree_size(actual),
+            dil_tree_size(expected));
+        return false;
+    }
+    return true;
+}
+
+/* Next number of the random sequence in the state. */
+size_t benchmark_random(size_t* state)
+{
+    *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return *state >> 33;
+}
+
+/* Apply the edit with dil_parse_edit, and parse the whole source file
+ * again. Adds the seconds both took to the timings. Compares the trees and
+ * the recorded errors if checked, which moves the gap of the document to the
+ * end. Returns whether the trees and the errors were the same. */
+bool benchmark_apply(
+    DilParseDocument*    document,
+    DilBuffer*           buffer,
+    DilSource*           source,
+    DilSourceEdit const* edit,
+    double               timings[2],
+    bool                 checked)
+{
+    DilIndices         expected   = {0};
+    DilParseStatistics statistics = {0};
+    double             start      = benchmark_now();
+    dil_parse_edit(document, buffer, source, edit);
+    double    middle = benchmark_now();
+    DilSource whole  = {.path = source->path, .contents = source->contents};
+    DilTree   parsed = dil_parse_with(
+        whole,
+        (DilParseOptions){
+              .statistics = &statistics,
+              .quiet      = true,
+              .errors     = &expected});
+    double end = benchmark_now();
+    timings[0] += middle - start;
+    timings[1] += end - middle;
+    if (!checked) {
+        dil_indices_free(&expected);
+        dil_tree_free(&parsed);
+        return true;
+    }
+
+    DilIndices const* errors   = dil_parse_document_errors(document);
+    size_t            recorded = dil_indices_size(errors);
+    bool              same     = benchmark_compare(
+        source,
+        &parsed,
+        dil_parse_document_tree(document, source));
+    if (same && (statistics.errors != source->error ||
+                 dil_indices_size(&expected) != recorded ||
+                 (recorded > 0 && memcmp(
+                                      expected.first,
+                                      errors->first,
+                                      recorded * sizeof(size_t)) != 0))) {
+        printf(
+            "%s: error: Found %llu errors instead of %llu!\n",
+            source->path,
+            source->error,
+            statistics.errors);
+        same = false;
+    }
+    dil_indices_free(&expected);
+    dil_tree_free(&parsed);
+    return same;
+}
+
+/* Apply random edits to the source file, each followed by the one that
+ * undoes it. Returns whether the trees and the errors were the same as
+ * full parses. */
+bool benchmark_edit_random(
+    DilParseDocument* document,
+    DilBuffer*        buffer,
+    DilSource*        source,
+    size_t*           state)
+{
+    static char const* const TEXTS[] = {
+        "",
+        "a",
+        " ",
+        "'x'",
+        ";",
+        "(",
+        "!",
+        "\nOther = 'b' | Rule;\n",
+        "// Comment\n"};
+    size_t const amount     = sizeof(TEXTS) / sizeof(TEXTS[0]);
+    double       timings[2] = {0};
+    bool         same       = true;
+    for (size_t i = 0; i < BENCHMARK_EDITS && same; i++) {
+        char const*   text = TEXTS[benchmark_random(state) % amount];
+        size_t        size = dil_string_size(&source->contents);
+        DilSourceEdit edit = {
+            .offset   = benchmark_random(state) % size,
+            .removed  = benchmark_random(state) % 4,
+            .inserted = {.first = text, .last = text + strlen(text)}};
+        if (edit.removed > size - edit.offset) {
+            edit.removed = size - edit.offset;
+        }
+
+        char removed[4];
+        memcpy(removed, source->contents.first + edit.offset, edit.removed);
+        DilSourceEdit undo = {
+            .offset   = edit.offset,
+            .removed  = dil_string_size(&edit.inserted),
+            .inserted = {.first = removed, .last = removed + edit.removed}};
+        same =
+            benchmark_apply(document, buffer, source, &edit, timings, true) &&
+            benchmark_apply(document, buffer, source, &undo, timings, true);
+    }
+    return same;
+}
+
+/* Edit a statement before the contents the parser leaves at the end, which
+ * must be reported once like in a full parse. Returns whether the tree and
+ * the errors were the same as a full parse. */
+bool benchmark_edit_left(void)
+{
+    DilBuffer buffer = {0};
+    benchmark_append(&buffer, "A = B;\nC = D;\n!!!\n");
+    DilSource        source   = benchmark_source(&buffer, "left");
+    DilParseDocument document = {0};
+    dil_parse_document_init(
+        &document,
+        &source,
+        (DilParseOptions){.quiet = true});
+    DilSourceEdit edit = {
+        .offset   = 4,
+        .removed  = 1,
+        .inserted = {.first = "E", .last = "E" + 1}};
+    double timings[2] = {0};
+    bool   same =
+        benchmark_apply(&document, &buffer, &source, &edit, timings, true);
+    dil_parse_document_free(&document);
+    dil_buffer_free(&buffer);
+    return same;
+}
+
+/* Rename identifiers in source files of growing sizes, which keeps them
+ * valid, and measure dil_parse_edit against parsing the whole source file.
+ * The renames are at random offsets, and then near each other as when
+ * typing, where an edit only moves the nodes since the previous one. Then
+ * apply random edits to check the trees and the errors. Returns whether they
+ * were the same as full parses. */
+bool benchmark_edit(void)
+{
+    bool same = benchmark_edit_left();
+    printf("Edit, %d renames:\n", BENCHMARK_EDITS);
+    printf(
+        "%-12s %12s %12s %12s\n",
+        "Bytes",
+        "Random ms",
+        "Near ms",
+        "Full ms");
+    for (size_t times = 10000; times <= 40000 && same; times *= 2) {
+        DilBuffer        buffer     = {0};
+        DilParseDocument document   = {0};
+        size_t           state      = times;
+        double           timings[2] = {0};
+        double           near[2]    = {0};
+        benchmark_rules(&buffer, times);
+        DilSource source = benchmark_source(&buffer, "edit");
+        dil_parse_document_init(
+            &document,
+            &source,
+            (DilParseOptions){.quiet = true});
+
+        // Insert a letter after the capital letter that starts an identifier,
+        // at random offsets and then at most a few statements apart.
+        size_t offset = 0;
+        for (size_t i = 0; i < 2 * BENCHMARK_EDITS && same; i++) {
+            size_t size = dil_string_size(&source.contents);
+            if (i < BENCHMARK_EDITS) {
+                offset = benchmark_random(&state) % size;
+            } else {
+                offset = (offset + benchmark_random(&state) % 256) % size;
+            }
+            while (offset < size &&
+                   (source.contents.first[offset] < 'A' ||
+                    source.contents.first[offset] > 'Z')) {
+                offset++;
+            }
+            DilSourceEdit edit = {
+                .offset   = offset + 1,
+                .inserted = {.first = "x", .last = "x" + 1}};
+            bool checked = (i + 1) % BENCHMARK_EDITS == 0;
+            same         = offset < size &&
+                   benchmark_apply(
+                       &document,
+                       &buffer,
+                       &source,
+                       &edit,
+                       i < BENCHMARK_EDITS ? timings : near,
+                       checked);
+        }
+        printf(
+            "%-12llu %12.3f %12.3f %12.3f\n",
+            dil_buffer_size(&buffer),
+            timings[0] * 1e3 / BENCHMARK_EDITS,
+            near[0] * 1e3 / BENCHMARK_EDITS,
+            timings[1] * 1e3 / BENCHMARK_EDITS);
+
+        same = same &&
+               benchmark_edit_random(&document, &buffer, &source, &state);
+        dil_parse_document_free(&document);
+        dil_buffer_free(&buffer);
+    }
+    printf("\n");
+    return same;
+}
+
+/* Locate the start of every node in parsed rules of growing sizes, one by
+ * one with dil_source_locate and in a single sweep with
+ * dil_source_locate_all, with the line index and without it. Returns whether
+ * the locations were the same. */
+bool benchmark_locate(void)
+{
+    bool same = true;
+    printf("Locate, every node:\n");
+    printf(
+        "%-12s %12s %12s %12s\n",
+        "Nodes",
+        "Each ms",
+        "Sweep ms",
+        "Walk ms");
+    for (size_t times = 1000; times <= 4000 && same; times *= 2) {
+        DilBuffer buffer = {0};
+        benchmark_rules(&buffer, times);
+        DilSource source = benchmark_source(&buffer, "locate");
+        DilTree   tree =
+            dil_parse_with(source, (DilParseOptions){.quiet = true});
+        size_t             nodes     = dil_tree_size(&tree);
+        char const**       positions = malloc(nodes * sizeof(char const*));
+        DilSourceLocation* locations[3];
+        for (size_t i = 0; i < 3; i++) {
+            locations[i] = malloc(nodes * sizeof(DilSourceLocation));
+        }
+        for (size_t i = 0; i < nodes; i++) {
+            positions[i] = dil_tree_at(&tree, i)->object.value.first;
+        }
+
+        // Without the index the sweep walks the contents once.
+        double start = benchmark_now();
+        dil_source_locate_all(&source, positions, nodes, locations[2]);
+        double walk = benchmark_now() - start;
+        dil_source_index(&source);
+        start = benchmark_now();
+        for (size_t i = 0; i < nodes; i++) {
+            locations[0][i] = dil_source_locate(&source, positions[i]);
+        }
+        double each = benchmark_now() - start;
+        start       = benchmark_now();
+        dil_source_locate_all(&source, positions, nodes, locations[1]);
+        double sweep = benchmark_now() - start;
+        printf(
+            "%-12llu %12.3f %12.3f %12.3f\n",
+            nodes,
+            each * 1e3,
+            sweep * 1e3,
+            walk * 1e3);
+
+        for (size_t i = 0; i < nodes && same; i++) {
+            for (size_t j = 1; j < 3; j++) {
+                DilSourceLocation const* lhs = &locations[0][i];
+                DilSourceLocation const* rhs = &locations[j][i];
+                if (lhs->position != rhs->position || lhs->line != rhs->line ||
+                    lhs->column != rhs->column) {
+                    printf(
+                        "locate: error: Node %llu is at %llu:%llu instead of "
+                        "%llu:%llu!\n",
+                        i,
+                        rhs->line,
+                        rhs->column,
+                        lhs->line,
+                        lhs->column);
+                    same = false;
+                    break;
+                }
+            }
+        }
+
+        for (size_t i = 0; i < 3; i++) {
+            free(locations[i]);
+        }
+        free(positions);
+        dil_indices_free(&source.lines);
+        dil_tree_free(&tree);
+        dil_buffer_free(&buffer);
+    }
+    printf("\n");
+    return same;
+}
+
+/* Push the text to the parser in chunks of the amount of characters, and
+ * parse the pushed contents at once. Returns whether the trees and the error
+ * counts were the same. */
+bool benchmark_push_chunks(char const* text, size_t split)
+{
+    DilBuffer    buffer = {0};
+    DilParsePush push   = {0};
+    dil_parse_begin(&push, &buffer, "push", (DilParseOptions){.quiet = true});
+    char const* last = text + strlen(text);
+    for (char const* i = text; i < last; i += split) {
+        DilString chunk = {.first = i, .last = i + split};
+        if (chunk.last > last) {
+            chunk.last = last;
+        }
+        dil_parse_feed(&push, &chunk);
+    }
+    DilTree pushed = dil_parse_end(&push);
+
+    DilParseStatistics statistics = {0};
+    DilSource          whole      = {
+        .path     = push.context.source.path,
+        .contents = push.context.source.contents};
+    DilTree parsed = dil_parse_with(
+        whole,
+        (DilParseOptions){.statistics = &statistics, .quiet = true});
+    bool same = benchmark_compare(&push.context.source, &parsed, &pushed);
+    if (same && statistics.errors != push.context.source.error) {
+        printf(
+            "push: error: Found %llu errors instead of %llu!\n",
+            push.context.source.error,
+            statistics.errors);
+        same = false;
+    }
+    dil_tree_free(&parsed);
+    dil_tree_free(&pushed);
+    dil_buffer_free(&buffer);
+    return same;
+}
+
+/* Push erroneous source files to the parser in chunks of every size, so the
+ * chunks end at every character, and compare the trees to parsing them at
+ * once. Returns whether the trees were the same. */
+bool benchmark_push(void)
+{
+    static char const* const TEXTS[] = {
+        "A = B;\nC = D;\n!!!\n",
+        "A = (B;\nC = D;\n",
+        "A = )    ;\nB = 'x';\n",
+        "A = 'x'\nB = 'y';\nC = D;\n",
+        "start A;\nA = \"x;\n\" | B;\nB = ;\nC = 'y';\n",
+        "// A;\nA = 'x;\n' B;\nstart = ;\nB = C",
+        "A = B;\nstart\n;\nskip ;\n;\nC = 'x' | ;\n"};
+    size_t const amount = sizeof(TEXTS) / sizeof(TEXTS[0]);
+    bool         same   = true;
+    printf("Push, chunks of every size:\n");
+    printf("%-12s %12s\n", "Text", "Bytes");
+    for (size_t i = 0; i < amount && same; i++) {
+        size_t size = strlen(TEXTS[i]);
+        for (size_t split = 1; split <= size && same; split++) {
+            same = benchmark_push_chunks(TEXTS[i], split);
+        }
+        printf("%-12llu %12llu\n", i, size);
+    }
+    printf("\n");
+    return same;
+}
+
+/* Parse rules with the parallel parser on more and more threads, and
+ * sequentially with dil_parse_with. The rules are parsed once as they are,
+ * and once with an error at the end, where the parallel parser parses the
+ * whole source file again. Returns whether the trees were the same. */
+bool benchmark_parallel(void)
+{
+    DilBuffer inputs[2] = {0};
+    benchmark_rules(&inputs[0], BENCHMARK_PARALLEL_TIMES);
+    benchmark_rules(&inputs[1], BENCHMARK_PARALLEL_TIMES);
+    benchmark_append(&inputs[1], "Broken = ;\n");
+    DilSource sources[2] = {
+        benchmark_source(&inputs[0], "parallel"),
+        benchmark_source(&inputs[1], "parallel")};
+    DilParseOptions options = {.quiet = true};
+    double          bytes   = (double)dil_buffer_size(&inputs[0]);
+    size_t          nodes   = 0;
+    bool            same    = true;
+
+    printf("Parallel, %.0f bytes:\n", bytes);
+    printf(
+        "%-12s %10s %10s %10s\n",
+        "Threads",
+        "MB/s",
+        "Speedup",
+        "Error MB/s");
+    double sequential =
+        benchmark_time(&dil_parse_with, sources[0], options, &nodes);
+    double broken =
+        benchmark_time(&dil_parse_with, sources[1], options, &nodes);
+    printf(
+        "%-12s %10.1f %10.2f %10.1f\n",
+        "sequential",
+        bytes / sequential / 1e6,
+        1.0,
+        bytes / broken / 1e6);
+
+    for (benchmark_threads = 1;
+         benchmark_threads <= BENCHMARK_PARALLEL_THREADS && same;
+         benchmark_threads *= 2) {
+        double clean = benchmark_time(
+            &benchmark_parallel_parse,
+            sources[0],
+            options,
+            &nodes);
+        broken = benchmark_time(
+            &benchmark_parallel_parse,
+            sources[1],
+            options,
+            &nodes);
+        printf(
+            "%-12llu %10.1f %10.2f %10.1f\n",
+            benchmark_threads,
+            bytes / clean / 1e6,
+            sequential / clean,
+            bytes / broken / 1e6);
+
+        for (size_t i = 0; i < 2 && same; i++) {
+            DilTree expected = dil_parse_with(sources[i], options);
+            DilTree actual   = benchmark_parallel_parse(sources[i], options);
+            same = benchmark_compare(&sources[i], &expected, &actual);
+            dil_tree_free(&expected);
+            dil_tree_free(&actual);
+        }
+    }
+    printf("\n");
+    dil_buffer_free(&inputs[0]);
+    dil_buffer_free(&inputs[1]);
+    return same;
+}
+
+/* Measure the features at the arguments. */
+int main(int argumentCount, char const* const* arguments)
+{
+    if (argumentCount < 2) {
+        printf("Usage: <memo|skip|iterative|edit|locate|push|parallel>...\n");
+        return EXIT_FAILURE;
+    }
+
+    bool same = true;
+    for (int i = 1; i < argumentCount; i++) {
+        if (strcmp(arguments[i], "memo") == 0) {
+            same = benchmark_memo() && benchmark_memo_nested() &&
+                   benchmark_memo_errors() && same;
+        } else if (strcmp(arguments[i], "skip") == 0) {
+            same = benchmark_skip() && same;
+        } else if (strcmp(arguments[i], "iterative") == 0) {
+            same = benchmark_iterative() && same;
+        } else if (strcmp(arguments[i], "edit") == 0) {
+            same = benchmark_edit() && same;
+        } else if (strcmp(arguments[i], "locate") == 0) {
+            same = benchmark_locate() && same;
+        } else if (strcmp(arguments[i], "push") == 0) {
+            same = benchmark_push() && same;
+        } else if (strcmp(arguments[i], "parallel") == 0) {
+            same = benchmark_parallel() && same;
+        } else {
+            printf("Unknown benchmark %s!\n", arguments[i]);
+            same = false;
+        }
+    }
+    return same ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,621 @@
+// SPDX-FileCopyrightText: 2022 Cem Geçgel <gecgelcem@outlook.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Compares the parsers generated from `res/dil.dil` with the hand written one
+// in `dil/parser.c`. The build generates `exact.c`, which keeps every node and
+// also calls callbacks instead of building the tree, and `collapsed.c`, which
+// collapses the rules that pass through. The grammar can also be compiled at
+// runtime and run by the machine in `dil/machine.c`. Grammars that parsers
+// cannot finish must be rejected instead. The parsers are also compared on
+// erroneous contents, which are the source file with a character removed or
+// replaced, so that they recover from the errors the same way.
+
+#include "collapsed.c"
+#include "dil/buffer.c"
+#include "dil/generator.c"
+#include "dil/indices.c"
+#include "dil/machine.c"
+#include "dil/parser.c"
+#include "dil/program.c"
+#include "dil/source.c"
+#include "dil/string.c"
+#include "dil/tree.c"
+#include "exact.c"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Amount of times each parser parses a source file, of which the fastest is
+ * measured. */
+#define BOOTSTRAP_ROUNDS 5
+
+/* Characters that are put in place of each character of a source file to get
+ * erroneous contents, after the character is removed first. */
+#define BOOTSTRAP_MUTATIONS ";|()'\"=?"
+
+/* Function that parses a source file into a tree. */
+typedef DilTree (*BootstrapParse)(DilSource source, DilParseOptions options);
+
+/* Measurements of a parser on a source file. */
+typedef struct {
+    /* Name of the parser in the report. */
+    char const* name;
+    /* Function that parses. */
+    BootstrapParse parse;
+    /* Seconds the fastest parse took. */
+    double seconds;
+    /* Amount of nodes in the tree. */
+    size_t nodes;
+    /* Bytes the parsing process held at its peak. */
+    size_t peak;
+} BootstrapRun;
+
+/* Consumer of the events of a parse, which counts the rules like a tool that
+ * only needs a single pass would. */
+typedef struct {
+    /* Kind, symbol and offsets of each event to compare, or null. */
+    DilIndices* recorded;
+    /* Start of the source file contents, which the offsets are from. */
+    char const* contents;
+    /* Amount of rules that were left. */
+    size_t rules;
+} BootstrapConsumer;
+
+/* Kinds of the recorded events. */
+typedef enum {
+    BOOTSTRAP_ENTER,
+    BOOTSTRAP_LEAVE,
+    BOOTSTRAP_TOKEN
+} BootstrapEvent;
+
+/* Grammars with a left recursive rule, a repetition of a pattern that can
+ * match nothing, and a start pattern that repeats a rule that can match
+ * nothing. Parsers would not finish on any of them. */
+char const* const BOOTSTRAP_UNENDING[] = {
+    "start *Expr; Expr = Expr '+' Num | Num; Num = '0~9';",
+    "start *Foo; Foo = *?'a' 'b';",
+    "start *Foo; Foo = ?'a';"};
+
+/* Program the machine runs, which is compiled from the grammar given with
+ * `--grammar`, or null. */
+DilProgram const* bootstrap_program = NULL;
+
+/* Current time in seconds. */
+double bootstrap_now(void)
+{
+    struct timespec now;
+    (void)timespec_get(&now, TIME_UTC);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+/* Parse the source file by running the program with the machine. */
+DilTree bootstrap_machine(DilSource source, DilParseOptions options)
+{
+    return dil_machine_parse_with(bootstrap_program, source, options);
+}
+
+/* Amount of levels in the tree. */
+size_t bootstrap_depth(DilTree const* tree)
+{
+    DilIndices childeren = {0};
+    size_t     depth     = 0;
+    for (size_t i = 0; i < dil_tree_size(tree); i++) {
+        DilNode const* node = dil_tree_at(tree, i);
+        if (dil_indices_finite(&childeren)) {
+            (*dil_indices_finish(&childeren))--;
+        }
+        if (node->childeren > 0) {
+            dil_indices_add(&childeren, node->childeren);
+        }
+        if (dil_indices_size(&childeren) + 1 > depth) {
+            depth = dil_indices_size(&childeren) + 1;
+        }
+        while (dil_indices_finite(&childeren) &&
+               *dil_indices_finish(&childeren) == 0) {
+            dil_indices_remove(&childeren);
+        }
+    }
+    dil_indices_free(&childeren);
+    return depth;
+}
+
+/* Record the event if the consumer records them. */
+void bootstrap_record(
+    BootstrapConsumer* consumer,
+    BootstrapEvent     kind,
+    DilSymbol          symbol,
+    char const*        first,
+    char const*        last)
+{
+    if (consumer->recorded == NULL) {
+        return;
+    }
+    dil_indices_add(consumer->recorded, kind);
+    dil_indices_add(consumer->recorded, symbol);
+    dil_indices_add(consumer->recorded, first - consumer->contents);
+    dil_indices_add(consumer->recorded, last - consumer->contents);
+}
+
+/* Consume a rule that was entered. */
+void bootstrap_enter(void* data, DilSymbol symbol, char const* position)
+{
+    bootstrap_record(data, BOOTSTRAP_ENTER, symbol, position, position);
+}
+
+/* Consume a rule that was left. */
+void bootstrap_leave(void* data, DilSymbol symbol, DilString range)
+{
+    BootstrapConsumer* consumer = data;
+    consumer->rules++;
+    bootstrap_record(
+        consumer,
+        BOOTSTRAP_LEAVE,
+        symbol,
+        range.first,
+        range.last);
+}
+
+/* Consume a terminal. */
+void bootstrap_token(void* data, DilSymbol symbol, DilString range)
+{
+    bootstrap_record(data, BOOTSTRAP_TOKEN, symbol, range.first, range.last);
+}
+
+/* Call the callbacks in the order of the tree, which is what consuming it
+ * after building it takes. */
+void bootstrap_walk(DilTree const* tree, DilParseEvents const* events)
+{
+    DilIndices parents   = {0};
+    DilIndices childeren = {0};
+    for (size_t i = 0; i < dil_tree_size(tree); i++) {
+        DilNode const* node = dil_tree_at(tree, i);
+        if (dil_indices_finite(&childeren)) {
+            (*dil_indices_finish(&childeren))--;
+        }
+        DilObject const* object = &node->object;
+        if (object->symbol == DIL_SYMBOL__CHARACTER ||
+            object->symbol == DIL_SYMBOL__STRING) {
+            events->token(events->data, object->symbol, object->value);
+        } else {
+            events->enter(events->data, object->symbol, object->value.first);
+            dil_indices_add(&parents, i);
+            dil_indices_add(&childeren, node->childeren);
+        }
+        while (dil_indices_finite(&childeren) &&
+               *dil_indices_finish(&childeren) == 0) {
+            object = &dil_tree_at(tree, dil_indices_pop(&parents))->object;
+            events->leave(events->data, object->symbol, object->value);
+            dil_indices_remove(&childeren);
+        }
+    }
+    dil_indices_free(&parents);
+    dil_indices_free(&childeren);
+}
+
+/* Bytes a quiet parsing process held at its peak, which are the tree and the
+ * stack of the parents that were open; the other buffers are not used. */
+size_t bootstrap_peak(DilTree const* tree)
+{
+    return dil_tree_capacity(tree) * sizeof(DilNode) +
+           bootstrap_depth(tree) * sizeof(size_t);
+}
+
+/* Whether the trees are the same. Prints the first difference otherwise. */
+bool bootstrap_compare(
+    DilSource const* source,
+    DilTree const*   expected,
+    DilTree const*   actual)
+{
+    size_t size = dil_tree_size(expected);
+    if (dil_tree_size(actual) < size) {
+        size = dil_tree_size(actual);
+    }
+    for (size_t i = 0; i < size; i++) {
+        DilNode const* lhs = dil_tree_at(expected, i);
+        DilNode const* rhs = dil_tree_at(actual, i);
+        if (lhs->object.symbol == rhs->object.symbol &&
+            lhs->childeren == rhs->childeren &&
+            lhs->object.value.first == rhs->object.value.first &&
+            lhs->object.value.last == rhs->object.value.last) {
+            continue;
+        }
+        printf(
+            "%s: error: Node %llu is %d at %llu with %llu childeren instead "
+            "of %d at %llu with %llu childeren!\n",
+            source->path,
+            i,
+            rhs->object.symbol,
+            rhs->object.value.first - source->contents.first,
+            rhs->childeren,
+            lhs->object.symbol,
+            lhs->object.value.first - source->contents.first,
+            lhs->childeren);
+        return false;
+    }
+    if (dil_tree_size(expected) != dil_tree_size(actual)) {
+        printf(
+            "%s: error: Tree has %llu nodes instead of %llu!\n",
+            source->path,
+            dil_tree_size(actual),
+            dil_tree_size(expected));
+        return false;
+    }
+    return true;
+}
+
+/* Whether the parser builds the same tree and finds the same errors as the
+ * hand written one in both the full and the compact modes. */
+bool bootstrap_check(DilSource const* source, BootstrapParse parse)
+{
+    bool same = true;
+    for (int compact = 0; compact < 2 && same; compact++) {
+        DilParseStatistics expected = {0};
+        DilParseStatistics actual   = {0};
+        DilTree            hand     = dil_parse_with(
+            *source,
+            (DilParseOptions){
+                           .statistics = &expected,
+                           .compact    = compact,
+                           .quiet      = true});
+        DilTree generated = parse(
+            *source,
+            (DilParseOptions){
+                .statistics = &actual,
+                .compact    = compact,
+                .quiet      = true});
+
+        same = bootstrap_compare(source, &hand, &generated);
+        if (same && expected.errors != actual.errors) {
+            printf(
+                "%s: error: Found %llu errors instead of %llu!\n",
+                source->path,
+                actual.errors,
+                expected.errors);
+            same = false;
+        }
+        dil_tree_free(&hand);
+        dil_tree_free(&generated);
+    }
+    return same;
+}
+
+/* Whether calling the callbacks instead of building the tree gives the same
+ * events as walking the tree in both the full and the compact modes. */
+bool bootstrap_events(DilSource const* source)
+{
+    bool same = true;
+    for (int compact = 0; compact < 2 && same; compact++) {
+        DilIndices        walked   = {0};
+        DilIndices        called   = {0};
+        char const*       first    = source->contents.first;
+        BootstrapConsumer expected = {.recorded = &walked, .contents = first};
+        BootstrapConsumer actual   = {.recorded = &called, .contents = first};
+        DilParseOptions   options  = {.compact = compact, .quiet = true};
+        DilTree           tree     = exact_parse_with(*source, options);
+
+        DilParseEvents callbacks = {
+            .data  = &expected,
+            .enter = &bootstrap_enter,
+            .leave = &bootstrap_leave,
+            .token = &bootstrap_token};
+        bootstrap_walk(&tree, &callbacks);
+        callbacks.data = &actual;
+        exact_parse_events(*source, options, &callbacks);
+
+        size_t size = dil_indices_size(&walked);
+
+        same = size == dil_indices_size(&called) &&
+               memcmp(walked.first, called.first, size * sizeof(size_t)) == 0;
+        if (!same) {
+            printf(
+                "%s: error: Called %llu events instead of %llu!\n",
+                source->path,
+                dil_indices_size(&called) / 4,
+                size / 4);
+        }
+        dil_tree_free(&tree);
+        dil_indices_free(&walked);
+        dil_indices_free(&called);
+    }
+    return same;
+}
+
+/* Whether the parsers agree with the hand written one on the contents that
+ * are left after removing or replacing each character of the source file,
+ * which are mostly erroneous. Prints the first mutation that differs. */
+bool bootstrap_mutate(DilSource const* source)
+{
+    static char const MUTATIONS[] = BOOTSTRAP_MUTATIONS;
+
+    size_t    size    = dil_string_size(&source->contents);
+    DilBuffer mutated = {0};
+    dil_buffer_reserve(&mutated, size);
+    bool   same    = true;
+    size_t checked = 0;
+    for (size_t i = 0; i < size && same; i++) {
+        for (size_t j = 0; j < sizeof(MUTATIONS) && same; j++) {
+            // The terminating null stands for removing the character.
+            char const* first = source->contents.first;
+            mutated.last      = mutated.first;
+            memcpy(mutated.last, first, i);
+            mutated.last += i;
+            if (MUTATIONS[j] != 0) {
+                *mutated.last++ = MUTATIONS[j];
+            }
+            memcpy(mutated.last, first + i + 1, size - i - 1);
+            mutated.last += size - i - 1;
+
+            DilSource erroneous = {
+                .path     = source->path,
+                .contents = {.first = mutated.first, .last = mutated.last}};
+            same = bootstrap_check(&erroneous, &exact_parse_with) &&
+                   bootstrap_events(&erroneous) &&
+                   (bootstrap_program == NULL ||
+                    bootstrap_check(&erroneous, &bootstrap_machine));
+            if (!same) {
+                printf(
+                    "%s: error: Differs after %s the character at %llu!\n",
+                    source->path,
+                    MUTATIONS[j] == 0 ? "removing" : "replacing",
+                    i);
+            }
+            checked++;
+        }
+    }
+    printf(
+        "%s: %llu mutations, %s.\n\n",
+        source->path,
+        checked,
+        same ? "trees and events are the same" : "trees or events differ");
+    dil_buffer_free(&mutated);
+    return same;
+}
+
+/* Parse the source file with the parser a few times, and measure it. */
+void bootstrap_measure(BootstrapRun* run, DilSource const* source)
+{
+    run->seconds = 0;
+    for (int i = 0; i < BOOTSTRAP_ROUNDS; i++) {
+        double  start   = bootstrap_now();
+        DilTree tree    = run->parse(*source, (DilParseOptions){.quiet = true});
+        double  seconds = bootstrap_now() - start;
+        if (i == 0 || seconds < run->seconds) {
+            run->seconds = seconds;
+        }
+        run->nodes = dil_tree_size(&tree);
+        run->peak  = bootstrap_peak(&tree);
+        dil_tree_free(&tree);
+    }
+}
+
+/* Consume the source file a few times, by walking the tree after building it
+ * or by calling the callbacks instead, and measure it. The nodes of the run
+ * are the rules the consumer found. */
+void bootstrap_consume(BootstrapRun* run, DilSource const* source, bool walk)
+{
+    DilParseOptions options = {.quiet = true};
+    run->seconds            = 0;
+    for (int i = 0; i < BOOTSTRAP_ROUNDS; i++) {
+        BootstrapConsumer consumer  = {.contents = source->contents.first};
+        DilParseEvents    callbacks = {
+            .data  = &consumer,
+            .enter = &bootstrap_enter,
+            .leave = &bootstrap_leave,
+            .token = &bootstrap_token};
+        DilTree tree  = {0};
+        double  start = bootstrap_now();
+        if (walk) {
+            tree = exact_parse_with(*source, options);
+            bootstrap_walk(&tree, &callbacks);
+        } else {
+            exact_parse_events(*source, options, &callbacks);
+        }
+        double seconds = bootstrap_now() - start;
+        if (i == 0 || seconds < run->seconds) {
+            run->seconds = seconds;
+        }
+        run->nodes = consumer.rules;
+        dil_tree_free(&tree);
+    }
+
+    // The walk holds the tree and its own two stacks of the parents, while the
+    // callbacks only need the stack of the open objects.
+    DilTree tree  = exact_parse_with(*source, options);
+    size_t  depth = bootstrap_depth(&tree);
+    run->peak     = walk ? dil_tree_capacity(&tree) * sizeof(DilNode) +
+                           2 * depth * sizeof(size_t)
+                         : depth * sizeof(DilNode);
+    dil_tree_free(&tree);
+}
+
+/* Print the measurements of the amount of runs side by side, with the titles
+ * of the columns of the names and the nodes. */
+void bootstrap_print(
+    BootstrapRun const* runs,
+    size_t              amount,
+    size_t              bytes,
+    char const*         names,
+    char const*         nodes)
+{
+    printf("%-12s %10s %10s %12s\n", names, "MB/s", nodes, "Peak bytes");
+    for (size_t i = 0; i < amount; i++) {
+        printf(
+            "%-12s %10.1f %10llu %12llu\n",
+            runs[i].name,
+            runs[i].seconds > 0 ? (double)bytes / runs[i].seconds / 1e6 : 0,
+            runs[i].nodes,
+            runs[i].peak);
+    }
+    printf("\n");
+}
+
+/* Check the exact generated parser and the machine against the hand written
+ * one on the source file at the path, whose contents are repeated the amount
+ * of times, and print the measurements of the parsers and the consumers side
+ * by side. Returns whether the trees and the events were the same. */
+bool bootstrap_file(char const* path, size_t times)
+{
+    DilBuffer file     = {0};
+    DilBuffer repeated = {0};
+    DilSource loaded   = dil_source_load(&file, path);
+    if (loaded.error != 0) {
+        dil_buffer_free(&file);
+        return false;
+    }
+
+    size_t size = dil_string_size(&loaded.contents);
+    dil_buffer_reserve(&repeated, size * times);
+    for (size_t i = 0; i < times; i++) {
+        memcpy(repeated.last, loaded.contents.first, size);
+        repeated.last += size;
+    }
+    DilSource source = {
+        .path     = path,
+        .contents = {.first = repeated.first, .last = repeated.last}};
+    size_t    bytes  = dil_string_size(&source.contents);
+
+    bool same = bootstrap_check(&source, &exact_parse_with) &&
+                bootstrap_events(&source) &&
+                (bootstrap_program == NULL ||
+                 bootstrap_check(&source, &bootstrap_machine));
+    printf(
+        "%s, %llu times: %llu bytes, %s.\n",
+        path,
+        times,
+        bytes,
+        same ? "trees and events are the same" : "trees or events differ");
+    same = bootstrap_mutate(&loaded) && same;
+
+    BootstrapRun parsers[] = {
+        {.name = "hand",      .parse = &dil_parse_with      },
+        {.name = "exact",     .parse = &exact_parse_with    },
+        {.name = "collapsed", .parse = &collapsed_parse_with},
+        {.name = "machine",   .parse = &bootstrap_machine   }
+    };
+    size_t       amount    = sizeof(parsers) / sizeof(parsers[0]);
+    if (bootstrap_program == NULL) {
+        amount--;
+    }
+    for (size_t i = 0; i < amount; i++) {
+        bootstrap_measure(parsers + i, &source);
+    }
+    bootstrap_print(parsers, amount, bytes, "Parser", "Nodes");
+
+    BootstrapRun consumers[] = {
+        {.name = "tree + walk"},
+        {.name = "events"     }
+    };
+    bootstrap_consume(consumers + 0, &source, true);
+    bootstrap_consume(consumers + 1, &source, false);
+    bootstrap_print(consumers, 2, bytes, "Consumer", "Rules");
+
+    dil_buffer_free(&repeated);
+    dil_buffer_free(&file);
+    return same;
+}
+
+/* Whether no parser is generated and no program is compiled for any of the
+ * grammars that parsers would not finish on. Prints the ones that are
+ * accepted. */
+bool bootstrap_unending(void)
+{
+    size_t amount   = sizeof(BOOTSTRAP_UNENDING) / sizeof(*BOOTSTRAP_UNENDING);
+    bool   rejected = true;
+    for (size_t i = 0; i < amount; i++) {
+        DilSource source = {
+            .path     = "unending",
+            .contents = dil_string_terminated(BOOTSTRAP_UNENDING[i])};
+        DilTree   tree      = dil_parse(source);
+        DilBuffer generated = {0};
+        if (dil_generate(&generated, &tree)) {
+            printf(
+                "error: Generated a parser for `%s`!\n",
+                BOOTSTRAP_UNENDING[i]);
+            rejected = false;
+        }
+        DilProgram program = {0};
+        if (dil_program_compile(&program, &tree)) {
+            printf(
+                "error: Compiled a program for `%s`!\n",
+                BOOTSTRAP_UNENDING[i]);
+            rejected = false;
+        }
+        dil_program_free(&program);
+        dil_buffer_free(&generated);
+        dil_tree_free(&tree);
+    }
+    printf(
+        "Unending grammars: %s.\n\n",
+        rejected ? "all are rejected" : "some are accepted");
+    return rejected;
+}
+
+/* Compile the grammar file at the path into the program, and print how long
+ * loading it took. Returns whether it could be compiled. */
+bool bootstrap_compile(DilProgram* program, char const* path)
+{
+    DilBuffer buffer  = {0};
+    double    start   = bootstrap_now();
+    DilSource source  = dil_source_load(&buffer, path);
+    DilTree   tree    = dil_parse(source);
+    bool      read    = source.error == 0;
+    bool      success = read && dil_program_compile(program, &tree);
+    double    seconds = bootstrap_now() - start;
+    if (success) {
+        printf(
+            "%s: %llu instructions, %llu bytes, loaded in %.3f ms.\n",
+            path,
+            dil_instructions_size(&program->code),
+            dil_program_bytes(program),
+            seconds * 1e3);
+    }
+    dil_tree_free(&tree);
+    dil_buffer_free(&buffer);
+    return success;
+}
+
+/* Compare the parsers on the source files at the arguments, which are
+ * repeated the amount of times given with `--repeat`. The machine runs the
+ * grammar given with `--grammar`. */
+int main(int argumentCount, char const* const* arguments)
+{
+    size_t      times   = 1;
+    char const* grammar = NULL;
+    int         first   = 1;
+    if (argumentCount > first + 1 &&
+        strcmp(arguments[first], "--repeat") == 0) {
+        times = strtoull(arguments[first + 1], NULL, 10);
+        first += 2;
+    }
+    if (argumentCount > first + 1 &&
+        strcmp(arguments[first], "--grammar") == 0) {
+        grammar = arguments[first + 1];
+        first += 2;
+    }
+    if (first == argumentCount || times == 0) {
+        printf(
+            "Usage: [--repeat <times>] [--grammar <grammar>] <source>...\n");
+        return EXIT_FAILURE;
+    }
+
+    DilProgram program = {0};
+    if (grammar != NULL) {
+        if (!bootstrap_compile(&program, grammar)) {
+            printf("%s: error: Could not compile the grammar!\n", grammar);
+            dil_program_free(&program);
+            return EXIT_FAILURE;
+        }
+        bootstrap_program = &program;
+    }
+
+    bool same = bootstrap_unending();
+    for (int i = first; i < argumentCount; i++) {
+        same = bootstrap_file(arguments[i], times) && same;
+    }
+    dil_program_free(&program);
+    return same ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,724 @@
+// SPDX-FileCopyrightText: 2022 Cem Geçgel <gecgelcem@outlook.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "dil/class.c"
+#include "dil/expressions.c"
+#include "dil/grammar.c"
+#include "dil/indices.c"
+#include "dil/lookaheads.c"
+#include "dil/rules.c"
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/* Characters around each expression of a grammar, which are found by
+ * repeating the passes over the rules until none of the sets grow. */
+typedef struct {
+    /* Analyzed grammar. */
+    DilGrammar const* grammar;
+    /* Lookahead of each expression. */
+    DilLookaheads expressions;
+    /* Whether anything grew in the current pass. */
+    bool changed;
+} DilAnalysis;
+
+/* Pointer to the lookahead of the expression at the index. */
+DilLookahead* dil_analysis_at(DilAnalysis const* analysis, size_t index)
+{
+    return dil_lookaheads_at(&analysis->expressions, index);
+}
+
+/* Characters the generated parser can enter the expression at without it
+ * failing, which are all of them if it can be accepted without consuming
+ * any. The end of the contents is only viable in the latter case. */
+DilCharClass dil_analysis_viable(DilAnalysis const* analysis, size_t index)
+{
+    DilLookahead const* lookahead = dil_analysis_at(analysis, index);
+    DilCharClass        viable    = lookahead->first;
+    if (lookahead->vacuous) {
+        viable = (DilCharClass){0};
+        dil_char_class_invert(&viable);
+    }
+    return viable;
+}
+
+/* Add the other class to the class. */
+void dil_analysis__unite(
+    DilAnalysis*        analysis,
+    DilCharClass*       set,
+    DilCharClass const* other)
+{
+    for (size_t i = 0; i < 4; i++) {
+        uint64_t united = set->bits[i] | other->bits[i];
+        if (united != set->bits[i]) {
+            set->bits[i]      = united;
+            analysis->changed = true;
+        }
+    }
+}
+
+/* Set the flag if the value is set. */
+void dil_analysis__mark(DilAnalysis* analysis, bool* flag, bool value)
+{
+    if (value && !*flag) {
+        *flag             = true;
+        analysis->changed = true;
+    }
+}
+
+/* Add what can come after the source to what can come after the target. */
+void dil_analysis__inherit(
+    DilAnalysis*        analysis,
+    DilLookahead*       target,
+    DilLookahead const* source)
+{
+    dil_analysis__unite(analysis, &target->follow, &source->follow);
+    dil_analysis__mark(analysis, &target->ends, source->ends);
+}
+
+/* First characters of the skip between the elements of the rule, or null if
+ * it does not skip. */
+DilCharClass const*
+dil_analysis__skip(DilAnalysis const* analysis, DilRule const* rule)
+{
+    if (!rule->skipped) {
+        return NULL;
+    }
+    return &dil_analysis_at(
+                analysis,
+                dil_indices_get(&analysis->grammar->skips, rule->skip))
+                ->first;
+}
+
+/* Grow the first characters and the nullability of the expression from its
+ * childeren. */
+void dil_analysis__first(
+    DilAnalysis*        analysis,
+    size_t              index,
+    DilCharClass const* skip)
+{
+    DilGrammar const*    grammar    = analysis->grammar;
+    DilExpression const* expression = dil_grammar_at(grammar, index);
+    for (size_t i = 0; i < expression->amount; i++) {
+        dil_analysis__first(
+            analysis,
+            dil_grammar_child(grammar, expression, i),
+            skip);
+    }
+
+    DilLookahead*       lookahead = dil_analysis_at(analysis, index);
+    DilLookahead const* child     = NULL;
+    if (expression->amount != 0) {
+        child = dil_analysis_at(
+            analysis,
+            dil_grammar_child(grammar, expression, 0));
+    }
+    switch (expression->kind) {
+        case DIL_EXPRESSION_CHARACTER:
+        case DIL_EXPRESSION_SET:
+            dil_analysis__unite(analysis, &lookahead->first, &expression->set);
+            break;
+        case DIL_EXPRESSION_NOT_SET: {
+            DilCharClass set = expression->set;
+            dil_char_class_invert(&set);
+            dil_analysis__unite(analysis, &lookahead->first, &set);
+            break;
+        }
+        case DIL_EXPRESSION_STRING:
+            if (expression->length == 0) {
+                dil_analysis__mark(analysis, &lookahead->nullable, true);
+                dil_analysis__mark(analysis, &lookahead->vacuous, true);
+            } else {
+                DilCharClass set = {0};
+                dil_char_class_add(
+                    &set,
+                    dil_buffer_get(&grammar->texts, expression->text));
+                dil_analysis__unite(analysis, &lookahead->first, &set);
+            }
+            break;
+        case DIL_EXPRESSION_REFERENCE: {
+            DilLookahead const* rule = dil_analysis_at(
+                analysis,
+                dil_rules_at(&grammar->rules, expression->rule)->pattern);
+            dil_analysis__unite(analysis, &lookahead->first, &rule->first);
+            dil_analysis__mark(analysis, &lookahead->nullable, rule->nullable);
+            dil_analysis__mark(analysis, &lookahead->vacuous, rule->vacuous);
+            break;
+        }
+        case DIL_EXPRESSION_SEQUENCE: {
+            // Elements are reached while the ones before them are nullable.
+            // The generated parser decides the sequence on the first
+            // characters of the elements until one that can reject it.
+            bool nullable = true;
+            bool vacuous  = true;
+            for (size_t i = 0; i < expression->amount; i++) {
+                vacuous = vacuous &&
+                          dil_analysis_at(
+                              analysis,
+                              dil_grammar_child(grammar, expression, i))
+                              ->vacuous;
+            }
+            for (size_t i = 0; i < expression->amount && nullable; i++) {
+                DilLookahead const* element = dil_analysis_at(
+                    analysis,
+                    dil_grammar_child(grammar, expression, i));
+                if (i != 0 && skip != NULL) {
+                    dil_analysis__unite(analysis, &lookahead->first, skip);
+                }
+                dil_analysis__unite(
+                    analysis,
+                    &lookahead->first,
+                    &element->first);
+                nullable = element->nullable;
+            }
+            dil_analysis__mark(analysis, &lookahead->nullable, nullable);
+            dil_analysis__mark(analysis, &lookahead->vacuous, vacuous);
+            break;
+        }
+        case DIL_EXPRESSION_CHOICE:
+            for (size_t i = 0; i < expression->amount; i++) {
+                DilLookahead const* alternative = dil_analysis_at(
+                    analysis,
+                    dil_grammar_child(grammar, expression, i));
+                dil_analysis__unite(
+                    analysis,
+                    &lookahead->first,
+                    &alternative->first);
+                dil_analysis__mark(
+                    analysis,
+                    &lookahead->nullable,
+                    alternative->nullable);
+                dil_analysis__mark(
+                    analysis,
+                    &lookahead->vacuous,
+                    alternative->vacuous);
+            }
+            break;
+        case DIL_EXPRESSION_OPTIONAL:
+            dil_analysis__unite(analysis, &lookahead->first, &child->first);
+            dil_analysis__mark(analysis, &lookahead->nullable, true);
+            dil_analysis__mark(analysis, &lookahead->vacuous, true);
+            break;
+        case DIL_EXPRESSION_ZERO_OR_MORE:
+            dil_analysis__unite(analysis, &lookahead->first, &child->first);
+            dil_analysis__mark(analysis, &lookahead->nullable, true);
+            dil_analysis__mark(analysis, &lookahead->vacuous, true);
+            if (child->nullable && skip != NULL) {
+                dil_analysis__unite(analysis, &lookahead->first, skip);
+            }
+            break;
+        default:
+            // Repetitions, which skip before the next time if the child can
+            // match nothing.
+            dil_analysis__unite(analysis, &lookahead->first, &child->first);
+            dil_analysis__mark(analysis, &lookahead->nullable, child->nullable);
+            dil_analysis__mark(analysis, &lookahead->vacuous, child->vacuous);
+            if (child->nullable && skip != NULL) {
+                dil_analysis__unite(analysis, &lookahead->first, skip);
+            }
+            break;
+    }
+}
+
+/* Grow what can come after the childeren of the expression from what can
+ * come after it. */
+void dil_analysis__follow(
+    DilAnalysis*        analysis,
+    size_t              index,
+    DilCharClass const* skip)
+{
+    DilGrammar const*    grammar    = analysis->grammar;
+    DilExpression const* expression = dil_grammar_at(grammar, index);
+    DilLookahead const*  lookahead  = dil_analysis_at(analysis, index);
+    for (size_t i = 0; i < expression->amount; i++) {
+        DilLookahead* child = dil_analysis_at(
+            analysis,
+            dil_grammar_child(grammar, expression, i));
+        bool repeated = false;
+        switch (expression->kind) {
+            case DIL_EXPRESSION_SEQUENCE: {
+                // Take the elements after the child while they are nullable.
+                bool open = true;
+                for (size_t j = i + 1; j < expression->amount && open; j++) {
+                    DilLookahead const* next = dil_analysis_at(
+                        analysis,
+                        dil_grammar_child(grammar, expression, j));
+                    if (skip != NULL) {
+                        dil_analysis__unite(analysis, &child->follow, skip);
+                    }
+                    dil_analysis__unite(analysis, &child->follow, &next->first);
+                    open = next->nullable;
+                }
+                if (open) {
+                    dil_analysis__inherit(analysis, child, lookahead);
+                }
+                break;
+            }
+            case DIL_EXPRESSION_ZERO_OR_MORE:
+            case DIL_EXPRESSION_ONE_OR_MORE:
+                repeated = true;
+                break;
+            case DIL_EXPRESSION_FIXED_TIMES:
+                repeated = expression->times > 1;
+                break;
+            default:
+                break;
+        }
+        if (expression->kind != DIL_EXPRESSION_SEQUENCE) {
+            dil_analysis__inherit(analysis, child, lookahead);
+        }
+        if (repeated) {
+            if (skip != NULL) {
+                dil_analysis__unite(analysis, &child->follow, skip);
+            }
+            dil_analysis__unite(analysis, &child->follow, &child->first);
+        }
+        dil_analysis__follow(
+            analysis,
+            dil_grammar_child(grammar, expression, i),
+            skip);
+    }
+
+    if (expression->kind == DIL_EXPRESSION_REFERENCE) {
+        dil_analysis__inherit(
+            analysis,
+            dil_analysis_at(
+                analysis,
+                dil_rules_at(&grammar->rules, expression->rule)->pattern),
+            lookahead);
+    }
+}
+
+/* Run a pass over every pattern of the grammar. Returns whether anything
+ * grew. */
+bool dil_analysis__pass_all(
+    DilAnalysis* analysis,
+    void (*pass)(DilAnalysis*, size_t, DilCharClass const*))
+{
+    DilGrammar const* grammar = analysis->grammar;
+    analysis->changed         = false;
+    for (size_t i = 0; i < dil_rules_size(&grammar->rules); i++) {
+        DilRule const* rule = dil_rules_at(&grammar->rules, i);
+        pass(analysis, rule->pattern, dil_analysis__skip(analysis, rule));
+    }
+    for (size_t i = 0; i < dil_indices_size(&grammar->skips); i++) {
+        pass(analysis, dil_indices_get(&grammar->skips, i), NULL);
+    }
+    if (grammar->started) {
+        pass(
+            analysis,
+            grammar->start.pattern,
+            dil_analysis__skip(analysis, &grammar->start));
+    }
+    return analysis->changed;
+}
+
+/* Find the first characters, the nullability and the following characters
+ * of every expression in the grammar. */
+DilAnalysis dil_analyze(DilGrammar const* grammar)
+{
+    DilAnalysis analysis = {.grammar = grammar};
+    dil_lookaheads_place(
+        &analysis.expressions,
+        dil_expressions_size(&grammar->expressions),
+        (DilLookahead){0});
+    while (dil_analysis__pass_all(&analysis, &dil_analysis__first)) {}
+
+    // Anything can come after the skips and the start pattern.
+    DilLookahead open = {.ends = true};
+    dil_char_class_invert(&open.follow);
+    for (size_t i = 0; i < dil_indices_size(&grammar->skips); i++) {
+        dil_analysis__inherit(
+            &analysis,
+            dil_analysis_at(&analysis, dil_indices_get(&grammar->skips, i)),
+            &open);
+    }
+    if (grammar->started) {
+        dil_analysis__inherit(
+            &analysis,
+            dil_analysis_at(&analysis, grammar->start.pattern),
+            &open);
+    }
+    while (dil_analysis__pass_all(&analysis, &dil_analysis__follow)) {}
+    return analysis;
+}
+
+/* Print the character like it is in a set in a grammar. */
+void dil_analysis__character(FILE* stream, unsigned character)
+{
+    switch (character) {
+        case '\t':
+            (void)fputs("\\t", stream);
+            return;
+        case '\n':
+            (void)fputs("\\n", stream);
+            return;
+        case '\\':
+        case '\'':
+        case '~':
+            (void)fprintf(stream, "\\%c", (char)character);
+            return;
+        default:
+            break;
+    }
+    if (character >= ' ' && character <= '}') {
+        (void)fputc((int)character, stream);
+    } else {
+        (void)fprintf(stream, "\\%02X", character);
+    }
+}
+
+/* Print the characters of the set like a set in a grammar, with the runs of
+ * more than two characters as ranges. */
+void dil_analysis__print(FILE* stream, DilCharClass const* set)
+{
+    (void)fputc('\'', stream);
+    for (unsigned i = 0; i <= UCHAR_MAX; i++) {
+        if (!dil_char_class_contains(set, (char)i)) {
+            continue;
+        }
+        unsigned last = i;
+        while (last < UCHAR_MAX &&
+               dil_char_class_contains(set, (char)(last + 1))) {
+            last++;
+        }
+        dil_analysis__character(stream, i);
+        if (last > i + 1) {
+            (void)fputc('~', stream);
+        }
+        if (last > i) {
+            dil_analysis__character(stream, last);
+        }
+        i = last;
+    }
+    (void)fputc('\'', stream);
+}
+
+/* Characters the alternative of the choice can be taken at when the grammar
+ * is read as predictive, and whether it can be taken at the end. */
+DilCharClass dil_analysis__predicted(
+    DilAnalysis const* analysis,
+    size_t             choice,
+    size_t             alternative,
+    bool*              ends)
+{
+    DilLookahead const* taken     = dil_analysis_at(analysis, alternative);
+    DilLookahead const* following = dil_analysis_at(analysis, choice);
+    DilCharClass        predicted = taken->first;
+    *ends                         = false;
+    if (taken->nullable) {
+        dil_char_class_unite(&predicted, &following->follow);
+        *ends = following->ends;
+    }
+    return predicted;
+}
+
+/* Count the choices in the expression whose alternatives overlap, and print
+ * them to the stream if it is not null. */
+size_t dil_analysis__overlaps(
+    DilAnalysis const* analysis,
+    size_t             index,
+    char const*        name,
+    FILE*              stream)
+{
+    DilGrammar const*    grammar    = analysis->grammar;
+    DilExpression const* expression = dil_grammar_at(grammar, index);
+    size_t               overlaps   = 0;
+    for (size_t i = 0; i < expression->amount; i++) {
+        overlaps += dil_analysis__overlaps(
+            analysis,
+            dil_grammar_child(grammar, expression, i),
+            name,
+            stream);
+    }
+    if (expression->kind != DIL_EXPRESSION_CHOICE) {
+        return overlaps;
+    }
+
+    for (size_t i = 0; i < expression->amount; i++) {
+        bool         ends  = false;
+        DilCharClass first = dil_analysis__predicted(
+            analysis,
+            index,
+            dil_grammar_child(grammar, expression, i),
+            &ends);
+        for (size_t j = i + 1; j < expression->amount; j++) {
+            bool         otherEnds = false;
+            DilCharClass other     = dil_analysis__predicted(
+                analysis,
+                index,
+                dil_grammar_child(grammar, expression, j),
+                &otherEnds);
+            bool common = ends && otherEnds;
+            for (size_t k = 0; k < 4; k++) {
+                other.bits[k] &= first.bits[k];
+                common = common || other.bits[k] != 0;
+            }
+            if (!common) {
+                continue;
+            }
+            overlaps++;
+            if (stream == NULL) {
+                continue;
+            }
+            (void)fprintf(
+                stream,
+                "%s: alternatives %llu and %llu of `%.*s` overlap at ",
+                name,
+                i + 1,
+                j + 1,
+                (int)dil_string_size(&expression->source),
+                expression->source.first);
+            dil_analysis__print(stream, &other);
+            (void)fprintf(stream, ends && otherEnds ? " and the end\n" : "\n");
+        }
+    }
+    return overlaps;
+}
+
+/* Count the alternatives in the expression that are never tried, since an
+ * alternative before them always accepts, and print them to the stream if it
+ * is not null. */
+size_t dil_analysis__shadowed(
+    DilAnalysis const* analysis,
+    size_t             index,
+    char const*        name,
+    FILE*              stream)
+{
+    DilGrammar const*    grammar    = analysis->grammar;
+    DilExpression const* expression = dil_grammar_at(grammar, index);
+    size_t               shadowed   = 0;
+    for (size_t i = 0; i < expression->amount; i++) {
+        shadowed += dil_analysis__shadowed(
+            analysis,
+            dil_grammar_child(grammar, expression, i),
+            name,
+            stream);
+    }
+    if (expression->kind != DIL_EXPRESSION_CHOICE) {
+        return shadowed;
+    }
+
+    size_t accepting = 0;
+    while (accepting < expression->amount &&
+           !dil_analysis_at(
+                analysis,
+                dil_grammar_child(grammar, expression, accepting))
+                ->vacuous) {
+        accepting++;
+    }
+    for (size_t i = accepting + 1; i < expression->amount; i++) {
+        shadowed++;
+        if (stream == NULL) {
+            continue;
+        }
+        (void)fprintf(
+            stream,
+            "%s: alternative %llu of `%.*s` is never tried, since "
+            "alternative %llu always accepts\n",
+            name,
+            i + 1,
+            (int)dil_string_size(&expression->source),
+            expression->source.first,
+            accepting + 1);
+    }
+    return shadowed;
+}
+
+/* Count the repetitions in the expression whose child can match nothing, so
+ * they could repeat without consuming a character, and print them to the
+ * stream if it is not null. */
+size_t dil_analysis__unbounded(
+    DilAnalysis const* analysis,
+    size_t             index,
+    char const*        name,
+    FILE*              stream)
+{
+    DilGrammar const*    grammar    = analysis->grammar;
+    DilExpression const* expression = dil_grammar_at(grammar, index);
+    size_t               unbounded  = 0;
+    for (size_t i = 0; i < expression->amount; i++) {
+        unbounded += dil_analysis__unbounded(
+            analysis,
+            dil_grammar_child(grammar, expression, i),
+            name,
+            stream);
+    }
+    if ((expression->kind != DIL_EXPRESSION_ZERO_OR_MORE &&
+         expression->kind != DIL_EXPRESSION_ONE_OR_MORE) ||
+        !dil_analysis_at(analysis, dil_grammar_child(grammar, expression, 0))
+             ->nullable) {
+        return unbounded;
+    }
+
+    unbounded++;
+    if (stream != NULL) {
+        (void)fprintf(
+            stream,
+            "%s: error: `%.*s` repeats a pattern that can match nothing\n",
+            name,
+            (int)dil_string_size(&expression->source),
+            expression->source.first);
+    }
+    return unbounded;
+}
+
+/* Whether the rule is reached from the expression before a character is
+ * consumed. The rules that were visited are marked, and not entered
+ * again. */
+bool dil_analysis__reaches(
+    DilAnalysis const* analysis,
+    size_t             index,
+    size_t             rule,
+    DilIndices*        visited)
+{
+    DilGrammar const*    grammar    = analysis->grammar;
+    DilExpression const* expression = dil_grammar_at(grammar, index);
+    switch (expression->kind) {
+        case DIL_EXPRESSION_REFERENCE:
+            if (expression->rule == rule) {
+                return true;
+            }
+            if (dil_indices_get(visited, expression->rule)) {
+                return false;
+            }
+            *dil_indices_at(visited, expression->rule) = true;
+            return dil_analysis__reaches(
+                analysis,
+                dil_rules_at(&grammar->rules, expression->rule)->pattern,
+                rule,
+                visited);
+        case DIL_EXPRESSION_SEQUENCE:
+            // Elements are reached while the ones before them are nullable.
+            for (size_t i = 0; i < expression->amount; i++) {
+                size_t element = dil_grammar_child(grammar, expression, i);
+                if (dil_analysis__reaches(analysis, element, rule, visited)) {
+                    return true;
+                }
+                if (!dil_analysis_at(analysis, element)->nullable) {
+                    return false;
+                }
+            }
+            return false;
+        default:
+            for (size_t i = 0; i < expression->amount; i++) {
+                if (dil_analysis__reaches(
+                        analysis,
+                        dil_grammar_child(grammar, expression, i),
+                        rule,
+                        visited)) {
+                    return true;
+                }
+            }
+            return false;
+    }
+}
+
+/* Add the counts of the check over every pattern of the grammar, which
+ * prints to the stream if it is not null. */
+size_t dil_analysis__check_all(
+    DilAnalysis const* analysis,
+    size_t (*check)(DilAnalysis const*, size_t, char const*, FILE*),
+    FILE*              stream)
+{
+    DilGrammar const* grammar = analysis->grammar;
+    size_t            found   = 0;
+    for (size_t i = 0; i < dil_rules_size(&grammar->rules); i++) {
+        DilRule const* rule = dil_rules_at(&grammar->rules, i);
+        char           name[256];
+        (void)sprintf_s(
+            name,
+            sizeof(name),
+            "%.*s",
+            (int)dil_string_size(&rule->name),
+            rule->name.first);
+        found += check(analysis, rule->pattern, name, stream);
+    }
+    for (size_t i = 0; i < dil_indices_size(&grammar->skips); i++) {
+        found += check(
+            analysis,
+            dil_indices_get(&grammar->skips, i),
+            "skip",
+            stream);
+    }
+    if (grammar->started) {
+        found += check(analysis, grammar->start.pattern, "start", stream);
+    }
+    return found;
+}
+
+/* Count the choices whose alternatives can start at the same character when
+ * the grammar is read as predictive, which means a choice tries more than
+ * one of them there. Prints them to the stream if it is not null. */
+size_t dil_analysis_overlaps(DilAnalysis const* analysis, FILE* stream)
+{
+    return dil_analysis__check_all(analysis, &dil_analysis__overlaps, stream);
+}
+
+/* Count the alternatives that are never tried, since an alternative before
+ * them in their choice always accepts. Prints them to the stream if it is
+ * not null. */
+size_t dil_analysis_shadowed(DilAnalysis const* analysis, FILE* stream)
+{
+    return dil_analysis__check_all(analysis, &dil_analysis__shadowed, stream);
+}
+
+/* Count the repetitions whose pattern can match nothing, which a parser
+ * would repeat forever without consuming a character. Prints them to the
+ * stream if it is not null. */
+size_t dil_analysis_unbounded(DilAnalysis const* analysis, FILE* stream)
+{
+    return dil_analysis__check_all(analysis, &dil_analysis__unbounded, stream);
+}
+
+/* Count the rules that reach themselves before consuming a character, which
+ * a parser would enter forever. Prints them to the stream if it is not
+ * null. */
+size_t dil_analysis_recursive(DilAnalysis const* analysis, FILE* stream)
+{
+    DilGrammar const* grammar   = analysis->grammar;
+    size_t            rules     = dil_rules_size(&grammar->rules);
+    DilIndices        visited   = {0};
+    size_t            recursive = 0;
+    dil_indices_place(&visited, rules, false);
+    for (size_t i = 0; i < rules; i++) {
+        DilRule const* rule = dil_rules_at(&grammar->rules, i);
+        for (size_t j = 0; j < rules; j++) {
+            *dil_indices_at(&visited, j) = false;
+        }
+        if (!dil_analysis__reaches(analysis, rule->pattern, i, &visited)) {
+            continue;
+        }
+        recursive++;
+        if (stream != NULL) {
+            (void)fprintf(
+                stream,
+                "%.*s: error: Rule reaches itself before consuming a "
+                "character\n",
+                (int)dil_string_size(&rule->name),
+                rule->name.first);
+        }
+    }
+    dil_indices_free(&visited);
+    return recursive;
+}
+
+/* Count the repetitions and the rules the parsers cannot finish, and print
+ * them to the stream if it is not null. The generated parsers and the
+ * compiled programs reject grammars that have any. */
+size_t dil_analysis_unending(DilAnalysis const* analysis, FILE* stream)
+{
+    return dil_analysis_unbounded(analysis, stream) +
+           dil_analysis_recursive(analysis, stream);
+}
+
+/* Deallocate memory. */
+void dil_analysis_free(DilAnalysis* analysis)
+{
+    dil_lookaheads_free(&analysis->expressions);
+}
@@ -0,0 +1,598 @@
+// SPDX-FileCopyrightText: 2022 Cem Geçgel <gecgelcem@outlook.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "dil/buffer.c"
+#include "dil/class.c"
+#include "dil/expressions.c"
+#include "dil/grammar.c"
+#include "dil/indices.c"
+#include "dil/rules.c"
+#include "dil/scanner.c"
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Border after the last element of a continuation. */
+#define DIL_AUTOMATON_END SIZE_MAX
+
+/* Entry of a closure that stops with an error. */
+#define DIL_AUTOMATON_STOP (SIZE_MAX - 1)
+
+/* Key of the state the automaton starts at. */
+#define DIL_AUTOMATON_START (SIZE_MAX - 1)
+
+/* Maximum nesting of the expressions that are followed without matching a
+ * character, which is only reached by repeating a pattern that can match
+ * nothing. */
+#define DIL_AUTOMATON_DEPTH 256
+
+/* Deterministic automaton of a rule, which can be emitted as a scanner. */
+typedef struct {
+    /* Column of each character, and of the end of the contents after
+     * them. */
+    DilBuffer columns;
+    /* Amount of columns. */
+    size_t width;
+    /* Next state or the outcome at each column of each state, row by
+     * row. */
+    DilBuffer table;
+    /* Amount of states. */
+    size_t states;
+    /* State the automaton starts at. */
+    size_t start;
+    /* Amount of states before they were minimized. */
+    size_t built;
+    /* Whether the rule has strings, which are parsed as a node each instead
+     * of separate characters. */
+    bool strings;
+} DilAutomaton;
+
+/* Rule whose automaton is being built. The parser commits to an alternative
+ * once its first element matches, so it never goes back over a matched
+ * character; every point in the pattern is followed by one point for each
+ * character. The points are cells that hold the pattern that is left, and
+ * are the states of a nondeterministic automaton whose empty moves are
+ * ordered. The closure of a cell lists the tests that can match next in the
+ * order the parser tries them, so the subset of the cells that are reached
+ * by a character is the successor of the first test that matches it. */
+typedef struct {
+    /* Grammar the rule is in. */
+    DilGrammar const* grammar;
+    /* Element, offset in the string if it is one, and the next cell of
+     * each cell. An element is an expression at twice its index, or the
+     * repetition of the child of a one or more after it. */
+    DilIndices cells;
+    /* Cell of each state, or the start. */
+    DilIndices keys;
+    /* Test cells and stops in the order they are tried. */
+    DilIndices closure;
+    /* Next state or the outcome at each column of each state. */
+    DilIndices rows;
+    /* Column of each character. */
+    DilIndices columns;
+    /* Current nesting of the followed expressions. */
+    size_t depth;
+    /* Whether a string was split into columns. */
+    bool strings;
+    /* Whether the rule is rejected if nothing matches at the start. */
+    bool rejects;
+    /* Whether the rule could not be converted. */
+    bool failed;
+} DilAutomatonBuilder;
+
+/* Whether the expression only consists of terminals that match at least a
+ * character. */
+bool dil_automaton__regular(DilGrammar const* grammar, size_t index)
+{
+    DilExpression const* expression = dil_grammar_at(grammar, index);
+    if (expression->kind == DIL_EXPRESSION_REFERENCE ||
+        (expression->kind == DIL_EXPRESSION_STRING &&
+         expression->length == 0)) {
+        return false;
+    }
+    for (size_t i = 0; i < expression->amount; i++) {
+        if (!dil_automaton__regular(
+                grammar,
+                dil_grammar_child(grammar, expression, i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Whether the expression can fail at its start, which makes the rule
+ * rejected instead of reporting an error when it is at the start. */
+bool dil_automaton__fails(DilGrammar const* grammar, size_t index)
+{
+    DilExpression const* expression = dil_grammar_at(grammar, index);
+    switch (expression->kind) {
+        case DIL_EXPRESSION_OPTIONAL:
+        case DIL_EXPRESSION_ZERO_OR_MORE:
+            return false;
+        case DIL_EXPRESSION_CHOICE:
+            for (size_t i = 0; i < expression->amount; i++) {
+                if (!dil_automaton__fails(
+                        grammar,
+                        dil_grammar_child(grammar, expression, i))) {
+                    return false;
+                }
+            }
+            return true;
+        case DIL_EXPRESSION_SEQUENCE:
+            // Decided on the first element that can fail.
+            for (size_t i = 0; i < expression->amount; i++) {
+                if (dil_automaton__fails(
+                        grammar,
+                        dil_grammar_child(grammar, expression, i))) {
+                    return true;
+                }
+            }
+            return false;
+        case DIL_EXPRESSION_ONE_OR_MORE:
+        case DIL_EXPRESSION_FIXED_TIMES:
+            return dil_automaton__fails(
+                grammar,
+                dil_grammar_child(grammar, expression, 0));
+        default:
+            return true;
+    }
+}
+
+/* Index of the cell, which is added if it is not there. */
+size_t dil_automaton__cell(
+    DilAutomatonBuilder* builder,
+    size_t               element,
+    size_t               offset,
+    size_t               next)
+{
+    size_t amount = dil_indices_size(&builder->cells) / 3;
+    for (size_t i = 0; i < amount; i++) {
+        size_t const* cell = dil_indices_at(&builder->cells, i * 3);
+        if (cell[0] == element && cell[1] == offset && cell[2] == next) {
+            return i;
+        }
+    }
+    dil_indices_add(&builder->cells, element);
+    dil_indices_add(&builder->cells, offset);
+    dil_indices_add(&builder->cells, next);
+    return amount;
+}
+
+/* Component of the cell, which is its element, offset or next cell. */
+size_t dil_automaton__part(
+    DilAutomatonBuilder const* builder,
+    size_t                     cell,
+    size_t                     part)
+{
+    return dil_indices_get(&builder->cells, cell * 3 + part);
+}
+
+void dil_automaton__follow(
+    DilAutomatonBuilder* builder,
+    size_t               element,
+    size_t               next,
+    bool                 optional);
+
+/* Add the closure of the continuation, or the end. The continuation must
+ * match unless it is optional, which it is when nothing was matched since a
+ * point that could still fail. */
+void dil_automaton__continue(
+    DilAutomatonBuilder* builder,
+    size_t               next,
+    bool                 optional)
+{
+    if (next == DIL_AUTOMATON_END) {
+        dil_indices_add(&builder->closure, DIL_AUTOMATON_END);
+        return;
+    }
+    dil_automaton__follow(
+        builder,
+        dil_automaton__part(builder, next, 0),
+        dil_automaton__part(builder, next, 2),
+        optional);
+}
+
+/* Add the tests that can match the element followed by the next cell to the
+ * closure. The tests after it are only reached if the element is optional,
+ * which means it is left without an error when its start does not match. */
+void dil_automaton__follow(
+    DilAutomatonBuilder* builder,
+    size_t               element,
+    size_t               next,
+    bool                 optional)
+{
+    if (builder->failed || ++builder->depth > DIL_AUTOMATON_DEPTH) {
+        builder->failed = true;
+        return;
+    }
+
+    DilGrammar const*    grammar    = builder->grammar;
+    DilExpression const* expression = dil_grammar_at(grammar, element / 2);
+    if (element % 2 == 1) {
+        // Repetition of the child of a one or more.
+        dil_automaton__follow(
+            builder,
+            dil_grammar_child(grammar, expression, 0) * 2,
+            dil_automaton__cell(builder, element, 0, next),
+            true);
+        dil_automaton__continue(builder, next, false);
+        builder->depth--;
+        return;
+    }
+
+    size_t first = expression->amount == 0
+                       ? 0
+                       : dil_grammar_child(grammar, expression, 0) * 2;
+    switch (expression->kind) {
+        case DIL_EXPRESSION_SEQUENCE: {
+            size_t rest = next;
+            for (size_t i = expression->amount - 1; i > 0; i--) {
+                rest = dil_automaton__cell(
+                    builder,
+                    dil_grammar_child(grammar, expression, i) * 2,
+                    0,
+                    rest);
+            }
+            dil_automaton__follow(builder, first, rest, optional);
+            break;
+        }
+        case DIL_EXPRESSION_CHOICE: {
+            bool fails = true;
+            for (size_t i = 0; i < expression->amount && fails; i++) {
+                size_t child = dil_grammar_child(grammar, expression, i);
+                fails        = dil_automaton__fails(grammar, child);
+                dil_automaton__follow(builder, child * 2, next, true);
+            }
+            if (fails && !optional) {
+                dil_indices_add(&builder->closure, DIL_AUTOMATON_STOP);
+            }
+            break;
+        }
+        case DIL_EXPRESSION_OPTIONAL:
+            dil_automaton__follow(builder, first, next, true);
+            dil_automaton__continue(builder, next, optional);
+            break;
+        case DIL_EXPRESSION_ZERO_OR_MORE:
+            dil_automaton__follow(
+                builder,
+                first,
+                dil_automaton__cell(builder, element, 0, next),
+                true);
+            dil_automaton__continue(builder, next, optional);
+            break;
+        case DIL_EXPRESSION_ONE_OR_MORE:
+            dil_automaton__follow(
+                builder,
+                first,
+                dil_automaton__cell(builder, element + 1, 0, next),
+                optional);
+            break;
+        case DIL_EXPRESSION_FIXED_TIMES: {
+            size_t rest = next;
+            for (size_t i = 1; i < expression->times; i++) {
+                rest = dil_automaton__cell(builder, first, 0, rest);
+            }
+            dil_automaton__follow(builder, first, rest, optional);
+            break;
+        }
+        default:
+            dil_indices_add(
+                &builder->closure,
+                dil_automaton__cell(builder, element, 0, next));
+            if (!optional) {
+                dil_indices_add(&builder->closure, DIL_AUTOMATON_STOP);
+            }
+            break;
+    }
+    builder->depth--;
+}
+
+/* Whether the test cell matches the character. */
+bool dil_automaton__matches(
+    DilAutomatonBuilder const* builder,
+    size_t                     cell,
+    unsigned char              character)
+{
+    DilExpression const* expression = dil_grammar_at(
+        builder->grammar,
+        dil_automaton__part(builder, cell, 0) / 2);
+    switch (expression->kind) {
+        case DIL_EXPRESSION_NOT_SET:
+            return !dil_char_class_contains(&expression->set, (char)character);
+        case DIL_EXPRESSION_STRING:
+            return (unsigned char)dil_buffer_get(
+                       &builder->grammar->texts,
+                       expression->text +
+                           dil_automaton__part(builder, cell, 1)) == character;
+        default:
+            return dil_char_class_contains(&expression->set, (char)character);
+    }
+}
+
+/* Cell that is reached after the test cell matches. */
+size_t dil_automaton__successor(DilAutomatonBuilder* builder, size_t cell)
+{
+    size_t               element    = dil_automaton__part(builder, cell, 0);
+    size_t               offset     = dil_automaton__part(builder, cell, 1);
+    size_t               next       = dil_automaton__part(builder, cell, 2);
+    DilExpression const* expression =
+        dil_grammar_at(builder->grammar, element / 2);
+    if (expression->kind == DIL_EXPRESSION_STRING &&
+        offset + 1 < expression->length) {
+        return dil_automaton__cell(builder, element, offset + 1, next);
+    }
+    return next;
+}
+
+/* Group the characters that every test in the expression treats the same
+ * into columns. */
+void dil_automaton__split(DilAutomatonBuilder* builder, size_t index)
+{
+    DilExpression const* expression = dil_grammar_at(builder->grammar, index);
+    for (size_t i = 0; i < expression->amount; i++) {
+        dil_automaton__split(
+            builder,
+            dil_grammar_child(builder->grammar, expression, i));
+    }
+
+    size_t length = expression->kind == DIL_EXPRESSION_STRING
+                        ? expression->length
+                        : expression->kind <= DIL_EXPRESSION_NOT_SET;
+    for (size_t i = 0; i < length; i++) {
+        DilCharClass set = expression->set;
+        if (expression->kind == DIL_EXPRESSION_STRING) {
+            builder->strings = true;
+            set              = (DilCharClass){0};
+            dil_char_class_add(
+                &set,
+                dil_buffer_get(&builder->grammar->texts, expression->text + i));
+        }
+
+        // Separate the characters in the set from the others in each column.
+        DilIndices renamed = {0};
+        dil_indices_place(&renamed, 2 * (UCHAR_MAX + 1), SIZE_MAX);
+        size_t amount = 0;
+        for (size_t j = 0; j <= UCHAR_MAX; j++) {
+            size_t* column = dil_indices_at(&builder->columns, j);
+            size_t* name   = dil_indices_at(
+                &renamed,
+                *column * 2 + dil_char_class_contains(&set, (char)j));
+            if (*name == SIZE_MAX) {
+                *name = amount++;
+            }
+            *column = *name;
+        }
+        dil_indices_free(&renamed);
+    }
+}
+
+/* Index of the state of the key, which is added if it is not there. */
+size_t dil_automaton__state(DilAutomatonBuilder* builder, size_t key)
+{
+    size_t amount = dil_indices_size(&builder->keys);
+    for (size_t i = 0; i < amount; i++) {
+        if (dil_indices_get(&builder->keys, i) == key) {
+            return i;
+        }
+    }
+    dil_indices_add(&builder->keys, key);
+    return amount;
+}
+
+/* Outcome or the next state of the first entry of the closure that takes the
+ * character, or the end of the contents if the character is null. */
+size_t dil_automaton__move(
+    DilAutomatonBuilder* builder,
+    bool                 start,
+    int                  character)
+{
+    for (size_t i = 0; i < dil_indices_size(&builder->closure); i++) {
+        size_t entry = dil_indices_get(&builder->closure, i);
+        if (entry == DIL_AUTOMATON_END) {
+            return DIL_SCANNER_ACCEPT;
+        }
+        if (entry == DIL_AUTOMATON_STOP) {
+            break;
+        }
+        if (character >= 0 &&
+            dil_automaton__matches(builder, entry, (unsigned char)character)) {
+            return DIL_SCANNER_STATES +
+                   dil_automaton__state(
+                       builder,
+                       dil_automaton__successor(builder, entry));
+        }
+    }
+    return start && builder->rejects ? DIL_SCANNER_REJECT
+                                     : DIL_SCANNER_FALLBACK;
+}
+
+/* Merge the states that cannot be told apart. Returns the group of each
+ * state, and puts the amount of groups to the amount. */
+DilIndices dil_automaton__minimize(
+    DilAutomatonBuilder const* builder,
+    size_t                     width,
+    size_t*                    amount)
+{
+    size_t     states = dil_indices_size(&builder->keys);
+    DilIndices groups = {0};
+    DilIndices next   = {0};
+    dil_indices_place(&groups, states, 0);
+    *amount = 1;
+
+    // Split the groups by the groups of the moves until they do not change.
+    while (true) {
+        dil_indices_clear(&next);
+        size_t found = 0;
+        for (size_t i = 0; i < states; i++) {
+            size_t j = 0;
+            for (; j < i; j++) {
+                bool same = dil_indices_get(&groups, i) ==
+                            dil_indices_get(&groups, j);
+                for (size_t k = 0; k < width && same; k++) {
+                    size_t a = dil_indices_get(&builder->rows, i * width + k);
+                    size_t b = dil_indices_get(&builder->rows, j * width + k);
+                    if (a >= DIL_SCANNER_STATES && b >= DIL_SCANNER_STATES) {
+                        a = dil_indices_get(&groups, a - DIL_SCANNER_STATES);
+                        b = dil_indices_get(&groups, b - DIL_SCANNER_STATES);
+                        same = a == b;
+                    } else {
+                        same = a == b && a < DIL_SCANNER_STATES;
+                    }
+                }
+                if (same) {
+                    break;
+                }
+            }
+            dil_indices_add(
+                &next,
+                j < i ? dil_indices_get(&next, j) : found++);
+        }
+
+        DilIndices swapped = groups;
+        groups             = next;
+        next               = swapped;
+        if (found == *amount) {
+            break;
+        }
+        *amount = found;
+    }
+
+    dil_indices_free(&next);
+    return groups;
+}
+
+/* Build the automaton of the rule. Returns whether the rule only has
+ * terminals without skips between them and the automaton fits to the table
+ * of a scanner. */
+bool dil_automaton_build(
+    DilAutomaton*     automaton,
+    DilGrammar const* grammar,
+    size_t            rule)
+{
+    DilRule const* current = dil_rules_at(&grammar->rules, rule);
+    size_t         pattern = current->pattern;
+    *automaton             = (DilAutomaton){0};
+    if (current->skipped || !dil_automaton__regular(grammar, pattern)) {
+        return false;
+    }
+
+    DilAutomatonBuilder builder = {
+        .grammar = grammar,
+        .rejects = dil_automaton__fails(grammar, pattern)};
+    dil_indices_place(&builder.columns, UCHAR_MAX + 1, 0);
+    dil_automaton__split(&builder, pattern);
+
+    // Find a character of each column, and give the end its own column.
+    size_t     width      = 0;
+    DilIndices characters = {0};
+    for (size_t i = 0; i <= UCHAR_MAX; i++) {
+        size_t column = dil_indices_get(&builder.columns, i);
+        if (column >= width) {
+            width = column + 1;
+            dil_indices_place(
+                &characters,
+                width - dil_indices_size(&characters),
+                0);
+        }
+        *dil_indices_at(&characters, column) = i;
+    }
+    dil_indices_add(&characters, SIZE_MAX);
+    width++;
+
+    (void)dil_automaton__state(&builder, DIL_AUTOMATON_START);
+    for (size_t i = 0; i < dil_indices_size(&builder.keys) && !builder.failed;
+         i++) {
+        size_t key = dil_indices_get(&builder.keys, i);
+        dil_indices_clear(&builder.closure);
+        builder.depth = 0;
+        if (key == DIL_AUTOMATON_START) {
+            dil_automaton__follow(
+                &builder,
+                pattern * 2,
+                DIL_AUTOMATON_END,
+                false);
+        } else if (key == DIL_AUTOMATON_END) {
+            dil_indices_add(&builder.closure, DIL_AUTOMATON_END);
+        } else if (dil_automaton__part(&builder, key, 1) != 0) {
+            // Rest of a string, which is not matched at all if it fails.
+            dil_indices_add(&builder.closure, key);
+            dil_indices_add(&builder.closure, DIL_AUTOMATON_STOP);
+        } else {
+            dil_automaton__continue(&builder, key, false);
+        }
+
+        for (size_t j = 0; j < width; j++) {
+            size_t character = dil_indices_get(&characters, j);
+            dil_indices_add(
+                &builder.rows,
+                dil_automaton__move(
+                    &builder,
+                    i == 0,
+                    character == SIZE_MAX ? -1 : (int)character));
+        }
+    }
+
+    size_t     groups = 0;
+    DilIndices merged = {0};
+    if (!builder.failed) {
+        merged = dil_automaton__minimize(&builder, width, &groups);
+    }
+    if (!builder.failed && groups + DIL_SCANNER_STATES <= UCHAR_MAX + 1) {
+        automaton->width   = width;
+        automaton->states  = groups;
+        automaton->built   = dil_indices_size(&builder.keys);
+        automaton->start   = DIL_SCANNER_STATES + dil_indices_get(&merged, 0);
+        automaton->strings = builder.strings;
+        for (size_t i = 0; i <= UCHAR_MAX; i++) {
+            dil_buffer_add(
+                &automaton->columns,
+                (char)dil_indices_get(&builder.columns, i));
+        }
+        dil_buffer_add(&automaton->columns, (char)(width - 1));
+
+        // Take the first state of each group as the row of the group.
+        dil_buffer_place(&automaton->table, groups * width, 0);
+        for (size_t i = automaton->built; i > 0; i--) {
+            size_t group = dil_indices_get(&merged, i - 1);
+            char*  row   = dil_buffer_at(&automaton->table, group * width);
+            for (size_t j = 0; j < width; j++) {
+                size_t move =
+                    dil_indices_get(&builder.rows, (i - 1) * width + j);
+                if (move >= DIL_SCANNER_STATES) {
+                    move = DIL_SCANNER_STATES +
+                           dil_indices_get(&merged, move - DIL_SCANNER_STATES);
+                }
+                row[j] = (char)move;
+            }
+        }
+    } else {
+        builder.failed = true;
+    }
+
+    dil_indices_free(&merged);
+    dil_indices_free(&characters);
+    dil_indices_free(&builder.cells);
+    dil_indices_free(&builder.keys);
+    dil_indices_free(&builder.closure);
+    dil_indices_free(&builder.rows);
+    dil_indices_free(&builder.columns);
+    return !builder.failed;
+}
+
+/* Amount of bytes the tables of the automaton take. */
+size_t dil_automaton_size(DilAutomaton const* automaton)
+{
+    return dil_buffer_size(&automaton->columns) +
+           dil_buffer_size(&automaton->table);
+}
+
+/* Deallocate memory. */
+void dil_automaton_free(DilAutomaton* automaton)
+{
+    dil_buffer_free(&automaton->columns);
+    dil_buffer_free(&automaton->table);
+}
@@ -0,0 +1,251 @@
+// SPDX-FileCopyrightText: 2022 Cem Geçgel <gecgelcem@outlook.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "dil/analysis.c"
+#include "dil/class.c"
+#include "dil/expressions.c"
+#include "dil/grammar.c"
+#include "dil/indices.c"
+#include "dil/rules.c"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Rules a generated parser can try again at an offset it rejected them at.
+ * Since a rule only rejects when its first element does, the parser never
+ * goes back over a rule it accepted; a rule is only tried again when a later
+ * alternative of a choice, or the elements after a repetition, start with a
+ * rule that was rejected there. These are found from the rules each
+ * expression can enter at the offset it starts at. */
+typedef struct {
+    /* Analyzed grammar. */
+    DilGrammar const* grammar;
+    /* Characters around the expressions of the grammar. */
+    DilAnalysis const* analysis;
+    /* Whether each rule can be tried again at the same offset. */
+    DilIndices retried;
+    /* Whether each rule can start the child of a repetition, so it is tried
+     * at most of the offsets the repetition goes over. */
+    DilIndices repeated;
+    /* Stamp of the last walk that entered each rule. */
+    DilIndices entered;
+    /* Stamp of the last walk that visited each rule while looking for the
+     * ones that were entered before. */
+    DilIndices visited;
+    /* Stamp of the current walk. */
+    size_t stamp;
+} DilBacktracking;
+
+/* Whether the rule at the index can be tried again at the same offset. */
+bool dil_backtracking_retried(
+    DilBacktracking const* backtracking,
+    size_t                 rule)
+{
+    return dil_indices_get(&backtracking->retried, rule) != 0;
+}
+
+/* Whether the rule at the index can start the child of a repetition. */
+bool dil_backtracking_repeated(
+    DilBacktracking const* backtracking,
+    size_t                 rule)
+{
+    return dil_indices_get(&backtracking->repeated, rule) != 0;
+}
+
+/* Mark the rules the expression can enter at the offset it starts at with
+ * the current stamp. If the prior stamp is not zero, the rules that were
+ * entered with it are marked as retried instead of being followed. */
+void dil_backtracking__walk(
+    DilBacktracking* backtracking,
+    size_t           index,
+    DilIndices*      marks,
+    size_t           prior)
+{
+    DilGrammar const*    grammar    = backtracking->grammar;
+    DilExpression const* expression = dil_grammar_at(grammar, index);
+    switch (expression->kind) {
+        case DIL_EXPRESSION_REFERENCE: {
+            size_t rule = expression->rule;
+            if (prior != 0 &&
+                dil_indices_get(&backtracking->entered, rule) == prior) {
+                dil_indices_put(&backtracking->retried, rule, true);
+                break;
+            }
+            if (dil_indices_get(marks, rule) == backtracking->stamp) {
+                break;
+            }
+            dil_indices_put(marks, rule, backtracking->stamp);
+            dil_backtracking__walk(
+                backtracking,
+                dil_rules_at(&grammar->rules, rule)->pattern,
+                marks,
+                prior);
+            break;
+        }
+        case DIL_EXPRESSION_SEQUENCE:
+            for (size_t i = 0; i < expression->amount; i++) {
+                size_t child = dil_grammar_child(grammar, expression, i);
+                dil_backtracking__walk(backtracking, child, marks, prior);
+                if (!dil_analysis_at(backtracking->analysis, child)->vacuous) {
+                    break;
+                }
+            }
+            break;
+        default:
+            for (size_t i = 0; i < expression->amount; i++) {
+                dil_backtracking__walk(
+                    backtracking,
+                    dil_grammar_child(grammar, expression, i),
+                    marks,
+                    prior);
+            }
+            break;
+    }
+}
+
+/* Whether the alternatives of a choice can be tried at the same character,
+ * which is only the case when both are viable at it. */
+bool dil_backtracking__overlap(
+    DilBacktracking const* backtracking,
+    size_t                 alternative,
+    size_t                 other)
+{
+    DilCharClass first =
+        dil_analysis_viable(backtracking->analysis, alternative);
+    DilCharClass second = dil_analysis_viable(backtracking->analysis, other);
+    for (size_t i = 0; i < 4; i++) {
+        if ((first.bits[i] & second.bits[i]) != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Mark the rules the later alternatives of the choice can try again. */
+void dil_backtracking__choice(
+    DilBacktracking*     backtracking,
+    DilExpression const* choice)
+{
+    DilGrammar const* grammar = backtracking->grammar;
+    for (size_t i = 1; i < choice->amount; i++) {
+        size_t alternative = dil_grammar_child(grammar, choice, i);
+        size_t prior       = ++backtracking->stamp;
+        for (size_t j = 0; j < i; j++) {
+            size_t other = dil_grammar_child(grammar, choice, j);
+            if (dil_backtracking__overlap(backtracking, alternative, other)) {
+                dil_backtracking__walk(
+                    backtracking,
+                    other,
+                    &backtracking->entered,
+                    0);
+            }
+        }
+        backtracking->stamp++;
+        dil_backtracking__walk(
+            backtracking,
+            alternative,
+            &backtracking->visited,
+            prior);
+    }
+}
+
+/* Mark the rules the elements after each repetition in the sequence can try
+ * again after the repetition stopped. */
+void dil_backtracking__sequence(
+    DilBacktracking*     backtracking,
+    DilExpression const* sequence)
+{
+    DilGrammar const* grammar = backtracking->grammar;
+    for (size_t i = 0; i + 1 < sequence->amount; i++) {
+        DilExpression const* element =
+            dil_grammar_at(grammar, dil_grammar_child(grammar, sequence, i));
+        if (element->kind != DIL_EXPRESSION_OPTIONAL &&
+            element->kind != DIL_EXPRESSION_ZERO_OR_MORE &&
+            element->kind != DIL_EXPRESSION_ONE_OR_MORE) {
+            continue;
+        }
+
+        size_t prior = ++backtracking->stamp;
+        dil_backtracking__walk(
+            backtracking,
+            dil_grammar_child(grammar, element, 0),
+            &backtracking->entered,
+            0);
+        backtracking->stamp++;
+        for (size_t j = i + 1; j < sequence->amount; j++) {
+            size_t next = dil_grammar_child(grammar, sequence, j);
+            dil_backtracking__walk(
+                backtracking,
+                next,
+                &backtracking->visited,
+                prior);
+            if (!dil_analysis_at(backtracking->analysis, next)->vacuous) {
+                break;
+            }
+        }
+    }
+}
+
+/* Mark the rules the child of the repetition can start with as repeated. */
+void dil_backtracking__repetition(
+    DilBacktracking*     backtracking,
+    DilExpression const* repetition)
+{
+    DilGrammar const* grammar = backtracking->grammar;
+    size_t            stamp   = ++backtracking->stamp;
+    dil_backtracking__walk(
+        backtracking,
+        dil_grammar_child(grammar, repetition, 0),
+        &backtracking->entered,
+        0);
+    for (size_t i = 0; i < dil_rules_size(&grammar->rules); i++) {
+        if (dil_indices_get(&backtracking->entered, i) == stamp) {
+            dil_indices_put(&backtracking->repeated, i, true);
+        }
+    }
+}
+
+/* Find the rules of the analyzed grammar that can be tried again at an
+ * offset they were rejected at. */
+DilBacktracking dil_backtrack(DilAnalysis const* analysis)
+{
+    DilGrammar const* grammar      = analysis->grammar;
+    size_t            rules        = dil_rules_size(&grammar->rules);
+    DilBacktracking   backtracking = {
+          .grammar  = grammar,
+          .analysis = analysis};
+    dil_indices_place(&backtracking.retried, rules, false);
+    dil_indices_place(&backtracking.repeated, rules, false);
+    dil_indices_place(&backtracking.entered, rules, 0);
+    dil_indices_place(&backtracking.visited, rules, 0);
+
+    for (size_t i = 0; i < dil_expressions_size(&grammar->expressions); i++) {
+        DilExpression const* expression = dil_grammar_at(grammar, i);
+        switch (expression->kind) {
+            case DIL_EXPRESSION_CHOICE:
+                dil_backtracking__choice(&backtracking, expression);
+                break;
+            case DIL_EXPRESSION_SEQUENCE:
+                dil_backtracking__sequence(&backtracking, expression);
+                break;
+            case DIL_EXPRESSION_ZERO_OR_MORE:
+            case DIL_EXPRESSION_ONE_OR_MORE:
+                dil_backtracking__repetition(&backtracking, expression);
+                break;
+            default:
+                break;
+        }
+    }
+    return backtracking;
+}
+
+/* Deallocate memory. */
+void dil_backtracking_free(DilBacktracking* backtracking)
+{
+    dil_indices_free(&backtracking->retried);
+    dil_indices_free(&backtracking->repeated);
+    dil_indices_free(&backtracking->entered);
+    dil_indices_free(&backtracking->visited);
+}
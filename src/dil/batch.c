@@ -0,0 +1,212 @@
+// SPDX-FileCopyrightText: 2022 Cem Geçgel <gecgelcem@outlook.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "dil/buffer.c"
+#include "dil/memo.c"
+#include "dil/parser.c"
+#include "dil/sink.c"
+#include "dil/source.c"
+#include "dil/string.c"
+#include "dil/tree.c"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <threads.h>
+#include <time.h>
+
+/* Result of parsing a source file in a batch. */
+typedef struct {
+    /* Parsed source file. */
+    DilSource source;
+    /* Counters of the parsing process. */
+    DilParseStatistics statistics;
+    /* Memory of the contents if the trees are kept or there are errors. */
+    DilBuffer buffer;
+    /* Parsed tree if the trees are kept. */
+    DilTree tree;
+    /* Amount of characters in the source file. */
+    size_t size;
+    /* Amount of nodes in the parsed tree. */
+    size_t nodes;
+    /* Errors of the source file, unless the options are quiet. */
+    DilSink sink;
+} DilBatchFile;
+
+/* Many source files that are parsed on a fixed amount of threads. */
+typedef struct {
+    /* Amount of threads, including the calling one. */
+    size_t threads;
+    /* Options of the parsing processes. Each thread uses a memo of its own
+     * if there is one, and the statistics are counted for each source
+     * file. The errors are added to the sink of each source file, and are
+     * not recorded in the statements. */
+    DilParseOptions options;
+    /* Whether the trees and the contents are kept in the results. */
+    bool keep;
+    /* Result of each source file in the order they were given. */
+    DilBatchFile* files;
+    /* Amount of source files. */
+    size_t amount;
+    /* Index of the next source file a thread takes. */
+    size_t next;
+    /* Lock of the next index. */
+    mtx_t lock;
+    /* Time it took to parse all the source files in seconds. */
+    double seconds;
+} DilBatch;
+
+/* Index of the next source file to parse, or the amount of source files if
+ * all are taken. */
+size_t dil_batch_take(DilBatch* batch)
+{
+    (void)mtx_lock(&batch->lock);
+    size_t result = batch->next;
+    if (batch->next < batch->amount) {
+        batch->next++;
+    }
+    (void)mtx_unlock(&batch->lock);
+    return result;
+}
+
+/* Parse the source files until none is left, with a buffer and a memo that
+ * are reused for each source file of the thread. */
+int dil_batch_work(void* argument)
+{
+    DilBatch*       batch   = argument;
+    DilBuffer       buffer  = {0};
+    DilMemo         memo    = {0};
+    DilParseOptions options = batch->options;
+    options.errors          = NULL;
+    if (options.memo != NULL) {
+        options.memo = &memo;
+    }
+
+    for (size_t i = dil_batch_take(batch); i < batch->amount;
+         i = dil_batch_take(batch)) {
+        DilBatchFile* file     = &batch->files[i];
+        DilBuffer*    contents = batch->keep ? &file->buffer : &buffer;
+        dil_buffer_clear(contents);
+
+        file->source = dil_source_load(contents, file->source.path);
+        if (file->source.error != 0) {
+            continue;
+        }
+        options.statistics = &file->statistics;
+        options.sink       = &file->sink;
+        DilTree tree       = dil_parse_with(file->source, options);
+        file->source.error = file->statistics.errors;
+        file->size         = dil_string_size(&file->source.contents);
+        file->nodes        = dil_tree_size(&tree);
+        if (batch->keep) {
+            file->tree = tree;
+        } else {
+            // Errors refer to the contents until they are printed.
+            if (file->source.error != 0) {
+                file->buffer = buffer;
+                buffer       = (DilBuffer){0};
+            } else {
+                file->source.contents = (DilString){0};
+            }
+            dil_tree_free(&tree);
+        }
+    }
+
+    dil_memo_free(&memo);
+    dil_buffer_free(&buffer);
+    return 0;
+}
+
+/* Parse the source files at the paths. Prints the errors of each source file
+ * that has some after all are parsed, in the order they were given. Each
+ * source file has a sink of its own, so printing it only goes over its
+ * errors. */
+void dil_batch_run(DilBatch* batch, char const* const* paths, size_t amount)
+{
+    batch->files  = calloc(amount, sizeof(DilBatchFile));
+    batch->amount = amount;
+    batch->next   = 0;
+    for (size_t i = 0; i < amount; i++) {
+        batch->files[i].source.path = paths[i];
+        dil_sink_init(&batch->files[i].sink, 0);
+    }
+    (void)mtx_init(&batch->lock, mtx_plain);
+
+    struct timespec start;
+    (void)timespec_get(&start, TIME_UTC);
+
+    size_t  helpers = batch->threads > 1 ? batch->threads - 1 : 0;
+    thrd_t* workers = calloc(helpers, sizeof(thrd_t));
+    bool*   started = calloc(helpers, sizeof(bool));
+    for (size_t i = 0; i < helpers; i++) {
+        started[i] = thrd_create(&workers[i], &dil_batch_work, batch) ==
+                     thrd_success;
+    }
+    (void)dil_batch_work(batch);
+    for (size_t i = 0; i < helpers; i++) {
+        if (started[i]) {
+            (void)thrd_join(workers[i], NULL);
+        }
+    }
+    free(started);
+    free(workers);
+
+    struct timespec end;
+    (void)timespec_get(&end, TIME_UTC);
+    batch->seconds = (double)(end.tv_sec - start.tv_sec) +
+                     (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+    mtx_destroy(&batch->lock);
+
+    if (batch->options.quiet) {
+        return;
+    }
+    for (size_t i = 0; i < amount; i++) {
+        DilBatchFile const* file = &batch->files[i];
+        if (file->statistics.errors == 0) {
+            continue;
+        }
+        dil_sink_print(&file->sink, &file->source);
+        dil_parse_summarize(&file->source);
+    }
+}
+
+/* Print the amount of source files, errors and the speed of the batch. */
+void dil_batch_print(FILE* stream, DilBatch const* batch)
+{
+    size_t bytes  = 0;
+    size_t nodes  = 0;
+    size_t errors = 0;
+    for (size_t i = 0; i < batch->amount; i++) {
+        bytes += batch->files[i].size;
+        nodes += batch->files[i].nodes;
+        errors += batch->files[i].source.error;
+    }
+    (void)fprintf(
+        stream,
+        "Parsed %llu files with %llu errors, %llu bytes and %llu nodes on %llu "
+        "threads in %.3f seconds: %.1f MB/s, %.1f files/s.\n",
+        batch->amount,
+        errors,
+        bytes,
+        nodes,
+        batch->threads,
+        batch->seconds,
+        batch->seconds > 0 ? (double)bytes / batch->seconds / 1e6 : 0,
+        batch->seconds > 0 ? (double)batch->amount / batch->seconds : 0);
+}
+
+/* Deallocate memory. */
+void dil_batch_free(DilBatch* batch)
+{
+    for (size_t i = 0; i < batch->amount; i++) {
+        dil_tree_free(&batch->files[i].tree);
+        dil_buffer_free(&batch->files[i].buffer);
+        dil_sink_free(&batch->files[i].sink);
+    }
+    free(batch->files);
+    batch->files  = NULL;
+    batch->amount = 0;
+}
@@ -0,0 +1,145 @@
+// SPDX-FileCopyrightText: 2022 Cem Geçgel <gecgelcem@outlook.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "dil/class.c"
+#include "dil/scan.c"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Place in the source file a boundary scan is at. */
+typedef enum {
+    /* Between the tokens of the statements. */
+    DIL_BOUNDARY_CODE,
+    /* After a slash between the tokens. */
+    DIL_BOUNDARY_SLASH,
+    /* After a semicolon between the tokens. */
+    DIL_BOUNDARY_SEMICOLON,
+    /* In a comment. */
+    DIL_BOUNDARY_COMMENT,
+    /* In a string. */
+    DIL_BOUNDARY_STRING,
+    /* After a backslash in a string. */
+    DIL_BOUNDARY_STRING_ESCAPE,
+    /* In a set. */
+    DIL_BOUNDARY_SET,
+    /* After a backslash in a set. */
+    DIL_BOUNDARY_SET_ESCAPE
+} DilBoundaryState;
+
+/* Scanner that finds the boundaries between the top level statements without
+ * parsing them. A boundary is a semicolon that is not in a string, a set or a
+ * comment, and is directly followed by a new line. The parser always ends a
+ * statement there when the source file is correct, so the contents before and
+ * after a boundary can be parsed separately. */
+typedef struct {
+    /* Place the scanned contents ended at. */
+    DilBoundaryState state;
+} DilBoundary;
+
+/* Find the next boundary from the first to the last, continuing from where
+ * the previous scan ended. Returns the position after the semicolon, or null
+ * if there is no boundary before the last. */
+char const*
+dil_boundary_next(DilBoundary* scanner, char const* first, char const* last)
+{
+    /* '"\'/;' */
+    static DilCharClass const SET_CODE = {
+        .bits = {0x0800808400000000, 0, 0, 0}};
+    /* '"\\' */
+    static DilCharClass const SET_STRING = {
+        .bits = {0x0000000400000000, 0x0000000010000000, 0, 0}};
+    /* '\'\\' */
+    static DilCharClass const SET_SET = {
+        .bits = {0x0000008000000000, 0x0000000010000000, 0, 0}};
+    /* '\n' */
+    static DilCharClass const SET_COMMENT = {
+        .bits = {0x0000000000000400, 0, 0, 0}};
+
+    while (first < last) {
+        switch (scanner->state) {
+            case DIL_BOUNDARY_CODE:
+                first = dil_scan_until(first, last, &SET_CODE);
+                if (first == last) {
+                    break;
+                }
+                switch (*first++) {
+                    case '"':
+                        scanner->state = DIL_BOUNDARY_STRING;
+                        break;
+                    case '\'':
+                        scanner->state = DIL_BOUNDARY_SET;
+                        break;
+                    case '/':
+                        scanner->state = DIL_BOUNDARY_SLASH;
+                        break;
+                    default:
+                        scanner->state = DIL_BOUNDARY_SEMICOLON;
+                        break;
+                }
+                break;
+            case DIL_BOUNDARY_SLASH:
+                scanner->state = DIL_BOUNDARY_CODE;
+                if (*first == '/') {
+                    scanner->state = DIL_BOUNDARY_COMMENT;
+                    first++;
+                }
+                break;
+            case DIL_BOUNDARY_SEMICOLON:
+                scanner->state = DIL_BOUNDARY_CODE;
+                if (*first == '\n') {
+                    return first;
+                }
+                break;
+            case DIL_BOUNDARY_COMMENT:
+                first = dil_scan_until(first, last, &SET_COMMENT);
+                if (first == last) {
+                    break;
+                }
+                scanner->state = DIL_BOUNDARY_CODE;
+                first++;
+                break;
+            case DIL_BOUNDARY_STRING:
+                first = dil_scan_until(first, last, &SET_STRING);
+                if (first == last) {
+                    break;
+                }
+                scanner->state = *first++ == '"' ? DIL_BOUNDARY_CODE
+                                                 : DIL_BOUNDARY_STRING_ESCAPE;
+                break;
+            case DIL_BOUNDARY_STRING_ESCAPE:
+                scanner->state = DIL_BOUNDARY_STRING;
+                first++;
+                break;
+            case DIL_BOUNDARY_SET:
+                first = dil_scan_until(first, last, &SET_SET);
+                if (first == last) {
+                    break;
+                }
+                scanner->state = *first++ == '\'' ? DIL_BOUNDARY_CODE
+                                                  : DIL_BOUNDARY_SET_ESCAPE;
+                break;
+            default:
+                scanner->state = DIL_BOUNDARY_SET;
+                first++;
+                break;
+        }
+    }
+    return NULL;
+}
+
+/* Find the last boundary from the first to the last, continuing from where
+ * the previous scan ended. Returns null if there is none. */
+char const*
+dil_boundary_last(DilBoundary* scanner, char const* first, char const* last)
+{
+    char const* result = NULL;
+    char const* found  = dil_boundary_next(scanner, first, last);
+    while (found != NULL) {
+        result = found;
+        found  = dil_boundary_next(scanner, found, last);
+    }
+    return result;
+}
@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: 2022 Cem Geçgel <gecgelcem@outlook.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "dil/memo.c"
+#include "dil/parser.c"
+#include "dil/source.c"
+#include "dil/tree.c"
+
+#include <stddef.h>
+
+/* Receiver of a parsed top level statement, whose root is the first node of
+ * the tree. The nodes are only valid during the call, and the tree must not
+ * be changed or freed. */
+typedef void (*DilParseHandler)(void* data, DilTree const* statement);
+
+/* Give the statement that was just parsed to the handler, and remove it from
+ * the tree so its memory is used for the next one. */
+void dil_parse__hand(
+    DilParseContext* context,
+    DilParseHandler  handler,
+    void*            data)
+{
+    DilNode* root      = dil_tree_start(&context->built);
+    DilTree  statement = {
+         .first     = root + 1,
+         .last      = context->built.last,
+         .allocated = context->built.last};
+    handler(data, &statement);
+
+    context->built.last = root + 1;
+    root->childeren     = 0;
+
+    // The parser does not go back before a parsed top level statement, so the
+    // memoized rules in it are not needed anymore. The counters are kept for
+    // the whole source file.
+    if (context->options.memo != NULL) {
+        dil_memo_forget(context->options.memo);
+    }
+}
+
+/* Parses the source file with the options, and gives each top level
+ * statement to the handler with the data as soon as it is parsed instead of
+ * building the whole tree. The memory stays proportional to the largest
+ * statement rather than the source file. Returns the amount of statements
+ * that were given. */
+size_t dil_parse_bounded(
+    DilSource       source,
+    DilParseOptions options,
+    DilParseHandler handler,
+    void*           data)
+{
+    DilParseContext initial = {
+        .builder   = {.built = &initial.built},
+        .remaining = source.contents,
+        .source    = source,
+        .options   = options};
+
+    if (options.memo != NULL) {
+        dil_memo_clear(options.memo);
+    }
+
+    size_t amount = 0;
+    dil_parse__open(&initial);
+    dil_parse__skip_0(&initial);
+    while (dil_parse_statement(&initial)) {
+        dil_parse__hand(&initial, handler, data);
+        amount++;
+        dil_parse__skip_0(&initial);
+    }
+    dil_parse__close(&initial);
+
+    DilTree built = dil_parse__conclude(&initial);
+    dil_tree_free(&built);
+    return amount;
+}
@@ -8,6 +8,9 @@
 #include "dil/string.c"
 #include "dil/tree.c"
 
+#include <stddef.h>
+#include <string.h>
+
 /* Tree builder. */
 typedef struct {
     /* Built tree. */
@@ -41,6 +44,16 @@ void dil_builder_add(DilBuilder* builder, DilObject object)
     dil_builder_parent(builder)->childeren++;
 }
 
+/* Add a copy of the amount of nodes, which form a single subtree, as a child
+ * to the last pushed object. */
+void dil_builder_graft(DilBuilder* builder, DilNode const* nodes, size_t amount)
+{
+    dil_tree_reserve(builder->built, amount);
+    memcpy(builder->built->last, nodes, amount * sizeof(DilNode));
+    builder->built->last += amount;
+    dil_builder_parent(builder)->childeren++;
+}
+
 /* Remove the last pushed parent and all its childeren. */
 void dil_builder_remove(DilBuilder* builder)
 {
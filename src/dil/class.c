@@ -0,0 +1,54 @@
+// SPDX-FileCopyrightText: 2022 Cem Geçgel <gecgelcem@outlook.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Set of characters with constant time membership. */
+typedef struct {
+    /* Bit of a character is at its value modulo 64 in the word at its value
+     * divided by 64. */
+    uint64_t bits[4];
+} DilCharClass;
+
+/* Whether the class contains the element. */
+bool dil_char_class_contains(DilCharClass const* set, char element)
+{
+    unsigned char value = (unsigned char)element;
+    return (set->bits[value >> 6] >> (value & 63)) & 1;
+}
+
+/* Add the element to the class. */
+void dil_char_class_add(DilCharClass* set, char element)
+{
+    unsigned char value = (unsigned char)element;
+    set->bits[value >> 6] |= (uint64_t)1 << (value & 63);
+}
+
+/* Add the elements from the first to the last, inclusive, to the class. */
+void dil_char_class_add_range(DilCharClass* set, char first, char last)
+{
+    for (unsigned value = (unsigned char)first; value <= (unsigned char)last;
+         value++) {
+        dil_char_class_add(set, (char)value);
+    }
+}
+
+/* Add the elements of the other class to the class. */
+void dil_char_class_unite(DilCharClass* set, DilCharClass const* other)
+{
+    for (size_t i = 0; i < 4; i++) {
+        set->bits[i] |= other->bits[i];
+    }
+}
+
+/* Make the class contain exactly the elements it did not contain. */
+void dil_char_class_invert(DilCharClass* set)
+{
+    for (size_t i = 0; i < 4; i++) {
+        set->bits[i] = ~set->bits[i];
+    }
+}
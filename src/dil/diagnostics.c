@@ -0,0 +1,322 @@
+// SPDX-FileCopyrightText: 2022 Cem Geçgel <gecgelcem@outlook.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "dil/source.c"
+#include "dil/string.c"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Kind of an error the parser found, which decides its message. */
+typedef enum {
+    /* Expected a skip, and skipped the characters until one. */
+    DIL_DIAGNOSTIC_SKIP,
+    /* Expected a character. */
+    DIL_DIAGNOSTIC_CHARACTER,
+    /* Expected one of the characters in a set. */
+    DIL_DIAGNOSTIC_SET,
+    /* Expected none of the characters in a set. */
+    DIL_DIAGNOSTIC_NOT_SET,
+    /* Expected a string. */
+    DIL_DIAGNOSTIC_STRING,
+    /* Expected a terminal. */
+    DIL_DIAGNOSTIC_REFERENCE,
+    /* Did not expect the character. */
+    DIL_DIAGNOSTIC_UNEXPECTED,
+    /* Could not enter a rule because of the nesting limit. */
+    DIL_DIAGNOSTIC_DEPTH,
+    /* Could not parse the characters left at the end of the file. */
+    DIL_DIAGNOSTIC_LEFT,
+    /* Stopped parsing because the budget ran out. */
+    DIL_DIAGNOSTIC_BUDGET
+} DilDiagnosticKind;
+
+/* Error the parser found, which is only formatted when it is printed. The
+ * strings are not copied, so the expected ones and the symbol must be
+ * constants, and the portion must stay in the contents of the source file. */
+typedef struct {
+    /* Kind of the error. */
+    DilDiagnosticKind kind;
+    /* Expected character if it is a character error. */
+    char character;
+    /* Nesting limit if it is a depth error. */
+    size_t limit;
+    /* Expected characters, set or terminal, or the limit that stopped the
+     * parser. */
+    DilString expected;
+    /* Name of the symbol the error is in. */
+    char const* symbol;
+    /* Erroneous characters in the source file. */
+    DilString portion;
+} DilDiagnostic;
+
+/* Contiguous, dynamicly allocated elements. */
+typedef struct {
+    /* Border before the first element. */
+    DilDiagnostic* first;
+    /* Border after the last element. */
+    DilDiagnostic* last;
+    /* Border after the last allocated element. */
+    DilDiagnostic* allocated;
+} DilDiagnostics;
+
+/* Amount of elements. */
+size_t dil_diagnostics_size(DilDiagnostics const* list)
+{
+    return list->last - list->first;
+}
+
+/* Amount of allocated elements. */
+size_t dil_diagnostics_capacity(DilDiagnostics const* list)
+{
+    return list->allocated - list->first;
+}
+
+/* Amount of allocated but unused elements. */
+size_t dil_diagnostics_space(DilDiagnostics const* list)
+{
+    return list->allocated - list->last;
+}
+
+/* Whether there are any elements. */
+bool dil_diagnostics_finite(DilDiagnostics const* list)
+{
+    return dil_diagnostics_size(list) > 0;
+}
+
+/* Pointer to the element at the index. */
+DilDiagnostic* dil_diagnostics_at(DilDiagnostics const* list, size_t index)
+{
+    return list->first + index;
+}
+
+/* Element at the index. */
+DilDiagnostic dil_diagnostics_get(DilDiagnostics const* list, size_t index)
+{
+    return *dil_diagnostics_at(list, index);
+}
+
+/* Pointer to the first element. */
+DilDiagnostic* dil_diagnostics_start(DilDiagnostics const* list)
+{
+    return list->first;
+}
+
+/* Pointer to the last element. */
+DilDiagnostic* dil_diagnostics_finish(DilDiagnostics const* list)
+{
+    return list->last - 1;
+}
+
+/* Make sure the amount of elements will fit. Grows by at least half if
+ * necessary. */
+void dil_diagnostics_reserve(DilDiagnostics* list, size_t amount)
+{
+    size_t space = dil_diagnostics_space(list);
+    if (amount <= space) {
+        return;
+    }
+
+    size_t growth       = amount - space;
+    size_t capacity     = dil_diagnostics_capacity(list);
+    size_t halfCapacity = capacity / 2;
+    if (growth < halfCapacity) {
+        growth = halfCapacity;
+    }
+
+    size_t         newCapacity = capacity + growth;
+    DilDiagnostic* memory =
+        realloc(list->first, newCapacity * sizeof(DilDiagnostic));
+
+    list->last      = memory + dil_diagnostics_size(list);
+    list->first     = memory;
+    list->allocated = memory + newCapacity;
+}
+
+/* Add the element to the end. */
+void dil_diagnostics_add(DilDiagnostics* list, DilDiagnostic element)
+{
+    dil_diagnostics_reserve(list, 1);
+    *list->last++ = element;
+}
+
+/* Open space at the index for the amount of element. Returns pointer to the
+ * first opened element. */
+DilDiagnostic*
+dil_diagnostics_open(DilDiagnostics* list, size_t index, size_t amount)
+{
+    dil_diagnostics_reserve(list, amount);
+    DilDiagnostic* position = list->first + index;
+    memmove(position + amount, position, amount * sizeof(DilDiagnostic));
+    list->last += amount;
+    return position;
+}
+
+/* Put the element to the given index. */
+void dil_diagnostics_put(
+    DilDiagnostics* list,
+    size_t          index,
+    DilDiagnostic   element)
+{
+    *dil_diagnostics_open(list, index, 1) = element;
+}
+
+/* Place the element the amount of times to the end. */
+void dil_diagnostics_place(
+    DilDiagnostics* list,
+    size_t          amount,
+    DilDiagnostic   element)
+{
+    dil_diagnostics_reserve(list, amount);
+    for (size_t i = 0; i < amount; i++) {
+        *list->last++ = element;
+    }
+}
+
+/* Remove from the end. */
+void dil_diagnostics_remove(DilDiagnostics* list)
+{
+    list->last--;
+}
+
+/* Remove from the end and return the removed element. */
+DilDiagnostic dil_diagnostics_pop(DilDiagnostics* list)
+{
+    dil_diagnostics_remove(list);
+    return *list->last;
+}
+
+/* Remove all the elements. Keeps the memory. */
+void dil_diagnostics_clear(DilDiagnostics* list)
+{
+    list->last = list->first;
+}
+
+/* Deallocate memory. */
+void dil_diagnostics_free(DilDiagnostics* list)
+{
+    free(list->first);
+    list->first     = NULL;
+    list->last      = NULL;
+    list->allocated = NULL;
+}
+
+/* Format the message of the diagnostic into the buffer of the size. */
+void dil_diagnostic_format(
+    DilDiagnostic const* diagnostic,
+    char*                buffer,
+    size_t               size)
+{
+    int         length   = (int)dil_string_size(&diagnostic->expected);
+    char const* expected = diagnostic->expected.first;
+    char const* symbol   = diagnostic->symbol;
+    switch (diagnostic->kind) {
+        case DIL_DIAGNOSTIC_CHARACTER:
+            (void)sprintf_s(
+                buffer,
+                size,
+                "Expected `%c` in `%s`!",
+                diagnostic->character,
+                symbol);
+            break;
+        case DIL_DIAGNOSTIC_SET:
+            (void)sprintf_s(
+                buffer,
+                size,
+                "Expected one of `%.*s` in `%s`!",
+                length,
+                expected,
+                symbol);
+            break;
+        case DIL_DIAGNOSTIC_NOT_SET:
+            (void)sprintf_s(
+                buffer,
+                size,
+                "Expected none of `%.*s` in `%s`!",
+                length,
+                expected,
+                symbol);
+            break;
+        case DIL_DIAGNOSTIC_UNEXPECTED:
+            (void)sprintf_s(
+                buffer,
+                size,
+                "Unexpected character in `%s`!",
+                symbol);
+            break;
+        case DIL_DIAGNOSTIC_DEPTH:
+            (void)sprintf_s(
+                buffer,
+                size,
+                "Nesting is deeper than %llu rules in `%s`!",
+                diagnostic->limit,
+                symbol);
+            break;
+        case DIL_DIAGNOSTIC_LEFT:
+            (void)sprintf_s(
+                buffer,
+                size,
+                "There are unexpected characters left in the file!");
+            break;
+        case DIL_DIAGNOSTIC_BUDGET:
+            (void)sprintf_s(
+                buffer,
+                size,
+                "Parsing was stopped by the %.*s!",
+                length,
+                expected);
+            break;
+        default:
+            (void)sprintf_s(
+                buffer,
+                size,
+                "Expected `%.*s` in `%s`!",
+                length,
+                expected,
+                symbol);
+            break;
+    }
+}
+
+/* Whether the diagnostic is in the source file. */
+bool dil_diagnostic_in(
+    DilDiagnostic const* diagnostic,
+    DilSource const*     source)
+{
+    return diagnostic->portion.first >= source->contents.first &&
+           diagnostic->portion.first <= source->contents.last;
+}
+
+/* Print the diagnostics that are in the source file, in the order they were
+ * found. Builds the line index of the source file for the duration if it
+ * does not have one. */
+void dil_diagnostics_print(
+    DilDiagnostics const* list,
+    DilSource const*      source)
+{
+    DilSource indexed = *source;
+    bool      built   = !dil_indices_finite(&source->lines);
+    if (built) {
+        indexed.lines = (DilIndices){0};
+        dil_source_index(&indexed);
+    }
+
+    size_t const BUFFER_SIZE = 1024;
+    char         buffer[BUFFER_SIZE];
+    for (DilDiagnostic const* i = list->first; i < list->last; i++) {
+        if (!dil_diagnostic_in(i, source)) {
+            continue;
+        }
+        dil_diagnostic_format(i, buffer, BUFFER_SIZE);
+        dil_source_print(&indexed, &i->portion, "error", buffer);
+    }
+
+    if (built) {
+        dil_source_free(&indexed);
+    }
+}
@@ -0,0 +1,216 @@
+// SPDX-FileCopyrightText: 2022 Cem Geçgel <gecgelcem@outlook.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "dil/class.c"
+#include "dil/string.c"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Kind of an expression in a grammar. */
+typedef enum {
+    /* Matches a single character. */
+    DIL_EXPRESSION_CHARACTER,
+    /* Matches a character in a set. */
+    DIL_EXPRESSION_SET,
+    /* Matches a character that is not in a set. */
+    DIL_EXPRESSION_NOT_SET,
+    /* Matches the characters of a string. */
+    DIL_EXPRESSION_STRING,
+    /* Matches a rule. */
+    DIL_EXPRESSION_REFERENCE,
+    /* Matches the childeren one after the other. */
+    DIL_EXPRESSION_SEQUENCE,
+    /* Matches the first child that matches. */
+    DIL_EXPRESSION_CHOICE,
+    /* Matches the child or nothing. */
+    DIL_EXPRESSION_OPTIONAL,
+    /* Matches the child as many times as possible. */
+    DIL_EXPRESSION_ZERO_OR_MORE,
+    /* Matches the child at least once, and then as many times as
+     * possible. */
+    DIL_EXPRESSION_ONE_OR_MORE,
+    /* Matches the child a fixed amount of times. */
+    DIL_EXPRESSION_FIXED_TIMES
+} DilExpressionKind;
+
+/* Part of a pattern in a grammar. */
+typedef struct {
+    /* Kind of the expression. */
+    DilExpressionKind kind;
+    /* Characters in the grammar the expression was read from. */
+    DilString source;
+    /* Characters the expression matches if it is a character, a set or a
+     * not set. */
+    DilCharClass set;
+    /* Matched character if it is a character. */
+    char character;
+    /* Index of the decoded string, or the characters of the set in the order
+     * they were written, in the texts of the grammar. */
+    size_t text;
+    /* Amount of characters in the text. */
+    size_t length;
+    /* Index of the rule if it is a reference. */
+    size_t rule;
+    /* Amount of times the child is matched if it is a fixed times. */
+    size_t times;
+    /* Index of the first child in the childeren of the grammar. */
+    size_t first;
+    /* Amount of childeren. */
+    size_t amount;
+} DilExpression;
+
+/* Contiguous, dynamicly allocated elements. */
+typedef struct {
+    /* Border before the first element. */
+    DilExpression* first;
+    /* Border after the last element. */
+    DilExpression* last;
+    /* Border after the last allocated element. */
+    DilExpression* allocated;
+} DilExpressions;
+
+/* Amount of elements. */
+size_t dil_expressions_size(DilExpressions const* list)
+{
+    return list->last - list->first;
+}
+
+/* Amount of allocated elements. */
+size_t dil_expressions_capacity(DilExpressions const* list)
+{
+    return list->allocated - list->first;
+}
+
+/* Amount of allocated but unused elements. */
+size_t dil_expressions_space(DilExpressions const* list)
+{
+    return list->allocated - list->last;
+}
+
+/* Whether there are any elements. */
+bool dil_expressions_finite(DilExpressions const* list)
+{
+    return dil_expressions_size(list) > 0;
+}
+
+/* Pointer to the element at the index. */
+DilExpression* dil_expressions_at(DilExpressions const* list, size_t index)
+{
+    return list->first + index;
+}
+
+/* Element at the index. */
+DilExpression dil_expressions_get(DilExpressions const* list, size_t index)
+{
+    return *dil_expressions_at(list, index);
+}
+
+/* Pointer to the first element. */
+DilExpression* dil_expressions_start(DilExpressions const* list)
+{
+    return list->first;
+}
+
+/* Pointer to the last element. */
+DilExpression* dil_expressions_finish(DilExpressions const* list)
+{
+    return list->last - 1;
+}
+
+/* Make sure the amount of elements will fit. Grows by at least half if
+ * necessary. */
+void dil_expressions_reserve(DilExpressions* list, size_t amount)
+{
+    size_t space = dil_expressions_space(list);
+    if (amount <= space) {
+        return;
+    }
+
+    size_t growth       = amount - space;
+    size_t capacity     = dil_expressions_capacity(list);
+    size_t halfCapacity = capacity / 2;
+    if (growth < halfCapacity) {
+        growth = halfCapacity;
+    }
+
+    size_t         newCapacity = capacity + growth;
+    DilExpression* memory =
+        realloc(list->first, newCapacity * sizeof(DilExpression));
+
+    list->last      = memory + dil_expressions_size(list);
+    list->first     = memory;
+    list->allocated = memory + newCapacity;
+}
+
+/* Add the element to the end. */
+void dil_expressions_add(DilExpressions* list, DilExpression element)
+{
+    dil_expressions_reserve(list, 1);
+    *list->last++ = element;
+}
+
+/* Open space at the index for the amount of element. Returns pointer to the
+ * first opened element. */
+DilExpression*
+dil_expressions_open(DilExpressions* list, size_t index, size_t amount)
+{
+    dil_expressions_reserve(list, amount);
+    DilExpression* position = list->first + index;
+    memmove(position + amount, position, amount * sizeof(DilExpression));
+    list->last += amount;
+    return position;
+}
+
+/* Put the element to the given index. */
+void dil_expressions_put(
+    DilExpressions* list,
+    size_t          index,
+    DilExpression   element)
+{
+    *dil_expressions_open(list, index, 1) = element;
+}
+
+/* Place the element the amount of times to the end. */
+void dil_expressions_place(
+    DilExpressions* list,
+    size_t          amount,
+    DilExpression   element)
+{
+    dil_expressions_reserve(list, amount);
+    for (size_t i = 0; i < amount; i++) {
+        *list->last++ = element;
+    }
+}
+
+/* Remove from the end. */
+void dil_expressions_remove(DilExpressions* list)
+{
+    list->last--;
+}
+
+/* Remove from the end and return the removed element. */
+DilExpression dil_expressions_pop(DilExpressions* list)
+{
+    dil_expressions_remove(list);
+    return *list->last;
+}
+
+/* Remove all the elements. Keeps the memory. */
+void dil_expressions_clear(DilExpressions* list)
+{
+    list->last = list->first;
+}
+
+/* Deallocate memory. */
+void dil_expressions_free(DilExpressions* list)
+{
+    free(list->first);
+    list->first     = NULL;
+    list->last      = NULL;
+    list->allocated = NULL;
+}
@@ -0,0 +1,165 @@
+// SPDX-FileCopyrightText: 2022 Cem Geçgel <gecgelcem@outlook.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "dil/object.c"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Rule that is being parsed by the iterative parser. */
+typedef struct {
+    /* Symbol of the rule. */
+    DilSymbol symbol;
+    /* Point in the rule to continue from after the called rule returns. */
+    unsigned state;
+    /* Alternatives that can start with the character the rule started at, if
+     * the rule is an ordered choice. */
+    unsigned viable;
+} DilFrame;
+
+/* Contiguous, dynamicly allocated elements. */
+typedef struct {
+    /* Border before the first element. */
+    DilFrame* first;
+    /* Border after the last element. */
+    DilFrame* last;
+    /* Border after the last allocated element. */
+    DilFrame* allocated;
+} DilFrames;
+
+/* Amount of elements. */
+size_t dil_frames_size(DilFrames const* list)
+{
+    return list->last - list->first;
+}
+
+/* Amount of allocated elements. */
+size_t dil_frames_capacity(DilFrames const* list)
+{
+    return list->allocated - list->first;
+}
+
+/* Amount of allocated but unused elements. */
+size_t dil_frames_space(DilFrames const* list)
+{
+    return list->allocated - list->last;
+}
+
+/* Whether there are any elements. */
+bool dil_frames_finite(DilFrames const* list)
+{
+    return dil_frames_size(list) > 0;
+}
+
+/* Pointer to the element at the index. */
+DilFrame* dil_frames_at(DilFrames const* list, size_t index)
+{
+    return list->first + index;
+}
+
+/* Element at the index. */
+DilFrame dil_frames_get(DilFrames const* list, size_t index)
+{
+    return *dil_frames_at(list, index);
+}
+
+/* Pointer to the first element. */
+DilFrame* dil_frames_start(DilFrames const* list)
+{
+    return list->first;
+}
+
+/* Pointer to the last element. */
+DilFrame* dil_frames_finish(DilFrames const* list)
+{
+    return list->last - 1;
+}
+
+/* Make sure the amount of elements will fit. Grows by at least half if
+ * necessary. */
+void dil_frames_reserve(DilFrames* list, size_t amount)
+{
+    size_t space = dil_frames_space(list);
+    if (amount <= space) {
+        return;
+    }
+
+    size_t growth       = amount - space;
+    size_t capacity     = dil_frames_capacity(list);
+    size_t halfCapacity = capacity / 2;
+    if (growth < halfCapacity) {
+        growth = halfCapacity;
+    }
+
+    size_t    newCapacity = capacity + growth;
+    DilFrame* memory = realloc(list->first, newCapacity * sizeof(DilFrame));
+
+    list->last      = memory + dil_frames_size(list);
+    list->first     = memory;
+    list->allocated = memory + newCapacity;
+}
+
+/* Add the element to the end. */
+void dil_frames_add(DilFrames* list, DilFrame element)
+{
+    dil_frames_reserve(list, 1);
+    *list->last++ = element;
+}
+
+/* Open space at the index for the amount of element. Returns pointer to the
+ * first opened element. */
+DilFrame* dil_frames_open(DilFrames* list, size_t index, size_t amount)
+{
+    dil_frames_reserve(list, amount);
+    DilFrame* position = list->first + index;
+    memmove(position + amount, position, amount * sizeof(DilFrame));
+    list->last += amount;
+    return position;
+}
+
+/* Put the element to the given index. */
+void dil_frames_put(DilFrames* list, size_t index, DilFrame element)
+{
+    *dil_frames_open(list, index, 1) = element;
+}
+
+/* Place the element the amount of times to the end. */
+void dil_frames_place(DilFrames* list, size_t amount, DilFrame element)
+{
+    dil_frames_reserve(list, amount);
+    for (size_t i = 0; i < amount; i++) {
+        *list->last++ = element;
+    }
+}
+
+/* Remove from the end. */
+void dil_frames_remove(DilFrames* list)
+{
+    list->last--;
+}
+
+/* Remove from the end and return the removed element. */
+DilFrame dil_frames_pop(DilFrames* list)
+{
+    dil_frames_remove(list);
+    return *list->last;
+}
+
+/* Remove all the elements. Keeps the memory. */
+void dil_frames_clear(DilFrames* list)
+{
+    list->last = list->first;
+}
+
+/* Deallocate memory. */
+void dil_frames_free(DilFrames* list)
+{
+    free(list->first);
+    list->first     = NULL;
+    list->last      = NULL;
+    list->allocated = NULL;
+}
@@ -3,7 +3,2170 @@
 
 #pragma once
 
+#include "dil/analysis.c"
+#include "dil/automaton.c"
+#include "dil/backtracking.c"
 #include "dil/buffer.c"
+#include "dil/class.c"
+#include "dil/expressions.c"
+#include "dil/grammar.c"
+#include "dil/indices.c"
+#include "dil/recall.c"
+#include "dil/rules.c"
+#include "dil/string.c"
 #include "dil/tree.c"
 
-void dil_generate(DilBuffer* buffer, DilTree const* tree) {}
+#include <ctype.h>
+#include <limits.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Options of generating a parser. */
+typedef struct {
+    /* Prefix of the names in the generated parser in snake case, which is
+     * `generated` if it is null. Must not be `dil`, since the generated
+     * parser includes the runtime. */
+    char const* prefix;
+    /* Stream to print the sizes of the generated tables to, or null to
+     * generate quietly. */
+    FILE* report;
+    /* Whether every rule keeps its node, so the tree is the same as the one
+     * of `dil_parse` for the grammar of dil. Otherwise, the rules that only
+     * pass through to others are collapsed. */
+    bool exact;
+    /* Names of the rules that keep their node even if they pass through,
+     * which end with a null, or null. */
+    char const* const* kept;
+    /* Whether `<prefix>_parse_events` is generated as well, which calls
+     * callbacks instead of building the tree. */
+    bool events;
+} DilGenerateOptions;
+
+/* Maximum amount of alternatives a lookahead table has a bit for. */
+#define DIL_GENERATE_ALTERNATIVES (sizeof(unsigned short) * CHAR_BIT)
+
+/* What the generated code does when an expression does not match. */
+typedef enum {
+    /* Reject the rule. */
+    DIL_GENERATE_REJECT,
+    /* Break out of the enclosing loop. */
+    DIL_GENERATE_BREAK,
+    /* Report the expected expression and accept the rule. */
+    DIL_GENERATE_REPORT
+} DilGenerateFailure;
+
+/* Forms of a rule name in the generated code. */
+typedef enum {
+    /* Snake case, which is used in the names of functions. */
+    DIL_GENERATE_FUNCTION,
+    /* Upper snake case, which is used in the names of symbols. */
+    DIL_GENERATE_SYMBOL,
+    /* Lower case words, which are used in documentation. */
+    DIL_GENERATE_WORDS,
+    /* Capitalized words, which are used when printing the tree. */
+    DIL_GENERATE_TITLE,
+    /* Amount of forms. */
+    DIL_GENERATE_FORMS
+} DilGenerateForm;
+
+/* Parser that is being generated. */
+typedef struct {
+    /* Generated code. */
+    DilBuffer* buffer;
+    /* Grammar the code is generated from. */
+    DilGrammar const* grammar;
+    /* Prefix of the names in snake case. */
+    char const* prefix;
+    /* Prefix in upper snake case. */
+    DilBuffer upper;
+    /* Prefix in pascal case. */
+    DilBuffer pascal;
+    /* Forms of the rule names, which are null terminated. */
+    DilBuffer names;
+    /* Index of each form of each rule name in the names. */
+    DilIndices forms;
+    /* Current indentation level. */
+    size_t indentation;
+    /* Function that is being generated, which is a rule or a pattern that
+     * decides whether the rule is skipped. */
+    DilRule const* current;
+    /* Whether the current function is a rule, which has a node. */
+    bool node;
+    /* Name of the current function in the errors. */
+    char const* symbol;
+    /* Index of the constant of each expression in the current function. */
+    DilIndices constants;
+    /* Expressions whose sets are the constants of the current function. */
+    DilIndices sets;
+    /* Expressions whose strings are the constants of the current
+     * function. */
+    DilIndices strings;
+    /* Amount of flags in the current function. */
+    size_t flags;
+    /* Amount of lookahead tables in the current function. */
+    size_t tables;
+    /* Whether each rule is collapsed, which is one if it does not create a
+     * node since it only passes through to other rules. */
+    DilIndices collapsed;
+    /* Amount of nodes a test in the current function counts as collapsed
+     * when it is accepted, which is one in a collapsed rule. */
+    size_t collapsing;
+    /* How each rule remembers the offsets it was rejected at. */
+    DilIndices recalls;
+    /* Amount of rules that remember the offsets they were rejected at. */
+    size_t recalled;
+    /* Characters around the expressions of the grammar. */
+    DilAnalysis analysis;
+    /* Stream to print the sizes of the tables to, or null. */
+    FILE* report;
+} DilGenerator;
+
+/* Add the formatted text. */
+void dil_generate__print(DilGenerator* generator, char const* format, ...)
+{
+    va_list arguments;
+    va_start(arguments, format);
+    va_list copy;
+    va_copy(copy, arguments);
+    int size = vsnprintf(NULL, 0, format, copy);
+    va_end(copy);
+
+    dil_buffer_reserve(generator->buffer, (size_t)size + 1);
+    (void)vsnprintf(
+        generator->buffer->last,
+        (size_t)size + 1,
+        format,
+        arguments);
+    generator->buffer->last += size;
+    va_end(arguments);
+}
+
+/* Add the indentation of the current level. */
+void dil_generate__indent(DilGenerator* generator)
+{
+    dil_buffer_place(generator->buffer, generator->indentation * 4, ' ');
+}
+
+/* Add the formatted text as a line at the current level. */
+void dil_generate__line(DilGenerator* generator, char const* format, ...)
+{
+    if (*format != 0) {
+        dil_generate__indent(generator);
+    }
+
+    va_list arguments;
+    va_start(arguments, format);
+    va_list copy;
+    va_copy(copy, arguments);
+    int size = vsnprintf(NULL, 0, format, copy);
+    va_end(copy);
+
+    dil_buffer_reserve(generator->buffer, (size_t)size + 2);
+    (void)vsnprintf(
+        generator->buffer->last,
+        (size_t)size + 1,
+        format,
+        arguments);
+    generator->buffer->last += size;
+    dil_buffer_add(generator->buffer, '\n');
+    va_end(arguments);
+}
+
+/* Add the line and go in a level. */
+void dil_generate__open(DilGenerator* generator, char const* line)
+{
+    dil_generate__line(generator, "%s", line);
+    generator->indentation++;
+}
+
+/* Go out a level and add the line. */
+void dil_generate__close(DilGenerator* generator, char const* line)
+{
+    generator->indentation--;
+    dil_generate__line(generator, "%s", line);
+}
+
+/* Add the character escaped for a C literal with the quote. */
+void dil_generate__escape(DilGenerator* generator, char character, char quote)
+{
+    switch (character) {
+        case '\\':
+            dil_generate__print(generator, "\\\\");
+            return;
+        case '\n':
+            dil_generate__print(generator, "\\n");
+            return;
+        case '\t':
+            dil_generate__print(generator, "\\t");
+            return;
+        default:
+            break;
+    }
+    if (character == quote) {
+        dil_generate__print(generator, "\\%c", character);
+    } else if (character >= ' ' && character <= '~') {
+        dil_buffer_add(generator->buffer, character);
+    } else {
+        dil_generate__print(generator, "\\%03o", (unsigned char)character);
+    }
+}
+
+/* Add the characters as a C string literal. */
+void dil_generate__literal(DilGenerator* generator, DilString const* text)
+{
+    dil_buffer_add(generator->buffer, '"');
+    for (char const* i = text->first; i < text->last; i++) {
+        dil_generate__escape(generator, *i, '"');
+    }
+    dil_buffer_add(generator->buffer, '"');
+}
+
+/* Add the character as a C character literal. */
+void dil_generate__character(DilGenerator* generator, char character)
+{
+    dil_buffer_add(generator->buffer, '\'');
+    dil_generate__escape(generator, character, '\'');
+    dil_buffer_add(generator->buffer, '\'');
+}
+
+/* Add the form of the name, which splits the words before the capitals. */
+void dil_generate__convert(
+    DilBuffer*       buffer,
+    DilString const* name,
+    DilGenerateForm  form)
+{
+    for (char const* i = name->first; i < name->last; i++) {
+        bool capital = *i >= 'A' && *i <= 'Z';
+        if (capital && i != name->first) {
+            bool spaced = form == DIL_GENERATE_WORDS ||
+                          form == DIL_GENERATE_TITLE;
+            dil_buffer_add(buffer, spaced ? ' ' : '_');
+        }
+        switch (form) {
+            case DIL_GENERATE_SYMBOL:
+                dil_buffer_add(buffer, (char)toupper((unsigned char)*i));
+                break;
+            case DIL_GENERATE_TITLE:
+                dil_buffer_add(buffer, *i);
+                break;
+            default:
+                dil_buffer_add(buffer, (char)tolower((unsigned char)*i));
+                break;
+        }
+    }
+    dil_buffer_add(buffer, 0);
+}
+
+/* Form of the name of the rule. */
+char const* dil_generate__name(
+    DilGenerator const* generator,
+    size_t              rule,
+    DilGenerateForm     form)
+{
+    return generator->names.first +
+           dil_indices_get(&generator->forms, rule * DIL_GENERATE_FORMS + form);
+}
+
+/* Convert the prefix and the names of the rules. */
+void dil_generate__names(DilGenerator* generator)
+{
+    bool next = true;
+    for (char const* i = generator->prefix; *i != 0; i++) {
+        dil_buffer_add(&generator->upper, (char)toupper((unsigned char)*i));
+        if (*i == '_') {
+            next = true;
+            continue;
+        }
+        dil_buffer_add(
+            &generator->pascal,
+            next ? (char)toupper((unsigned char)*i) : *i);
+        next = false;
+    }
+    dil_buffer_add(&generator->upper, 0);
+    dil_buffer_add(&generator->pascal, 0);
+
+    DilRules const* rules = &generator->grammar->rules;
+    for (size_t i = 0; i < dil_rules_size(rules); i++) {
+        for (int form = 0; form < DIL_GENERATE_FORMS; form++) {
+            dil_indices_add(
+                &generator->forms,
+                dil_buffer_size(&generator->names));
+            dil_generate__convert(
+                &generator->names,
+                &dil_rules_at(rules, i)->name,
+                form);
+        }
+    }
+}
+
+/* Expression at the index. */
+DilExpression const*
+dil_generate__at(DilGenerator const* generator, size_t index)
+{
+    return dil_grammar_at(generator->grammar, index);
+}
+
+/* Child of the expression at the index. */
+DilExpression const* dil_generate__child(
+    DilGenerator const*  generator,
+    DilExpression const* expression,
+    size_t               index)
+{
+    return dil_generate__at(
+        generator,
+        dil_grammar_child(generator->grammar, expression, index));
+}
+
+/* Whether the expression is tested with a single call. */
+bool dil_generate__simple(DilExpression const* expression)
+{
+    return expression->kind <= DIL_EXPRESSION_REFERENCE;
+}
+
+/* Whether the expression matches a single character. */
+bool dil_generate__single(DilExpression const* expression)
+{
+    return expression->kind <= DIL_EXPRESSION_NOT_SET;
+}
+
+/* Whether the expression matches, possibly nothing, without failing. */
+bool dil_generate__optional(DilExpression const* expression)
+{
+    return expression->kind == DIL_EXPRESSION_OPTIONAL ||
+           expression->kind == DIL_EXPRESSION_ZERO_OR_MORE;
+}
+
+/* Whether the repetition of the expression is parsed as a run of
+ * characters. */
+bool dil_generate__run(
+    DilGenerator const*  generator,
+    DilExpression const* expression)
+{
+    return !generator->current->skipped && dil_generate__single(expression);
+}
+
+/* Whether the expression is a sequence whose first element can match
+ * nothing, but not all of them can. It is decided on its first characters
+ * before the elements, since the first element cannot reject it. */
+bool dil_generate__leads(
+    DilGenerator const*  generator,
+    DilExpression const* expression)
+{
+    if (expression->kind != DIL_EXPRESSION_SEQUENCE) {
+        return false;
+    }
+    size_t index = expression - generator->grammar->expressions.first;
+    size_t first = dil_grammar_child(generator->grammar, expression, 0);
+    return dil_analysis_at(&generator->analysis, first)->vacuous &&
+           !dil_analysis_at(&generator->analysis, index)->vacuous;
+}
+
+/* Head of the expression, which is the simple expression it starts with, or
+ * null if it does not start with one. */
+DilExpression const* dil_generate__head(
+    DilGenerator const*  generator,
+    DilExpression const* expression)
+{
+    if (dil_generate__simple(expression)) {
+        return expression;
+    }
+    switch (expression->kind) {
+        case DIL_EXPRESSION_SEQUENCE:
+        case DIL_EXPRESSION_ONE_OR_MORE:
+        case DIL_EXPRESSION_FIXED_TIMES: {
+            DilExpression const* first =
+                dil_generate__child(generator, expression, 0);
+            return dil_generate__simple(first) ? first : NULL;
+        }
+        default:
+            return NULL;
+    }
+}
+
+/* Set of the expression, which is the first characters of a sequence that
+ * is decided on them. */
+DilCharClass const* dil_generate__class_of(
+    DilGenerator const* generator,
+    size_t              index)
+{
+    DilExpression const* expression = dil_generate__at(generator, index);
+    if (expression->kind == DIL_EXPRESSION_SEQUENCE) {
+        return &dil_analysis_at(&generator->analysis, index)->first;
+    }
+    return &expression->set;
+}
+
+/* Give the expression a set constant, which is shared with the equal
+ * sets. */
+void dil_generate__set(DilGenerator* generator, size_t index)
+{
+    DilCharClass const* set      = dil_generate__class_of(generator, index);
+    size_t              constant = 0;
+    for (; constant < dil_indices_size(&generator->sets); constant++) {
+        DilCharClass const* other = dil_generate__class_of(
+            generator,
+            dil_indices_get(&generator->sets, constant));
+        if (memcmp(other, set, sizeof(DilCharClass)) == 0) {
+            break;
+        }
+    }
+    if (constant == dil_indices_size(&generator->sets)) {
+        dil_indices_add(&generator->sets, index);
+    }
+    *dil_indices_at(&generator->constants, index) = constant;
+}
+
+/* Give the expression a string constant, which is shared with the equal
+ * strings. */
+void dil_generate__string(DilGenerator* generator, size_t index)
+{
+    DilExpression const* expression = dil_generate__at(generator, index);
+    DilString text = dil_grammar_text(generator->grammar, expression);
+    size_t    constant = 0;
+    for (; constant < dil_indices_size(&generator->strings); constant++) {
+        DilExpression const* other = dil_generate__at(
+            generator,
+            dil_indices_get(&generator->strings, constant));
+        DilString otherText = dil_grammar_text(generator->grammar, other);
+        if (dil_string_equal(&otherText, &text)) {
+            break;
+        }
+    }
+    if (constant == dil_indices_size(&generator->strings)) {
+        dil_indices_add(&generator->strings, index);
+    }
+    *dil_indices_at(&generator->constants, index) = constant;
+}
+
+/* Give constants to the expression and its childeren. */
+void dil_generate__collect(DilGenerator* generator, size_t index)
+{
+    DilExpression const* expression = dil_generate__at(generator, index);
+    switch (expression->kind) {
+        case DIL_EXPRESSION_SET:
+        case DIL_EXPRESSION_NOT_SET:
+            dil_generate__set(generator, index);
+            return;
+        case DIL_EXPRESSION_STRING:
+            dil_generate__string(generator, index);
+            return;
+        case DIL_EXPRESSION_SEQUENCE:
+            if (dil_generate__leads(generator, expression)) {
+                dil_generate__set(generator, index);
+            }
+            break;
+        case DIL_EXPRESSION_ZERO_OR_MORE: {
+            size_t               child = dil_grammar_child(
+                generator->grammar,
+                expression,
+                0);
+            DilExpression const* inner = dil_generate__at(generator, child);
+            if (dil_generate__run(generator, inner) &&
+                inner->kind == DIL_EXPRESSION_CHARACTER) {
+                dil_generate__set(generator, child);
+                return;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    for (size_t i = 0; i < expression->amount; i++) {
+        dil_generate__collect(
+            generator,
+            dil_grammar_child(generator->grammar, expression, i));
+    }
+}
+
+/* Add the comment of the set, which is its source in the grammar. */
+void dil_generate__comment(
+    DilGenerator*        generator,
+    DilExpression const* expression)
+{
+    dil_generate__indent(generator);
+    dil_generate__print(generator, "/* ");
+    for (char const* i = expression->source.first; i < expression->source.last;
+         i++) {
+        dil_buffer_add(generator->buffer, *i);
+        // Keep the comment from ending early.
+        if (*i == '*' && i + 1 < expression->source.last && i[1] == '/') {
+            dil_buffer_add(generator->buffer, ' ');
+        }
+    }
+    dil_generate__print(generator, " */\n");
+}
+
+/* Add the definition of the class. */
+void dil_generate__class(
+    DilGenerator*       generator,
+    char const*         name,
+    DilCharClass const* set)
+{
+    dil_generate__line(generator, "static DilCharClass const %s = {", name);
+    generator->indentation++;
+    size_t used = 0;
+    for (size_t i = 0; i < 4; i++) {
+        used += set->bits[i] != 0;
+    }
+    // Put the words to separate lines if they would not fit to a line.
+    bool        wrapped   = used > 2;
+    char const* separator = wrapped ? ",\n" : ", ";
+    dil_generate__indent(generator);
+    dil_generate__print(generator, wrapped ? ".bits =\n" : ".bits = {");
+    for (size_t i = 0; i < 4; i++) {
+        if (wrapped) {
+            dil_generate__indent(generator);
+            dil_generate__print(generator, i == 0 ? "    {" : "     ");
+        } else if (i != 0) {
+            dil_generate__print(generator, "%s", separator);
+        }
+        if (set->bits[i] == 0) {
+            dil_generate__print(generator, "0");
+        } else {
+            dil_generate__print(
+                generator,
+                "0x%016llX",
+                (unsigned long long)set->bits[i]);
+        }
+        if (wrapped && i != 3) {
+            dil_generate__print(generator, "%s", separator);
+        }
+    }
+    dil_generate__print(generator, "}};\n");
+    generator->indentation--;
+}
+
+/* Add the constants of the current function. */
+void dil_generate__constants(DilGenerator* generator)
+{
+    for (size_t i = 0; i < dil_indices_size(&generator->strings); i++) {
+        DilExpression const* expression = dil_generate__at(
+            generator,
+            dil_indices_get(&generator->strings, i));
+        DilString text = dil_grammar_text(generator->grammar, expression);
+        dil_generate__indent(generator);
+        dil_generate__print(
+            generator,
+            "static char const      STRING_%llu[]  = ",
+            i);
+        dil_generate__literal(generator, &text);
+        dil_generate__print(generator, ";\n");
+        dil_generate__line(
+            generator,
+            "static DilString const TERMINALS_%llu = {",
+            i);
+        generator->indentation++;
+        dil_generate__line(generator, ".first = STRING_%llu,", i);
+        dil_generate__line(
+            generator,
+            ".last  = STRING_%llu + sizeof(STRING_%llu) - 1};",
+            i,
+            i);
+        generator->indentation--;
+    }
+    for (size_t i = 0; i < dil_indices_size(&generator->sets); i++) {
+        size_t index = dil_indices_get(&generator->sets, i);
+        char   name[32];
+        (void)sprintf_s(name, sizeof(name), "SET_%llu", i);
+        dil_generate__comment(generator, dil_generate__at(generator, index));
+        dil_generate__class(
+            generator,
+            name,
+            dil_generate__class_of(generator, index));
+    }
+    if (dil_indices_finite(&generator->strings) ||
+        dil_indices_finite(&generator->sets)) {
+        dil_generate__line(generator, "");
+    }
+}
+
+/* Constant of the expression. */
+size_t dil_generate__constant(
+    DilGenerator const*  generator,
+    DilExpression const* expression)
+{
+    size_t index = expression - generator->grammar->expressions.first;
+    return dil_indices_get(&generator->constants, index);
+}
+
+/* Whether the pattern only passes through to other rules, which is a
+ * reference or a choice of references. */
+bool dil_generate__passes(DilGenerator const* generator, size_t pattern)
+{
+    DilExpression const* expression = dil_generate__at(generator, pattern);
+    if (expression->kind != DIL_EXPRESSION_CHOICE) {
+        return expression->kind == DIL_EXPRESSION_REFERENCE;
+    }
+    for (size_t i = 0; i < expression->amount; i++) {
+        if (dil_generate__child(generator, expression, i)->kind !=
+            DIL_EXPRESSION_REFERENCE) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Rule that is called for a reference to the rule. Follows the collapsed
+ * rules that pass through to a single rule, and adds the amount of them to
+ * the hops. */
+size_t dil_generate__resolve(
+    DilGenerator const* generator,
+    size_t              rule,
+    size_t*             hops)
+{
+    DilRules const* rules = &generator->grammar->rules;
+    for (size_t i = 0; i < dil_rules_size(rules); i++) {
+        DilExpression const* pattern =
+            dil_generate__at(generator, dil_rules_at(rules, rule)->pattern);
+        if (dil_indices_get(&generator->collapsed, rule) == 0 ||
+            pattern->kind != DIL_EXPRESSION_REFERENCE) {
+            break;
+        }
+        rule = pattern->rule;
+        (*hops)++;
+    }
+    return rule;
+}
+
+/* Add the call that tests the simple expression. */
+void dil_generate__test(
+    DilGenerator*        generator,
+    DilExpression const* expression)
+{
+    size_t constant = dil_generate__constant(generator, expression);
+    switch (expression->kind) {
+        case DIL_EXPRESSION_CHARACTER:
+            dil_generate__print(generator, "dil_parse__character(context, ");
+            dil_generate__character(generator, expression->character);
+            dil_generate__print(generator, ")");
+            break;
+        case DIL_EXPRESSION_SET:
+            dil_generate__print(
+                generator,
+                "dil_parse__set(context, &SET_%llu)",
+                constant);
+            break;
+        case DIL_EXPRESSION_NOT_SET:
+            dil_generate__print(
+                generator,
+                "dil_parse__not_set(context, &SET_%llu)",
+                constant);
+            break;
+        case DIL_EXPRESSION_STRING:
+            dil_generate__print(
+                generator,
+                "dil_parse__string(context, &TERMINALS_%llu)",
+                constant);
+            break;
+        default: {
+            size_t hops   = generator->collapsing;
+            size_t target = dil_generate__resolve(
+                generator,
+                expression->rule,
+                &hops);
+            if (hops != 0) {
+                dil_generate__print(
+                    generator,
+                    "dil_parse__collapse(context, %llu, ",
+                    hops);
+            }
+            dil_generate__print(
+                generator,
+                "%s_parse_%s(context)%s",
+                generator->prefix,
+                dil_generate__name(generator, target, DIL_GENERATE_FUNCTION),
+                hops != 0 ? ")" : "");
+            break;
+        }
+    }
+}
+
+/* Add a line that starts with the text, tests the expression, and ends with
+ * the other text. */
+void dil_generate__condition(
+    DilGenerator*        generator,
+    char const*          start,
+    DilExpression const* expression,
+    char const*          end)
+{
+    dil_generate__indent(generator);
+    dil_generate__print(generator, "%s", start);
+    dil_generate__test(generator, expression);
+    dil_generate__print(generator, "%s\n", end);
+}
+
+/* Add the skip between the elements if the current function skips. */
+void dil_generate__skip(DilGenerator* generator)
+{
+    DilRule const* current = generator->current;
+    if (current->skipped) {
+        dil_generate__line(
+            generator,
+            "%s_parse__skip_%llu(context);",
+            generator->prefix,
+            current->skip);
+    }
+}
+
+/* Add the report of the error that the expression is expected. */
+void dil_generate__report(
+    DilGenerator*        generator,
+    DilExpression const* expression)
+{
+    DilExpression const* head   = dil_generate__head(generator, expression);
+    char const*          symbol = generator->symbol;
+    if (head == NULL || expression->kind == DIL_EXPRESSION_CHOICE) {
+        dil_generate__line(
+            generator,
+            "dil_parse__error_unexpected(context, \"%s\");",
+            symbol);
+        return;
+    }
+
+    DilString text = dil_grammar_text(generator->grammar, head);
+    switch (head->kind) {
+        case DIL_EXPRESSION_CHARACTER:
+            dil_generate__indent(generator);
+            dil_generate__print(
+                generator,
+                "dil_parse__error_character(context, ");
+            dil_generate__character(generator, head->character);
+            dil_generate__print(generator, ", \"%s\");\n", symbol);
+            break;
+        case DIL_EXPRESSION_SET:
+        case DIL_EXPRESSION_NOT_SET:
+            dil_generate__line(
+                generator,
+                head->kind == DIL_EXPRESSION_SET ? "dil_parse__error_set("
+                                                 : "dil_parse__error_not_set(");
+            generator->indentation++;
+            dil_generate__line(generator, "context,");
+            dil_generate__indent(generator);
+            dil_generate__literal(generator, &text);
+            dil_generate__print(generator, ",\n");
+            dil_generate__line(generator, "\"%s\");", symbol);
+            generator->indentation--;
+            break;
+        case DIL_EXPRESSION_STRING:
+            dil_generate__line(
+                generator,
+                "dil_parse__error_string(context, &TERMINALS_%llu, \"%s\");",
+                dil_generate__constant(generator, head),
+                symbol);
+            break;
+        default: {
+            DilRule const* rule = dil_rules_at(
+                &generator->grammar->rules,
+                head->rule);
+            int            size = (int)dil_string_size(&rule->name);
+            if (!generator->current->skipped) {
+                dil_generate__line(
+                    generator,
+                    "dil_parse__error_reference(context, \"%.*s\", \"%s\");",
+                    size,
+                    rule->name.first,
+                    symbol);
+                break;
+            }
+            size_t skip = generator->current->skip;
+            dil_generate__line(generator, "dil_parse__error_skip(");
+            generator->indentation++;
+            dil_generate__line(generator, "context,");
+            dil_generate__line(
+                generator,
+                "&%s_parse__skip_%llu_once,",
+                generator->prefix,
+                skip);
+            dil_generate__line(
+                generator,
+                "%s_parse__skip_%llu_first(),",
+                generator->prefix,
+                skip);
+            dil_generate__line(
+                generator,
+                "\"%.*s\",",
+                size,
+                rule->name.first);
+            dil_generate__line(generator, "\"%s\");", symbol);
+            generator->indentation--;
+            break;
+        }
+    }
+}
+
+/* Add the statements of the failure. */
+void dil_generate__fail(
+    DilGenerator*        generator,
+    DilGenerateFailure   failure,
+    DilExpression const* expression)
+{
+    switch (failure) {
+        case DIL_GENERATE_REJECT:
+            dil_generate__line(
+                generator,
+                generator->node ? "return dil_parse__return(context, false);"
+                                : "return false;");
+            break;
+        case DIL_GENERATE_BREAK:
+            dil_generate__line(generator, "break;");
+            break;
+        default:
+            dil_generate__report(generator, expression);
+            dil_generate__line(
+                generator,
+                generator->node ? "return dil_parse__return(context, true);"
+                                : "return true;");
+            break;
+    }
+}
+
+void dil_generate__match(
+    DilGenerator*        generator,
+    DilExpression const* expression,
+    DilGenerateFailure   failure);
+
+/* Add the statements that match the expression after its head matched. */
+void dil_generate__rest(
+    DilGenerator*        generator,
+    DilExpression const* expression);
+
+/* Add the statements that match the expression as many times as possible. */
+void dil_generate__loop(
+    DilGenerator*        generator,
+    DilExpression const* expression)
+{
+    if (dil_generate__run(generator, expression)) {
+        dil_generate__line(
+            generator,
+            expression->kind == DIL_EXPRESSION_NOT_SET
+                ? "dil_parse__not_set_run(context, &SET_%llu);"
+                : "dil_parse__set_run(context, &SET_%llu);",
+            dil_generate__constant(generator, expression));
+        return;
+    }
+
+    DilExpression const* head = dil_generate__head(generator, expression);
+    if (head == NULL) {
+        // Stop at the first time that consumes nothing, which would repeat
+        // the same way forever.
+        dil_generate__open(generator, "while (true) {");
+        dil_generate__line(
+            generator,
+            "char const* before = context->remaining.first;");
+        dil_generate__match(generator, expression, DIL_GENERATE_BREAK);
+        dil_generate__line(
+            generator,
+            "if (context->remaining.first == before) {");
+        dil_generate__line(generator, "    break;");
+        dil_generate__line(generator, "}");
+        dil_generate__skip(generator);
+        dil_generate__close(generator, "}");
+        return;
+    }
+    if (head == expression && !generator->current->skipped) {
+        dil_generate__condition(generator, "while (", head, ") {}");
+        return;
+    }
+    dil_generate__condition(generator, "while (", head, ") {");
+    generator->indentation++;
+    dil_generate__rest(generator, expression);
+    dil_generate__skip(generator);
+    dil_generate__close(generator, "}");
+}
+
+/* Add the statements that match the expression the fixed times after the
+ * first time. */
+void dil_generate__again(
+    DilGenerator*        generator,
+    DilExpression const* expression)
+{
+    DilExpression const* child = dil_generate__child(generator, expression, 0);
+    dil_generate__line(
+        generator,
+        "for (size_t i = 0; i < %llu - 1; i++) {",
+        expression->times);
+    generator->indentation++;
+    dil_generate__skip(generator);
+    dil_generate__match(generator, child, DIL_GENERATE_REPORT);
+    dil_generate__close(generator, "}");
+}
+
+void dil_generate__rest(
+    DilGenerator*        generator,
+    DilExpression const* expression)
+{
+    switch (expression->kind) {
+        case DIL_EXPRESSION_SEQUENCE:
+            for (size_t i = 1; i < expression->amount; i++) {
+                dil_generate__skip(generator);
+                dil_generate__match(
+                    generator,
+                    dil_generate__child(generator, expression, i),
+                    DIL_GENERATE_REPORT);
+            }
+            break;
+        case DIL_EXPRESSION_ONE_OR_MORE:
+            dil_generate__skip(generator);
+            dil_generate__loop(
+                generator,
+                dil_generate__child(generator, expression, 0));
+            break;
+        case DIL_EXPRESSION_FIXED_TIMES:
+            dil_generate__again(generator, expression);
+            break;
+        default:
+            break;
+    }
+}
+
+/* Whether the alternative is only tried if the lookahead is viable, which
+ * avoids the rules that would be entered only to fail. */
+bool dil_generate__guarded(
+    DilGenerator const*  generator,
+    DilExpression const* alternative)
+{
+    size_t index = alternative - generator->grammar->expressions.first;
+    if (dil_analysis_at(&generator->analysis, index)->vacuous) {
+        return false;
+    }
+    DilExpression const* head = dil_generate__head(generator, alternative);
+    return head == NULL || head->kind == DIL_EXPRESSION_REFERENCE;
+}
+
+/* Whether any alternative of the choice is guarded. */
+bool dil_generate__guards(
+    DilGenerator const*  generator,
+    DilExpression const* expression)
+{
+    if (expression->amount > DIL_GENERATE_ALTERNATIVES) {
+        return false;
+    }
+    for (size_t i = 0; i < expression->amount; i++) {
+        if (dil_generate__guarded(
+                generator,
+                dil_generate__child(generator, expression, i))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Whether the lookahead decides which alternative of the choice is tried,
+ * since none of them can be entered at the same character as another and
+ * each starts with a test. */
+bool dil_generate__disjoint(
+    DilGenerator const*  generator,
+    DilExpression const* expression)
+{
+    if (expression->amount > DIL_GENERATE_ALTERNATIVES ||
+        !dil_generate__guards(generator, expression)) {
+        return false;
+    }
+    DilCharClass seen = {0};
+    for (size_t i = 0; i < expression->amount; i++) {
+        size_t index = dil_grammar_child(generator->grammar, expression, i);
+        if (dil_analysis_at(&generator->analysis, index)->vacuous ||
+            dil_generate__head(generator, dil_generate__at(generator, index)) ==
+                NULL) {
+            return false;
+        }
+        DilCharClass viable = dil_analysis_viable(&generator->analysis, index);
+        for (size_t j = 0; j < 4; j++) {
+            if ((seen.bits[j] & viable.bits[j]) != 0) {
+                return false;
+            }
+            seen.bits[j] |= viable.bits[j];
+        }
+    }
+    return true;
+}
+
+/* Add the table of the alternatives of the choice that can be entered at
+ * each character. Returns the index of the table. */
+size_t dil_generate__first(
+    DilGenerator*        generator,
+    DilExpression const* expression)
+{
+    size_t table = generator->tables++;
+    dil_generate__indent(generator);
+    dil_generate__print(
+        generator,
+        "static DilParseFirst const FIRST_%llu = {",
+        table);
+    generator->indentation++;
+
+    // Put as many entries to a line as fit.
+    DilBuffer* output = generator->buffer;
+    DilBuffer  entry  = {0};
+    size_t     column = 0;
+    size_t     limit  = 80 - generator->indentation * 4;
+    for (unsigned i = 0; i <= UCHAR_MAX; i++) {
+        dil_buffer_clear(&entry);
+        generator->buffer = &entry;
+        for (size_t j = 0; j < expression->amount; j++) {
+            size_t index = dil_grammar_child(generator->grammar, expression, j);
+            DilCharClass viable =
+                dil_analysis_viable(&generator->analysis, index);
+            if (dil_analysis_at(&generator->analysis, index)->vacuous ||
+                !dil_char_class_contains(&viable, (char)i)) {
+                continue;
+            }
+            if (!dil_buffer_finite(&entry)) {
+                dil_buffer_add(&entry, '[');
+                dil_generate__character(generator, (char)i);
+                dil_generate__print(generator, "] = 1 << %llu", j);
+            } else {
+                dil_generate__print(generator, " | 1 << %llu", j);
+            }
+        }
+        generator->buffer = output;
+        if (!dil_buffer_finite(&entry)) {
+            continue;
+        }
+
+        size_t size = dil_buffer_size(&entry) + 1;
+        if (column != 0 && column + 1 + size <= limit) {
+            dil_buffer_add(output, ' ');
+            column += 1 + size;
+        } else {
+            dil_buffer_add(output, '\n');
+            dil_generate__indent(generator);
+            column = size;
+        }
+        dil_generate__print(
+            generator,
+            "%.*s,",
+            (int)dil_buffer_size(&entry),
+            entry.first);
+    }
+    dil_buffer_free(&entry);
+    generator->indentation--;
+
+    // Close the table after the last entry.
+    if (column == 0) {
+        dil_generate__print(generator, "0};\n");
+    } else {
+        *dil_buffer_finish(output) = '}';
+        dil_generate__print(generator, ";\n");
+    }
+    return table;
+}
+
+/* Whether the alternative of the choice is guarded by the table, which is
+ * none if it is the maximum size. */
+bool dil_generate__checks(
+    DilGenerator const*  generator,
+    DilExpression const* expression,
+    size_t               alternative,
+    size_t               table)
+{
+    return table != SIZE_MAX &&
+           dil_generate__guarded(
+               generator,
+               dil_generate__child(generator, expression, alternative));
+}
+
+/* Add the guard of the alternative of the choice with the text before and
+ * after it if the table guards the alternative. */
+void dil_generate__guard(
+    DilGenerator*        generator,
+    DilExpression const* expression,
+    size_t               alternative,
+    size_t               table,
+    char const*          before,
+    char const*          after)
+{
+    if (dil_generate__checks(generator, expression, alternative, table)) {
+        dil_generate__print(
+            generator,
+            "%sdil_parse__try(context, viable_%llu, %llu)%s",
+            before,
+            table,
+            alternative,
+            after);
+    }
+}
+
+/* Add the lookahead table of the choice and the alternatives that are viable
+ * at the remaining character if any alternative is guarded. Returns the
+ * index of the table. */
+size_t dil_generate__viable(
+    DilGenerator*        generator,
+    DilExpression const* expression)
+{
+    if (!dil_generate__guards(generator, expression)) {
+        return SIZE_MAX;
+    }
+    size_t table = dil_generate__first(generator, expression);
+    dil_generate__line(
+        generator,
+        "unsigned const viable_%llu = dil_parse__viable(context, FIRST_%llu);",
+        table,
+        table);
+    return table;
+}
+
+/* Add a switch that matches the alternative that the lookahead decides. */
+void dil_generate__switch(
+    DilGenerator*        generator,
+    DilExpression const* expression,
+    DilGenerateFailure   failure)
+{
+    size_t table = dil_generate__first(generator, expression);
+    dil_generate__line(
+        generator,
+        "switch (dil_parse__viable(context, FIRST_%llu)) {",
+        table);
+    generator->indentation++;
+    for (size_t i = 0; i < expression->amount; i++) {
+        dil_generate__line(generator, "case 1 << %llu:", i);
+        generator->indentation++;
+        dil_generate__match(
+            generator,
+            dil_generate__child(generator, expression, i),
+            failure);
+        dil_generate__line(generator, "break;");
+        generator->indentation--;
+    }
+    dil_generate__open(generator, "default:");
+    dil_generate__fail(generator, failure, expression);
+    generator->indentation--;
+    dil_generate__close(generator, "}");
+}
+
+/* Add the statements that match the first alternative that matches. */
+void dil_generate__choice(
+    DilGenerator*        generator,
+    DilExpression const* expression,
+    DilGenerateFailure   failure)
+{
+    // Breaking out of a switch would not leave the enclosing loop.
+    if (failure != DIL_GENERATE_BREAK &&
+        dil_generate__disjoint(generator, expression)) {
+        dil_generate__switch(generator, expression, failure);
+        return;
+    }
+
+    size_t table = dil_generate__viable(generator, expression);
+    bool   split = true;
+    for (size_t i = 0; i < expression->amount; i++) {
+        DilExpression const* alternative =
+            dil_generate__child(generator, expression, i);
+        split = split && (dil_generate__optional(alternative) ||
+                          dil_generate__head(generator, alternative) != NULL);
+    }
+
+    if (split) {
+        for (size_t i = 0; i < expression->amount; i++) {
+            DilExpression const* alternative =
+                dil_generate__child(generator, expression, i);
+            if (dil_generate__optional(alternative)) {
+                dil_generate__open(generator, i == 0 ? "{" : "} else {");
+                dil_generate__match(generator, alternative, failure);
+                dil_generate__close(generator, "}");
+                return;
+            }
+            dil_generate__indent(generator);
+            dil_generate__print(generator, i == 0 ? "if (" : "} else if (");
+            dil_generate__guard(generator, expression, i, table, "", " && ");
+            dil_generate__test(
+                generator,
+                dil_generate__head(generator, alternative));
+            dil_generate__print(generator, ") {\n");
+            generator->indentation++;
+            dil_generate__rest(generator, alternative);
+            generator->indentation--;
+        }
+        dil_generate__open(generator, "} else {");
+        dil_generate__fail(generator, failure, expression);
+        dil_generate__close(generator, "}");
+        return;
+    }
+
+    // Try each alternative in a block that is left when it does not match.
+    size_t flag = generator->flags++;
+    dil_generate__line(generator, "bool matched_%llu = false;", flag);
+    for (size_t i = 0; i < expression->amount; i++) {
+        dil_generate__indent(generator);
+        dil_generate__print(generator, "if (!matched_%llu", flag);
+        dil_generate__guard(generator, expression, i, table, " && ", "");
+        dil_generate__print(generator, ") {\n");
+        generator->indentation++;
+        dil_generate__open(generator, "do {");
+        dil_generate__match(
+            generator,
+            dil_generate__child(generator, expression, i),
+            DIL_GENERATE_BREAK);
+        dil_generate__line(generator, "matched_%llu = true;", flag);
+        dil_generate__close(generator, "} while (false);");
+        dil_generate__close(generator, "}");
+    }
+    dil_generate__line(generator, "if (!matched_%llu) {", flag);
+    generator->indentation++;
+    dil_generate__fail(generator, failure, expression);
+    dil_generate__close(generator, "}");
+}
+
+/* Add the statements that match the expression, which run the failure if
+ * the expression does not match at its start. The later mismatches are
+ * reported, and accept the rule. A sequence whose first element can match
+ * nothing does not match at its start if it cannot start with the remaining
+ * character. */
+void dil_generate__match(
+    DilGenerator*        generator,
+    DilExpression const* expression,
+    DilGenerateFailure   failure)
+{
+    if (dil_generate__simple(expression)) {
+        dil_generate__condition(generator, "if (!", expression, ") {");
+        generator->indentation++;
+        dil_generate__fail(generator, failure, expression);
+        dil_generate__close(generator, "}");
+        return;
+    }
+
+    DilExpression const* child = dil_generate__child(generator, expression, 0);
+    switch (expression->kind) {
+        case DIL_EXPRESSION_SEQUENCE:
+        case DIL_EXPRESSION_ONE_OR_MORE:
+        case DIL_EXPRESSION_FIXED_TIMES:
+            if (dil_generate__leads(generator, expression)) {
+                dil_generate__line(
+                    generator,
+                    "if (!dil_parse__starts(context, &SET_%llu)) {",
+                    dil_generate__constant(generator, expression));
+                generator->indentation++;
+                dil_generate__fail(generator, failure, expression);
+                dil_generate__close(generator, "}");
+            }
+            dil_generate__match(generator, child, failure);
+            dil_generate__rest(generator, expression);
+            break;
+        case DIL_EXPRESSION_CHOICE:
+            dil_generate__choice(generator, expression, failure);
+            break;
+        case DIL_EXPRESSION_ZERO_OR_MORE:
+            dil_generate__loop(generator, child);
+            break;
+        default: {
+            DilExpression const* head = dil_generate__head(generator, child);
+            if (head == child) {
+                dil_generate__condition(generator, "(void)", child, ";");
+            } else if (head != NULL) {
+                dil_generate__condition(generator, "if (", head, ") {");
+                generator->indentation++;
+                dil_generate__rest(generator, child);
+                dil_generate__close(generator, "}");
+            } else {
+                dil_generate__open(generator, "do {");
+                dil_generate__match(generator, child, DIL_GENERATE_BREAK);
+                dil_generate__close(generator, "} while (false);");
+            }
+            break;
+        }
+    }
+}
+
+/* Whether the pattern is a simple expression or a choice of them, whose
+ * result is returned directly. */
+bool dil_generate__direct(DilGenerator const* generator, size_t pattern)
+{
+    DilExpression const* expression = dil_generate__at(generator, pattern);
+    if (expression->kind != DIL_EXPRESSION_CHOICE) {
+        return dil_generate__simple(expression);
+    }
+    for (size_t i = 0; i < expression->amount; i++) {
+        if (!dil_generate__simple(
+                dil_generate__child(generator, expression, i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Add the body of the current function, which matches the pattern. */
+void dil_generate__body(DilGenerator* generator, size_t pattern)
+{
+    dil_indices_clear(&generator->sets);
+    dil_indices_clear(&generator->strings);
+    generator->flags  = 0;
+    generator->tables = 0;
+    dil_generate__collect(generator, pattern);
+    dil_generate__constants(generator);
+
+    DilExpression const* expression = dil_generate__at(generator, pattern);
+    if (!dil_generate__direct(generator, pattern)) {
+        dil_generate__match(generator, expression, DIL_GENERATE_REJECT);
+        dil_generate__line(
+            generator,
+            generator->node ? "return dil_parse__return(context, true);"
+                            : "return true;");
+        return;
+    }
+
+    // Return the result of the tests directly.
+    char const* start = "return ";
+    char const* end   = ";";
+    if (generator->node) {
+        start = "return dil_parse__return(context, ";
+        end   = ");";
+    }
+    if (expression->kind != DIL_EXPRESSION_CHOICE) {
+        dil_generate__condition(generator, start, expression, end);
+        return;
+    }
+    if (dil_generate__disjoint(generator, expression)) {
+        size_t table = dil_generate__first(generator, expression);
+        dil_generate__line(
+            generator,
+            "switch (dil_parse__viable(context, FIRST_%llu)) {",
+            table);
+        generator->indentation++;
+        for (size_t i = 0; i < expression->amount; i++) {
+            dil_generate__line(generator, "case 1 << %llu:", i);
+            generator->indentation++;
+            dil_generate__condition(
+                generator,
+                start,
+                dil_generate__child(generator, expression, i),
+                end);
+            generator->indentation--;
+        }
+        dil_generate__line(generator, "default:");
+        dil_generate__line(generator, "    %sfalse%s", start, end);
+        dil_generate__close(generator, "}");
+        return;
+    }
+
+    size_t table = dil_generate__viable(generator, expression);
+    if (generator->node) {
+        dil_generate__line(generator, "return dil_parse__return(");
+        generator->indentation++;
+        dil_generate__line(generator, "context,");
+        start = "";
+    }
+    for (size_t i = 0; i < expression->amount; i++) {
+        dil_generate__indent(generator);
+        dil_generate__print(
+            generator,
+            "%s",
+            i == 0 ? start : generator->node ? "    " : "");
+        dil_generate__guard(generator, expression, i, table, "(", " && ");
+        dil_generate__test(
+            generator,
+            dil_generate__child(generator, expression, i));
+        if (dil_generate__checks(generator, expression, i, table)) {
+            dil_buffer_add(generator->buffer, ')');
+        }
+        dil_generate__print(
+            generator,
+            "%s\n",
+            i + 1 == expression->amount ? end : " ||");
+        if (i == 0 && !generator->node) {
+            generator->indentation++;
+        }
+    }
+    generator->indentation--;
+}
+
+/* Add the enumeration and the format strings of the symbols. */
+void dil_generate__symbols(DilGenerator* generator)
+{
+    char const* upper  = generator->upper.first;
+    char const* pascal = generator->pascal.first;
+    size_t      rules  = dil_rules_size(&generator->grammar->rules);
+
+    dil_generate__line(
+        generator,
+        "/* Symbols of the parser, which start with the ones of the runtime. "
+        "*/");
+    dil_generate__open(generator, "typedef enum {");
+    dil_generate__line(
+        generator,
+        "%s_SYMBOL__CHARACTER = DIL_SYMBOL__CHARACTER,",
+        upper);
+    dil_generate__line(
+        generator,
+        "%s_SYMBOL__STRING    = DIL_SYMBOL__STRING,",
+        upper);
+    dil_generate__line(
+        generator,
+        "%s_SYMBOL__START     = DIL_SYMBOL__START%s",
+        upper,
+        rules == 0 ? "" : ",");
+    for (size_t i = 0; i < rules; i++) {
+        dil_generate__line(
+            generator,
+            "%s_SYMBOL_%s%s",
+            upper,
+            dil_generate__name(generator, i, DIL_GENERATE_SYMBOL),
+            i + 1 == rules ? "" : ",");
+    }
+    generator->indentation--;
+    dil_generate__line(generator, "} %sSymbol;", pascal);
+    dil_generate__line(generator, "");
+
+    dil_generate__line(generator, "/* Format string of the symbol. */");
+    dil_generate__line(
+        generator,
+        "char const* %s_format(%sSymbol symbol)",
+        generator->prefix,
+        pascal);
+    dil_generate__open(generator, "{");
+    dil_generate__open(generator, "switch (symbol) {");
+    dil_generate__line(generator, "case %s_SYMBOL__CHARACTER:", upper);
+    dil_generate__line(generator, "    return \"character [%%.*s]\";");
+    dil_generate__line(generator, "case %s_SYMBOL__STRING:", upper);
+    dil_generate__line(generator, "    return \"string [%%.*s]\";");
+    dil_generate__line(generator, "case %s_SYMBOL__START:", upper);
+    dil_generate__line(generator, "    return \"start\";");
+    for (size_t i = 0; i < rules; i++) {
+        dil_generate__line(
+            generator,
+            "case %s_SYMBOL_%s:",
+            upper,
+            dil_generate__name(generator, i, DIL_GENERATE_SYMBOL));
+        dil_generate__line(
+            generator,
+            "    return \"%s {%%.*s}\";",
+            dil_generate__name(generator, i, DIL_GENERATE_TITLE));
+    }
+    dil_generate__line(generator, "default:");
+    dil_generate__line(generator, "    return \"Unknown !{%%.*s}\";");
+    dil_generate__close(generator, "}");
+    dil_generate__close(generator, "}");
+    dil_generate__line(generator, "");
+}
+
+/* Add the functions of the skip style. */
+void dil_generate__skips(DilGenerator* generator, size_t skip)
+{
+    char const* prefix  = generator->prefix;
+    DilRule     current = {.name = dil_string_terminated("skip")};
+    generator->current  = &current;
+    generator->node     = false;
+    generator->symbol   = "skip";
+
+    dil_generate__line(
+        generator,
+        "/* Characters a skip in style %llu can start with. */",
+        skip);
+    dil_generate__line(
+        generator,
+        "DilCharClass const* %s_parse__skip_%llu_first(void)",
+        prefix,
+        skip);
+    dil_generate__open(generator, "{");
+    dil_generate__class(
+        generator,
+        "FIRST",
+        &dil_analysis_at(
+             &generator->analysis,
+             dil_indices_get(&generator->grammar->skips, skip))
+             ->first);
+    dil_generate__line(generator, "");
+    dil_generate__line(generator, "return &FIRST;");
+    dil_generate__close(generator, "}");
+    dil_generate__line(generator, "");
+
+    dil_generate__line(
+        generator,
+        "/* Try to parse the pattern of the skip style %llu. */",
+        skip);
+    dil_generate__line(
+        generator,
+        "bool %s_parse__skip_%llu_pattern(DilParseContext* context)",
+        prefix,
+        skip);
+    dil_generate__open(generator, "{");
+    dil_generate__body(
+        generator,
+        dil_indices_get(&generator->grammar->skips, skip));
+    dil_generate__close(generator, "}");
+    dil_generate__line(generator, "");
+
+    dil_generate__line(
+        generator,
+        "/* Try to skip in style %llu once. Fails if nothing is skipped. */",
+        skip);
+    dil_generate__line(
+        generator,
+        "bool %s_parse__skip_%llu_once(DilParseContext* context)",
+        prefix,
+        skip);
+    dil_generate__open(generator, "{");
+    dil_generate__line(
+        generator,
+        "char const* first = context->remaining.first;");
+    dil_generate__line(generator, "bool        skip  = context->skip;");
+    dil_generate__line(generator, "");
+    dil_generate__line(generator, "context->skip = true;");
+    dil_generate__line(
+        generator,
+        "bool accept   = %s_parse__skip_%llu_pattern(context);",
+        prefix,
+        skip);
+    dil_generate__line(generator, "context->skip = skip;");
+    dil_generate__line(
+        generator,
+        "return accept && context->remaining.first != first;");
+    dil_generate__close(generator, "}");
+    dil_generate__line(generator, "");
+
+    dil_generate__line(
+        generator,
+        "/* Skip in style %llu as much as possible. */",
+        skip);
+    dil_generate__line(
+        generator,
+        "void %s_parse__skip_%llu(DilParseContext* context)",
+        prefix,
+        skip);
+    dil_generate__open(generator, "{");
+    dil_generate__line(
+        generator,
+        "while (%s_parse__skip_%llu_once(context)) {}",
+        prefix,
+        skip);
+    dil_generate__close(generator, "}");
+    dil_generate__line(generator, "");
+}
+
+/* Add the bytes as the lines of an array with the name. */
+void dil_generate__bytes(
+    DilGenerator*    generator,
+    char const*      name,
+    DilBuffer const* bytes,
+    size_t           width)
+{
+    size_t size = dil_buffer_size(bytes);
+    dil_generate__line(
+        generator,
+        "static unsigned char const %s[%llu] = {",
+        name,
+        size);
+    generator->indentation++;
+    for (size_t i = 0; i < size; i += width) {
+        dil_generate__indent(generator);
+        for (size_t j = i; j < i + width && j < size; j++) {
+            dil_generate__print(
+                generator,
+                "%s%u%s",
+                j == i ? "" : " ",
+                (unsigned char)dil_buffer_get(bytes, j),
+                j + 1 == size ? "};" : ",");
+        }
+        dil_buffer_add(generator->buffer, '\n');
+    }
+    generator->indentation--;
+}
+
+/* Add the scanner of the rule if it only has terminals, which recognizes it
+ * without calling a function for each terminal. When the scanner cannot
+ * decide without an error, the rule is parsed after it to report the
+ * error. */
+void dil_generate__scanner(DilGenerator* generator, size_t index)
+{
+    DilAutomaton automaton = {0};
+    if (!dil_automaton_build(&automaton, generator->grammar, index)) {
+        return;
+    }
+
+    DilRule const* rule   = dil_rules_at(&generator->grammar->rules, index);
+    bool           direct = dil_generate__direct(generator, rule->pattern);
+    if (generator->report != NULL) {
+        (void)fprintf(
+            generator->report,
+            "%s: %llu states from %llu, %llu columns, %llu bytes%s\n",
+            generator->symbol,
+            automaton.states,
+            automaton.built,
+            automaton.width,
+            dil_automaton_size(&automaton),
+            direct ? ", tested directly instead" : "");
+    }
+    if (direct) {
+        dil_automaton_free(&automaton);
+        return;
+    }
+
+    dil_generate__line(
+        generator,
+        "/* %llu states and %llu columns in %llu bytes. */",
+        automaton.states,
+        automaton.width,
+        dil_automaton_size(&automaton));
+    dil_generate__bytes(generator, "COLUMNS", &automaton.columns, 16);
+    dil_generate__bytes(
+        generator,
+        "TABLE",
+        &automaton.table,
+        automaton.width <= 16 ? automaton.width : 16);
+    dil_generate__line(generator, "static DilScanner const SCANNER = {");
+    generator->indentation++;
+    dil_generate__line(generator, ".columns = COLUMNS,");
+    dil_generate__line(generator, ".width   = %llu,", automaton.width);
+    dil_generate__line(generator, ".table   = TABLE,");
+    dil_generate__line(generator, ".start   = %llu};", automaton.start);
+    generator->indentation--;
+    dil_generate__line(generator, "");
+
+    dil_generate__line(generator, "char const* end = NULL;");
+    dil_generate__open(
+        generator,
+        "switch (dil_parse__scan(context, &SCANNER, &end)) {");
+    dil_generate__open(generator, "case DIL_SCANNER_ACCEPT:");
+    if (automaton.strings) {
+        // Strings are nodes of their own in the tree.
+        dil_generate__open(generator, "if (dil_parse__flat(context)) {");
+        dil_generate__line(
+            generator,
+            "return dil_parse__recognize(context, symbol, end);");
+        dil_generate__close(generator, "}");
+        dil_generate__line(generator, "break;");
+    } else {
+        dil_generate__line(
+            generator,
+            "return dil_parse__recognize(context, symbol, end);");
+    }
+    generator->indentation--;
+    dil_generate__line(generator, "case DIL_SCANNER_REJECT:");
+    dil_generate__line(generator, "    return false;");
+    dil_generate__line(generator, "default:");
+    dil_generate__line(generator, "    break;");
+    dil_generate__close(generator, "}");
+    dil_generate__line(generator, "");
+    dil_automaton_free(&automaton);
+}
+
+/* Whether the rule keeps its node even if it passes through. */
+bool dil_generate__kept(DilGenerateOptions options, DilRule const* rule)
+{
+    if (options.exact) {
+        return true;
+    }
+    for (char const* const* i = options.kept; i != NULL && *i != NULL; i++) {
+        DilString name = dil_string_terminated(*i);
+        if (dil_string_equal(&name, &rule->name)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Decide which rules are collapsed with the options. */
+void dil_generate__collapse(
+    DilGenerator*      generator,
+    DilGenerateOptions options)
+{
+    DilRules const* rules = &generator->grammar->rules;
+    for (size_t i = 0; i < dil_rules_size(rules); i++) {
+        DilRule const* rule = dil_rules_at(rules, i);
+        dil_indices_add(
+            &generator->collapsed,
+            !dil_generate__kept(options, rule) &&
+                dil_generate__passes(generator, rule->pattern));
+    }
+    if (generator->report == NULL) {
+        return;
+    }
+
+    size_t collapsed = 0;
+    for (size_t i = 0; i < dil_rules_size(rules); i++) {
+        if (dil_indices_get(&generator->collapsed, i) == 0) {
+            continue;
+        }
+        DilRule const* rule   = dil_rules_at(rules, i);
+        size_t         hops   = 0;
+        size_t         target = dil_generate__resolve(generator, i, &hops);
+        DilRule const* called = dil_rules_at(rules, target);
+        (void)fprintf(
+            generator->report,
+            "%.*s: collapsed",
+            (int)dil_string_size(&rule->name),
+            rule->name.first);
+        if (hops != 0) {
+            (void)fprintf(
+                generator->report,
+                ", references call %.*s",
+                (int)dil_string_size(&called->name),
+                called->name.first);
+        }
+        (void)fprintf(generator->report, "\n");
+        collapsed++;
+    }
+    (void)fprintf(
+        generator->report,
+        "Collapsed %llu of %llu rules.\n",
+        collapsed,
+        dil_rules_size(rules));
+}
+
+/* Make the rule remember the offsets it was rejected at in the way, unless it
+ * already does in a denser way. */
+void dil_generate__raise(
+    DilGenerator* generator,
+    size_t        rule,
+    DilRecallKind kind)
+{
+    if (dil_indices_get(&generator->recalls, rule) < kind) {
+        dil_indices_put(&generator->recalls, rule, kind);
+    }
+}
+
+/* Decide which rules remember the offsets they were rejected at, which are
+ * the ones the parser can try again at the same offset. The collapsed rules
+ * have no node, so the rules they pass through to remember instead. The rules
+ * with a scanner are not remembered, since scanning them again is as fast as
+ * looking them up. The rules that start a repetition are tried at most of the
+ * offsets it goes over, so their offsets are dense. */
+void dil_generate__remember(DilGenerator* generator)
+{
+    DilGrammar const* grammar      = generator->grammar;
+    size_t            rules        = dil_rules_size(&grammar->rules);
+    DilBacktracking   backtracking = dil_backtrack(&generator->analysis);
+    dil_indices_place(&generator->recalls, rules, DIL_RECALL_OFF);
+    for (size_t i = 0; i < rules; i++) {
+        if (dil_backtracking_retried(&backtracking, i)) {
+            dil_indices_put(
+                &generator->recalls,
+                i,
+                dil_backtracking_repeated(&backtracking, i)
+                    ? DIL_RECALL_DENSE
+                    : DIL_RECALL_SPARSE);
+        }
+    }
+    dil_backtracking_free(&backtracking);
+
+    // Pass the recalls of the collapsed rules through, once for each link of
+    // the longest chain of them.
+    bool changed = true;
+    for (size_t pass = 0; changed && pass < rules; pass++) {
+        changed = false;
+        for (size_t i = 0; i < rules; i++) {
+            DilRecallKind kind = dil_indices_get(&generator->recalls, i);
+            if (kind == DIL_RECALL_OFF ||
+                dil_indices_get(&generator->collapsed, i) == 0) {
+                continue;
+            }
+            dil_indices_put(&generator->recalls, i, DIL_RECALL_OFF);
+            changed = true;
+
+            DilExpression const* pattern = dil_generate__at(
+                generator,
+                dil_rules_at(&grammar->rules, i)->pattern);
+            if (pattern->kind == DIL_EXPRESSION_REFERENCE) {
+                dil_generate__raise(generator, pattern->rule, kind);
+                continue;
+            }
+            for (size_t j = 0; j < pattern->amount; j++) {
+                dil_generate__raise(
+                    generator,
+                    dil_generate__child(generator, pattern, j)->rule,
+                    kind);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < rules; i++) {
+        DilRecallKind kind = dil_indices_get(&generator->recalls, i);
+        if (kind == DIL_RECALL_OFF) {
+            continue;
+        }
+        DilAutomaton automaton = {0};
+        if (dil_automaton_build(&automaton, grammar, i)) {
+            dil_automaton_free(&automaton);
+            dil_indices_put(&generator->recalls, i, DIL_RECALL_OFF);
+            continue;
+        }
+
+        generator->recalled++;
+        if (generator->report != NULL) {
+            DilRule const* rule = dil_rules_at(&grammar->rules, i);
+            (void)fprintf(
+                generator->report,
+                "%.*s: remembers rejections, %s\n",
+                (int)dil_string_size(&rule->name),
+                rule->name.first,
+                kind == DIL_RECALL_DENSE ? "dense" : "sparse");
+        }
+    }
+    if (generator->report != NULL) {
+        (void)fprintf(
+            generator->report,
+            "Remembered %llu of %llu rules.\n",
+            generator->recalled,
+            rules);
+    }
+}
+
+/* Add the function of the collapsed rule, which tests its pattern without
+ * creating a node, and counts the node when it is accepted. */
+void dil_generate__collapsed(DilGenerator* generator, size_t index)
+{
+    DilRule const* rule  = dil_rules_at(&generator->grammar->rules, index);
+    char const*    words = dil_generate__name(
+        generator,
+        index,
+        DIL_GENERATE_WORDS);
+    generator->current    = rule;
+    generator->node       = false;
+    generator->collapsing = 1;
+
+    char name[256];
+    (void)sprintf_s(
+        name,
+        sizeof(name),
+        "%.*s",
+        (int)dil_string_size(&rule->name),
+        rule->name.first);
+    generator->symbol = name;
+
+    dil_generate__line(
+        generator,
+        "/* Try to parse %s %s, which passes through without a node. */",
+        strchr("aeio", words[0]) != NULL && strncmp(words, "one", 3) != 0
+            ? "an"
+            : "a",
+        words);
+    dil_generate__line(
+        generator,
+        "bool %s_parse_%s(DilParseContext* context)",
+        generator->prefix,
+        dil_generate__name(generator, index, DIL_GENERATE_FUNCTION));
+    dil_generate__open(generator, "{");
+    dil_generate__body(generator, rule->pattern);
+    dil_generate__close(generator, "}");
+    dil_generate__line(generator, "");
+    generator->collapsing = 0;
+}
+
+/* Add the function of the rule. */
+void dil_generate__rule(DilGenerator* generator, size_t index)
+{
+    if (dil_indices_get(&generator->collapsed, index) != 0) {
+        dil_generate__collapsed(generator, index);
+        return;
+    }
+
+    DilRule const* rule     = dil_rules_at(&generator->grammar->rules, index);
+    char const*    function = dil_generate__name(
+        generator,
+        index,
+        DIL_GENERATE_FUNCTION);
+    char const*    symbol   = dil_generate__name(
+        generator,
+        index,
+        DIL_GENERATE_SYMBOL);
+    char const*    words    = dil_generate__name(
+        generator,
+        index,
+        DIL_GENERATE_WORDS);
+    char const*    upper    = generator->upper.first;
+    generator->current      = rule;
+    generator->node         = true;
+
+    char name[256];
+    (void)sprintf_s(
+        name,
+        sizeof(name),
+        "%.*s",
+        (int)dil_string_size(&rule->name),
+        rule->name.first);
+    generator->symbol = name;
+
+    dil_generate__line(
+        generator,
+        "/* Try to parse %s %s. */",
+        strchr("aeio", words[0]) != NULL && strncmp(words, "one", 3) != 0
+            ? "an"
+            : "a",
+        words);
+    dil_generate__line(
+        generator,
+        "bool %s_parse_%s(DilParseContext* context)",
+        generator->prefix,
+        function);
+    dil_generate__open(generator, "{");
+    dil_generate__line(
+        generator,
+        "DilSymbol const symbol = (DilSymbol)%s_SYMBOL_%s;",
+        upper,
+        symbol);
+    dil_generate__line(generator, "bool            accept = false;");
+    dil_generate__open(
+        generator,
+        "if (dil_parse__decided(context, symbol, &accept)) {");
+    dil_generate__line(generator, "return accept;");
+    dil_generate__close(generator, "}");
+    if (dil_indices_get(&generator->recalls, index) != DIL_RECALL_OFF) {
+        dil_generate__open(
+            generator,
+            "if (dil_parse__recalled(context, symbol)) {");
+        dil_generate__line(generator, "return false;");
+        dil_generate__close(generator, "}");
+    }
+    dil_generate__line(generator, "");
+    dil_generate__scanner(generator, index);
+    dil_generate__line(generator, "dil_parse__create(context, symbol);");
+    dil_generate__line(generator, "");
+    dil_generate__body(generator, rule->pattern);
+    dil_generate__close(generator, "}");
+    dil_generate__line(generator, "");
+}
+
+/* Add the offsets the rules that remember them were rejected at, indexed by
+ * the symbol, if there are any. */
+void dil_generate__recalls(DilGenerator* generator)
+{
+    if (generator->recalled == 0) {
+        return;
+    }
+
+    DilRules const* rules = &generator->grammar->rules;
+    dil_generate__line(generator, "");
+    dil_generate__line(
+        generator,
+        "enum { RECALLS = %s_SYMBOL_%s + 1 };",
+        generator->upper.first,
+        dil_generate__name(
+            generator,
+            dil_rules_size(rules) - 1,
+            DIL_GENERATE_SYMBOL));
+    dil_generate__line(generator, "DilRecall recalls[RECALLS] = {");
+    generator->indentation++;
+    size_t remaining = generator->recalled;
+    for (size_t i = 0; i < dil_rules_size(rules); i++) {
+        DilRecallKind kind = dil_indices_get(&generator->recalls, i);
+        if (kind == DIL_RECALL_OFF) {
+            continue;
+        }
+        remaining--;
+        dil_generate__line(
+            generator,
+            "[%s_SYMBOL_%s] = {.kind = %s}%s",
+            generator->upper.first,
+            dil_generate__name(generator, i, DIL_GENERATE_SYMBOL),
+            kind == DIL_RECALL_DENSE ? "DIL_RECALL_DENSE"
+                                     : "DIL_RECALL_SPARSE",
+            remaining == 0 ? "};" : ",");
+    }
+    generator->indentation--;
+}
+
+/* Add the context of the parsing process of the entry point, which is
+ * called initial. */
+void dil_generate__context(DilGenerator* generator, bool events)
+{
+    dil_generate__line(generator, "DilParseContext initial = {");
+    generator->indentation++;
+    if (!events) {
+        dil_generate__line(
+            generator,
+            ".builder   = {.built = &initial.built},");
+    }
+    dil_generate__line(generator, ".remaining = source.contents,");
+    dil_generate__line(generator, ".source    = source,");
+    dil_generate__line(
+        generator,
+        events ? ".options   = options," : ".options   = options};");
+    if (events) {
+        dil_generate__line(generator, ".events    = events};");
+    }
+    generator->indentation--;
+    dil_generate__recalls(generator);
+    dil_generate__line(generator, "");
+    if (events) {
+        dil_generate__line(generator, "initial.options.memo = NULL;");
+    } else {
+        dil_generate__open(generator, "if (options.memo != NULL) {");
+        dil_generate__line(generator, "dil_memo_clear(options.memo);");
+        dil_generate__close(generator, "}");
+    }
+    if (generator->recalled != 0) {
+        dil_generate__line(
+            generator,
+            "dil_parse__recall(&initial, recalls, RECALLS);");
+    }
+    dil_generate__line(generator, "");
+    dil_generate__line(generator, "dil_parse__open(&initial);");
+    dil_generate__line(
+        generator,
+        "(void)%s_parse__start(&initial);",
+        generator->prefix);
+    dil_generate__line(generator, "dil_parse__close(&initial);");
+    if (generator->recalled != 0) {
+        dil_generate__line(generator, "dil_parse__forget(&initial, RECALLS);");
+    }
+}
+
+/* Add the function that parses the start pattern and calls the callbacks
+ * instead of building the tree. */
+void dil_generate__events(DilGenerator* generator)
+{
+    char const* prefix = generator->prefix;
+    dil_generate__line(generator, "");
+    dil_generate__line(
+        generator,
+        "/* Parses the source file with the options, and calls the callbacks "
+        "instead of");
+    dil_generate__line(
+        generator,
+        " * building the tree. The memo table of the options is not used. */");
+    dil_generate__line(generator, "void %s_parse_events(", prefix);
+    generator->indentation++;
+    dil_generate__line(generator, "DilSource             source,");
+    dil_generate__line(generator, "DilParseOptions       options,");
+    dil_generate__line(generator, "DilParseEvents const* events)");
+    generator->indentation--;
+    dil_generate__open(generator, "{");
+    dil_generate__context(generator, true);
+    dil_generate__line(generator, "dil_parse__dismiss(&initial);");
+    dil_generate__close(generator, "}");
+}
+
+/* Add the functions that parse the start pattern into a tree. */
+void dil_generate__start(DilGenerator* generator)
+{
+    char const* prefix = generator->prefix;
+    generator->current = &generator->grammar->start;
+    generator->node    = false;
+    generator->symbol  = "start";
+
+    dil_generate__line(
+        generator,
+        "/* Parse the start pattern after the leading skip. */");
+    dil_generate__line(
+        generator,
+        "bool %s_parse__start(DilParseContext* context)",
+        prefix);
+    dil_generate__open(generator, "{");
+    dil_generate__skip(generator);
+    dil_generate__body(generator, generator->grammar->start.pattern);
+    dil_generate__close(generator, "}");
+    dil_generate__line(generator, "");
+
+    dil_generate__line(
+        generator,
+        "/* Parses the source file with the options. */");
+    dil_generate__line(
+        generator,
+        "DilTree %s_parse_with(DilSource source, DilParseOptions options)",
+        prefix);
+    dil_generate__open(generator, "{");
+    dil_generate__context(generator, false);
+    dil_generate__line(generator, "return dil_parse__conclude(&initial);");
+    dil_generate__close(generator, "}");
+    dil_generate__line(generator, "");
+
+    dil_generate__line(generator, "/* Parses the source file. */");
+    dil_generate__line(generator, "DilTree %s_parse(DilSource source)", prefix);
+    dil_generate__open(generator, "{");
+    dil_generate__line(
+        generator,
+        "return %s_parse_with(source, (DilParseOptions){0});",
+        prefix);
+    dil_generate__close(generator, "}");
+}
+
+/* Generate the parser of the grammar into the buffer with the options. The
+ * parser is a C file that includes the runtime in `dil/parser.c`, and
+ * defines `<prefix>_parse` and `<prefix>_parse_with` that build the tree of
+ * a source file like `dil_parse` does. Each rule is a function whose sets
+ * and strings are constants; the ones that only have terminals are
+ * recognized by a table driven scanner first. Unless the options keep them,
+ * the rules that only pass through to other rules do not create nodes, and
+ * the references to the ones that pass through to a single rule call that
+ * rule directly. The rules that can be tried again at an offset they were
+ * rejected at remember those offsets. With the events option, it also
+ * defines `<prefix>_parse_events`, which calls callbacks in the order of
+ * the tree instead of building it. Returns whether the
+ * grammar could be read without errors, and has no repetitions of patterns
+ * that can match nothing or rules that reach themselves before consuming a
+ * character, which are printed; nothing is generated otherwise. */
+bool dil_generate_with(
+    DilBuffer*         buffer,
+    DilTree const*     tree,
+    DilGenerateOptions options)
+{
+    DilGrammar grammar = dil_grammar_read(tree);
+    if (grammar.errors != 0) {
+        dil_grammar_free(&grammar);
+        return false;
+    }
+
+    DilGenerator generator = {
+        .buffer   = buffer,
+        .grammar  = &grammar,
+        .prefix   = options.prefix != NULL ? options.prefix : "generated",
+        .report   = options.report,
+        .analysis = dil_analyze(&grammar)};
+    if (dil_analysis_unending(&generator.analysis, stdout) != 0) {
+        dil_analysis_free(&generator.analysis);
+        dil_grammar_free(&grammar);
+        return false;
+    }
+    if (options.report != NULL) {
+        (void)dil_analysis_overlaps(&generator.analysis, options.report);
+        (void)dil_analysis_shadowed(&generator.analysis, options.report);
+    }
+    dil_generate__names(&generator);
+    dil_generate__collapse(&generator, options);
+    dil_generate__remember(&generator);
+    dil_indices_place(
+        &generator.constants,
+        dil_expressions_size(&grammar.expressions),
+        0);
+
+    size_t rules = dil_rules_size(&grammar.rules);
+    dil_generate__line(&generator, "// Generated by dil. Do not edit.");
+    dil_generate__line(&generator, "");
+    dil_generate__line(&generator, "#pragma once");
+    dil_generate__line(&generator, "");
+    dil_generate__line(&generator, "#include \"dil/parser.c\"");
+    dil_generate__line(&generator, "");
+    dil_generate__symbols(&generator);
+
+    for (size_t i = 0; i < rules; i++) {
+        dil_generate__line(
+            &generator,
+            "bool %s_parse_%s(DilParseContext* context);",
+            generator.prefix,
+            dil_generate__name(&generator, i, DIL_GENERATE_FUNCTION));
+    }
+    dil_generate__line(&generator, "");
+
+    for (size_t i = 0; i < dil_indices_size(&grammar.skips); i++) {
+        dil_generate__skips(&generator, i);
+    }
+    for (size_t i = 0; i < rules; i++) {
+        dil_generate__rule(&generator, i);
+    }
+    dil_generate__start(&generator);
+    if (options.events) {
+        dil_generate__events(&generator);
+    }
+
+    dil_buffer_free(&generator.upper);
+    dil_buffer_free(&generator.pascal);
+    dil_buffer_free(&generator.names);
+    dil_indices_free(&generator.forms);
+    dil_indices_free(&generator.constants);
+    dil_indices_free(&generator.sets);
+    dil_indices_free(&generator.strings);
+    dil_indices_free(&generator.collapsed);
+    dil_indices_free(&generator.recalls);
+    dil_analysis_free(&generator.analysis);
+    dil_grammar_free(&grammar);
+    return true;
+}
+
+/* Generate the parser of the grammar into the buffer with the default
+ * options. */
+bool dil_generate(DilBuffer* buffer, DilTree const* tree)
+{
+    return dil_generate_with(buffer, tree, (DilGenerateOptions){0});
+}
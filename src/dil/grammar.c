@@ -0,0 +1,521 @@
+// SPDX-FileCopyrightText: 2022 Cem Geçgel <gecgelcem@outlook.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "dil/buffer.c"
+#include "dil/class.c"
+#include "dil/expressions.c"
+#include "dil/indices.c"
+#include "dil/object.c"
+#include "dil/rules.c"
+#include "dil/string.c"
+#include "dil/tree.c"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Grammar that is read from the tree of a grammar file. The patterns are
+ * expressions that refer to each other by their indices, which are easier to
+ * analyze and generate code from than the tree. */
+typedef struct {
+    /* Rules in the order they were defined. */
+    DilRules rules;
+    /* Expressions of all the patterns. */
+    DilExpressions expressions;
+    /* Indices of the childeren of the expressions, where the childeren of
+     * each expression are together. */
+    DilIndices childeren;
+    /* Index of the pattern of each skip style. */
+    DilIndices skips;
+    /* Decoded strings and the characters of the sets. */
+    DilBuffer texts;
+    /* Pattern the file is parsed with, and the skip style it uses. */
+    DilRule start;
+    /* Whether there is a start pattern. */
+    bool started;
+    /* Amount of errors that were found while reading the grammar. */
+    size_t errors;
+} DilGrammar;
+
+/* Tree of a grammar file that is being read. */
+typedef struct {
+    /* Read tree. */
+    DilTree const* tree;
+    /* Index after the last node of the subtree of each node. */
+    DilIndices ends;
+    /* Grammar that is built. */
+    DilGrammar* grammar;
+} DilGrammarReader;
+
+/* Pointer to the expression at the index. */
+DilExpression* dil_grammar_at(DilGrammar const* grammar, size_t index)
+{
+    return dil_expressions_at(&grammar->expressions, index);
+}
+
+/* Index of the child of the expression at the index. */
+size_t dil_grammar_child(
+    DilGrammar const*    grammar,
+    DilExpression const* expression,
+    size_t               index)
+{
+    return dil_indices_get(&grammar->childeren, expression->first + index);
+}
+
+/* Text of the expression, which is the decoded string or the characters of
+ * the set. */
+DilString
+dil_grammar_text(DilGrammar const* grammar, DilExpression const* expression)
+{
+    char const* first = grammar->texts.first + expression->text;
+    return (DilString){.first = first, .last = first + expression->length};
+}
+
+/* Index of the rule with the name, or the amount of rules if there is
+ * none. */
+size_t dil_grammar_find(DilGrammar const* grammar, DilString const* name)
+{
+    size_t index = 0;
+    for (; index < dil_rules_size(&grammar->rules); index++) {
+        DilRule const* rule = dil_rules_at(&grammar->rules, index);
+        if (dil_string_equal(&rule->name, name)) {
+            break;
+        }
+    }
+    return index;
+}
+
+/* Find the end of the subtree of each node. */
+void dil_grammar__ends(DilGrammarReader* reader)
+{
+    size_t     size    = dil_tree_size(reader->tree);
+    DilIndices parents = {0};
+    DilIndices left    = {0};
+    dil_indices_place(&reader->ends, size, size);
+    for (size_t i = 0; i < size; i++) {
+        // Close the parents whose childeren were all seen.
+        while (dil_indices_finite(&left) && *dil_indices_finish(&left) == 0) {
+            *dil_indices_at(&reader->ends, dil_indices_pop(&parents)) = i;
+            dil_indices_remove(&left);
+        }
+        if (dil_indices_finite(&left)) {
+            (*dil_indices_finish(&left))--;
+        }
+        dil_indices_add(&parents, i);
+        dil_indices_add(&left, dil_tree_at(reader->tree, i)->childeren);
+    }
+    dil_indices_free(&parents);
+    dil_indices_free(&left);
+}
+
+/* Index of the next child after the child at the index, which is the end of
+ * the parent if there is none. */
+size_t dil_grammar__next(DilGrammarReader const* reader, size_t index)
+{
+    return dil_indices_get(&reader->ends, index);
+}
+
+/* Index of the first child of the node with the symbol, or the end of the
+ * node if there is none. */
+size_t dil_grammar__child(
+    DilGrammarReader const* reader,
+    size_t                  node,
+    DilSymbol               symbol)
+{
+    size_t end = dil_grammar__next(reader, node);
+    size_t i   = node + 1;
+    while (i < end && dil_tree_at(reader->tree, i)->object.symbol != symbol) {
+        i = dil_grammar__next(reader, i);
+    }
+    return i;
+}
+
+/* Value of the node at the index. */
+DilString const* dil_grammar__value(DilGrammarReader const* reader, size_t node)
+{
+    return &dil_tree_at(reader->tree, node)->object.value;
+}
+
+/* Report the error at the portion of the grammar. */
+void dil_grammar__error(
+    DilGrammarReader* reader,
+    DilString const*  portion,
+    char const*       message)
+{
+    reader->grammar->errors++;
+    printf(
+        "error: %s: `%.*s`\n",
+        message,
+        (int)dil_string_size(portion),
+        portion->first);
+}
+
+/* Whether the character is a hexadecimal digit. */
+bool dil_grammar__hexadecimal(char character)
+{
+    return (character >= '0' && character <= '9') ||
+           (character >= 'a' && character <= 'f') ||
+           (character >= 'A' && character <= 'F');
+}
+
+/* Value of the hexadecimal digit. */
+int dil_grammar__digit(char character)
+{
+    if (character >= 'a') {
+        return character - 'a' + 10;
+    }
+    if (character >= 'A') {
+        return character - 'A' + 10;
+    }
+    return character - '0';
+}
+
+/* Decode the character at the start of the view, which might be escaped, and
+ * remove it from the view. */
+char dil_grammar__decode(DilString* view)
+{
+    char character = *view->first++;
+    if (character != '\\' || !dil_string_finite(view)) {
+        return character;
+    }
+    character = *view->first++;
+    if (dil_grammar__hexadecimal(character) && dil_string_finite(view) &&
+        dil_grammar__hexadecimal(*view->first)) {
+        return (char)(dil_grammar__digit(character) * 16 +
+                      dil_grammar__digit(*view->first++));
+    }
+    switch (character) {
+        case 't':
+            return '\t';
+        case 'n':
+            return '\n';
+        default:
+            return character;
+    }
+}
+
+/* Add an expression and return its index. */
+size_t dil_grammar__add(DilGrammarReader* reader, DilExpression expression)
+{
+    dil_expressions_add(&reader->grammar->expressions, expression);
+    return dil_expressions_size(&reader->grammar->expressions) - 1;
+}
+
+/* Add an expression with the childeren, or the only child itself. */
+size_t dil_grammar__group(
+    DilGrammarReader*  reader,
+    DilExpressionKind  kind,
+    DilIndices const*  childeren,
+    DilString const*   source)
+{
+    if (dil_indices_size(childeren) == 1) {
+        return dil_indices_get(childeren, 0);
+    }
+    DilGrammar* grammar = reader->grammar;
+    size_t      first   = dil_indices_size(&grammar->childeren);
+    for (size_t i = 0; i < dil_indices_size(childeren); i++) {
+        dil_indices_add(&grammar->childeren, dil_indices_get(childeren, i));
+    }
+    return dil_grammar__add(
+        reader,
+        (DilExpression){
+            .kind   = kind,
+            .source = *source,
+            .first  = first,
+            .amount = dil_indices_size(childeren)});
+}
+
+/* Add an expression with a single child. */
+size_t dil_grammar__wrap(
+    DilGrammarReader* reader,
+    DilExpressionKind kind,
+    size_t            child,
+    size_t            times,
+    DilString const*  source)
+{
+    DilGrammar* grammar = reader->grammar;
+    dil_indices_add(&grammar->childeren, child);
+    return dil_grammar__add(
+        reader,
+        (DilExpression){
+            .kind   = kind,
+            .source = *source,
+            .times  = times,
+            .first  = dil_indices_size(&grammar->childeren) - 1,
+            .amount = 1});
+}
+
+/* Read the set between the quotes in the value. */
+size_t dil_grammar__set(
+    DilGrammarReader* reader,
+    DilString const*  value,
+    bool              inverted)
+{
+    DilGrammar*   grammar    = reader->grammar;
+    DilExpression expression = {
+        .kind   = inverted ? DIL_EXPRESSION_NOT_SET : DIL_EXPRESSION_SET,
+        .source = *value,
+        .text   = dil_buffer_size(&grammar->texts)};
+
+    DilString view = *value;
+    dil_string_unwrap(&view, '\'', '\'');
+    while (dil_string_finite(&view)) {
+        unsigned char first = dil_grammar__decode(&view);
+        unsigned char last  = first;
+        if (dil_string_prefix_element(&view, '~') && dil_string_finite(&view)) {
+            last = dil_grammar__decode(&view);
+        }
+        for (unsigned i = first; i <= last; i++) {
+            dil_char_class_add(&expression.set, (char)i);
+            dil_buffer_add(&grammar->texts, (char)i);
+        }
+    }
+    expression.length = dil_buffer_size(&grammar->texts) - expression.text;
+
+    if (!inverted && expression.length == 1) {
+        expression.kind      = DIL_EXPRESSION_CHARACTER;
+        expression.character = dil_buffer_get(&grammar->texts, expression.text);
+    }
+    return dil_grammar__add(reader, expression);
+}
+
+/* Read the string between the quotes in the value. */
+size_t dil_grammar__string(DilGrammarReader* reader, DilString const* value)
+{
+    DilGrammar*   grammar    = reader->grammar;
+    DilExpression expression = {
+        .kind   = DIL_EXPRESSION_STRING,
+        .source = *value,
+        .text   = dil_buffer_size(&grammar->texts)};
+
+    DilString view = *value;
+    dil_string_unwrap(&view, '"', '"');
+    while (dil_string_finite(&view)) {
+        dil_buffer_add(&grammar->texts, dil_grammar__decode(&view));
+    }
+    expression.length = dil_buffer_size(&grammar->texts) - expression.text;
+    return dil_grammar__add(reader, expression);
+}
+
+size_t dil_grammar__pattern(DilGrammarReader* reader, size_t node);
+
+/* Read the childeren of the node with the symbol, and group them with the
+ * kind. */
+size_t dil_grammar__list(
+    DilGrammarReader* reader,
+    size_t            node,
+    DilSymbol         symbol,
+    DilExpressionKind kind,
+    size_t (*read)(DilGrammarReader*, size_t))
+{
+    DilIndices childeren = {0};
+    size_t     end       = dil_grammar__next(reader, node);
+    for (size_t i = node + 1; i < end; i = dil_grammar__next(reader, i)) {
+        if (dil_tree_at(reader->tree, i)->object.symbol == symbol) {
+            dil_indices_add(&childeren, read(reader, i));
+        }
+    }
+    size_t result = dil_grammar__group(
+        reader,
+        kind,
+        &childeren,
+        dil_grammar__value(reader, node));
+    dil_indices_free(&childeren);
+    return result;
+}
+
+/* Read the unit at the node. */
+size_t dil_grammar__unit(DilGrammarReader* reader, size_t node)
+{
+    DilGrammar*      grammar = reader->grammar;
+    size_t           child   = node + 1;
+    DilNode const*   inner   = dil_tree_at(reader->tree, child);
+    DilString const* value   = &inner->object.value;
+    switch (inner->object.symbol) {
+        case DIL_SYMBOL_SET:
+            return dil_grammar__set(reader, value, false);
+        case DIL_SYMBOL_NOT_SET:
+            return dil_grammar__set(
+                reader,
+                dil_grammar__value(
+                    reader,
+                    dil_grammar__child(reader, child, DIL_SYMBOL_SET)),
+                true);
+        case DIL_SYMBOL_STRING:
+            return dil_grammar__string(reader, value);
+        case DIL_SYMBOL_REFERENCE: {
+            size_t rule = dil_grammar_find(grammar, value);
+            if (rule == dil_rules_size(&grammar->rules)) {
+                dil_grammar__error(reader, value, "Rule is not defined");
+            }
+            return dil_grammar__add(
+                reader,
+                (DilExpression){
+                    .kind   = DIL_EXPRESSION_REFERENCE,
+                    .source = *value,
+                    .rule   = rule});
+        }
+        case DIL_SYMBOL_GROUP:
+            return dil_grammar__list(
+                reader,
+                child,
+                DIL_SYMBOL_PATTERN,
+                DIL_EXPRESSION_SEQUENCE,
+                &dil_grammar__pattern);
+        case DIL_SYMBOL_FIXED_TIMES: {
+            DilString const* number = dil_grammar__value(
+                reader,
+                dil_grammar__child(reader, child, DIL_SYMBOL_NUMBER));
+            size_t times = 0;
+            for (char const* i = number->first; i < number->last; i++) {
+                times = times * 10 + (size_t)(*i - '0');
+            }
+            return dil_grammar__wrap(
+                reader,
+                DIL_EXPRESSION_FIXED_TIMES,
+                dil_grammar__unit(
+                    reader,
+                    dil_grammar__child(reader, child, DIL_SYMBOL_UNIT)),
+                times,
+                value);
+        }
+        default: {
+            DilExpressionKind kind = DIL_EXPRESSION_OPTIONAL;
+            if (inner->object.symbol == DIL_SYMBOL_ZERO_OR_MORE) {
+                kind = DIL_EXPRESSION_ZERO_OR_MORE;
+            } else if (inner->object.symbol == DIL_SYMBOL_ONE_OR_MORE) {
+                kind = DIL_EXPRESSION_ONE_OR_MORE;
+            }
+            return dil_grammar__wrap(
+                reader,
+                kind,
+                dil_grammar__unit(
+                    reader,
+                    dil_grammar__child(reader, child, DIL_SYMBOL_UNIT)),
+                0,
+                value);
+        }
+    }
+}
+
+/* Read the alternative at the node. */
+size_t dil_grammar__alternative(DilGrammarReader* reader, size_t node)
+{
+    return dil_grammar__list(
+        reader,
+        node,
+        DIL_SYMBOL_UNIT,
+        DIL_EXPRESSION_SEQUENCE,
+        &dil_grammar__unit);
+}
+
+/* Read the pattern at the node. */
+size_t dil_grammar__pattern(DilGrammarReader* reader, size_t node)
+{
+    return dil_grammar__list(
+        reader,
+        node,
+        DIL_SYMBOL_ALTERNATIVE,
+        DIL_EXPRESSION_CHOICE,
+        &dil_grammar__alternative);
+}
+
+/* Read the grammar from the tree of a grammar file without errors. The
+ * rules use the skip style that was set by the last skip statement before
+ * them. Prints the errors in the grammar, such as the references to the
+ * rules that are not defined. */
+DilGrammar dil_grammar_read(DilTree const* tree)
+{
+    DilGrammar       result = {0};
+    DilGrammarReader reader = {.tree = tree, .grammar = &result};
+    dil_grammar__ends(&reader);
+
+    // Find the names first, since rules can refer to the later ones.
+    size_t end = dil_tree_size(tree);
+    for (size_t i = 1; i < end; i = dil_grammar__next(&reader, i)) {
+        size_t rule = dil_grammar__child(&reader, i, DIL_SYMBOL_RULE);
+        if (rule == dil_grammar__next(&reader, i)) {
+            continue;
+        }
+        DilString const* name = dil_grammar__value(
+            &reader,
+            dil_grammar__child(&reader, rule, DIL_SYMBOL_IDENTIFIER));
+        if (dil_grammar_find(&result, name) != dil_rules_size(&result.rules)) {
+            dil_grammar__error(&reader, name, "Rule is defined again");
+            continue;
+        }
+        dil_rules_add(&result.rules, (DilRule){.name = *name});
+    }
+
+    DilRule style = {0};
+    for (size_t i = 1; i < end; i = dil_grammar__next(&reader, i)) {
+        size_t         statement = i + 1;
+        DilNode const* node      = dil_tree_at(tree, statement);
+        size_t         pattern   = dil_grammar__child(
+            &reader,
+            statement,
+            DIL_SYMBOL_PATTERN);
+        bool found = pattern != dil_grammar__next(&reader, statement);
+        if (!found && node->object.symbol != DIL_SYMBOL_SKIP) {
+            dil_grammar__error(
+                &reader,
+                &node->object.value,
+                "Pattern is missing");
+            continue;
+        }
+        switch (node->object.symbol) {
+            case DIL_SYMBOL_SKIP:
+                style.skipped = found;
+                if (found) {
+                    style.skip = dil_indices_size(&result.skips);
+                    dil_indices_add(
+                        &result.skips,
+                        dil_grammar__pattern(&reader, pattern));
+                }
+                break;
+            case DIL_SYMBOL_START:
+                result.start         = style;
+                result.start.name    = dil_string_terminated("start");
+                result.start.pattern = dil_grammar__pattern(&reader, pattern);
+                result.started       = true;
+                break;
+            default: {
+                DilString const* name = dil_grammar__value(
+                    &reader,
+                    dil_grammar__child(
+                        &reader,
+                        statement,
+                        DIL_SYMBOL_IDENTIFIER));
+                DilRule* rule = dil_rules_at(
+                    &result.rules,
+                    dil_grammar_find(&result, name));
+                rule->skipped = style.skipped;
+                rule->skip    = style.skip;
+                rule->pattern = dil_grammar__pattern(&reader, pattern);
+                break;
+            }
+        }
+    }
+
+    if (!result.started) {
+        DilString none = dil_string_terminated("start");
+        dil_grammar__error(&reader, &none, "There is no start pattern");
+    }
+
+    dil_indices_free(&reader.ends);
+    return result;
+}
+
+/* Deallocate memory. */
+void dil_grammar_free(DilGrammar* grammar)
+{
+    dil_rules_free(&grammar->rules);
+    dil_expressions_free(&grammar->expressions);
+    dil_indices_free(&grammar->childeren);
+    dil_indices_free(&grammar->skips);
+    dil_buffer_free(&grammar->texts);
+}
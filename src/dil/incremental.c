@@ -0,0 +1,422 @@
+// SPDX-FileCopyrightText: 2022 Cem Geçgel <gecgelcem@outlook.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "dil/buffer.c"
+#include "dil/indices.c"
+#include "dil/memo.c"
+#include "dil/object.c"
+#include "dil/parser.c"
+#include "dil/source.c"
+#include "dil/string.c"
+#include "dil/tree.c"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Tree of a source file that is edited, with a gap in its nodes at the last
+ * edit. The nodes after the gap are kept at the end of the allocation, and
+ * the characters the edits moved them by are kept aside instead of applied to
+ * each of them. An edit only moves the nodes between it and the previous one,
+ * so the rest of the tree is not touched. The errors of the statements are
+ * recorded with a gap the same way, and give the error count. */
+typedef struct {
+    /* Nodes before the gap. The allocation holds the ones after it too. */
+    DilTree tree;
+    /* Border before the nodes after the gap, which end at the allocated
+     * border of the tree. */
+    DilNode* rest;
+    /* Offsets of the statements of the errors before the gap. The allocation
+     * holds the ones after it too. */
+    DilIndices errors;
+    /* Border before the errors after the gap, which end at the allocated
+     * border of the errors. */
+    size_t* later;
+    /* Contents the values of the nodes after the gap point to. */
+    char const* base;
+    /* Amount of characters the nodes and the errors after the gap moved. */
+    ptrdiff_t shift;
+    /* Options of the parsing processes. */
+    DilParseOptions options;
+} DilParseDocument;
+
+/* Move the values of the nodes from the first to the last by the amount of
+ * characters. */
+void dil_parse__node_shift(DilNode* first, DilNode* last, ptrdiff_t amount)
+{
+    for (DilNode* i = first; i < last; i++) {
+        i->object.value.first += amount;
+        i->object.value.last += amount;
+    }
+}
+
+/* Amount of nodes before and after the gap. */
+size_t dil_parse__document_size(DilParseDocument const* document)
+{
+    return dil_tree_size(&document->tree) +
+           (size_t)(document->tree.allocated - document->rest);
+}
+
+/* Pointer to the node at the index, whose value is not moved yet if it is
+ * after the gap. */
+DilNode* dil_parse__document_at(DilParseDocument const* document, size_t index)
+{
+    size_t before = dil_tree_size(&document->tree);
+    if (index < before) {
+        return dil_tree_at(&document->tree, index);
+    }
+    return document->rest + (index - before);
+}
+
+/* Amount of characters the values of the nodes after the gap are behind. */
+ptrdiff_t dil_parse__document_delta(
+    DilParseDocument const* document,
+    DilSource const*        source)
+{
+    return source->contents.first - document->base + document->shift;
+}
+
+/* Offset of the start of the node at the index. */
+size_t dil_parse__document_offset(
+    DilParseDocument const* document,
+    DilSource const*        source,
+    size_t                  index)
+{
+    char const* position =
+        dil_parse__document_at(document, index)->object.value.first;
+    if (index < dil_tree_size(&document->tree)) {
+        return position - source->contents.first;
+    }
+    return (size_t)(position - document->base + document->shift);
+}
+
+/* Index of the first node after the root that does not start before the
+ * offset. The nodes are in the order they start, since the parser only moves
+ * forward when creating them. */
+size_t dil_parse__node_find(
+    DilParseDocument const* document,
+    DilSource const*        source,
+    size_t                  offset)
+{
+    size_t first = 1;
+    size_t last  = dil_parse__document_size(document);
+    while (first < last) {
+        size_t middle = first + (last - first) / 2;
+        if (dil_parse__document_offset(document, source, middle) < offset) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+    return first;
+}
+
+/* Move the gap in the nodes to the index, and the values of the nodes that
+ * cross it. */
+void dil_parse__node_move(
+    DilParseDocument* document,
+    DilSource const*  source,
+    size_t            index)
+{
+    DilTree*  tree   = &document->tree;
+    size_t    before = dil_tree_size(tree);
+    ptrdiff_t delta  = dil_parse__document_delta(document, source);
+    if (index < before) {
+        size_t moved = before - index;
+        document->rest -= moved;
+        tree->last -= moved;
+        memmove(document->rest, tree->last, moved * sizeof(DilNode));
+        dil_parse__node_shift(document->rest, document->rest + moved, -delta);
+    } else if (index > before) {
+        size_t moved = index - before;
+        memmove(tree->last, document->rest, moved * sizeof(DilNode));
+        dil_parse__node_shift(tree->last, tree->last + moved, delta);
+        tree->last += moved;
+        document->rest += moved;
+    }
+}
+
+/* Make sure the amount of nodes fit into the gap. */
+void dil_parse__node_reserve(DilParseDocument* document, size_t amount)
+{
+    // Reserve as if the nodes after the gap were free, then move them to the
+    // end of the new allocation.
+    DilTree* tree  = &document->tree;
+    size_t   after = tree->allocated - document->rest;
+    size_t   rest  = document->rest - tree->first;
+    dil_tree_reserve(tree, amount + after);
+    document->rest = tree->allocated - after;
+    if (after > 0) {
+        memmove(document->rest, tree->first + rest, after * sizeof(DilNode));
+    }
+}
+
+/* Amount of recorded errors before and after the gap. */
+size_t dil_parse__error_size(DilParseDocument const* document)
+{
+    return dil_indices_size(&document->errors) +
+           (size_t)(document->errors.allocated - document->later);
+}
+
+/* Offset of the statement of the recorded error at the index. */
+size_t dil_parse__error_offset(DilParseDocument const* document, size_t index)
+{
+    size_t before = dil_indices_size(&document->errors);
+    if (index < before) {
+        return dil_indices_get(&document->errors, index);
+    }
+    return document->later[index - before] + (size_t)document->shift;
+}
+
+/* Index of the first recorded error that is not in a statement before the
+ * offset. The errors are in the order of their statements. */
+size_t dil_parse__error_find(DilParseDocument const* document, size_t offset)
+{
+    size_t first = 0;
+    size_t last  = dil_parse__error_size(document);
+    while (first < last) {
+        size_t middle = first + (last - first) / 2;
+        if (dil_parse__error_offset(document, middle) < offset) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+    return first;
+}
+
+/* Move the gap in the recorded errors to the index, and the offsets of the
+ * errors that cross it. */
+void dil_parse__error_move(DilParseDocument* document, size_t index)
+{
+    DilIndices* errors = &document->errors;
+    size_t      before = dil_indices_size(errors);
+    if (index < before) {
+        size_t moved = before - index;
+        document->later -= moved;
+        errors->last -= moved;
+        memmove(document->later, errors->last, moved * sizeof(size_t));
+        for (size_t* i = document->later; i < document->later + moved; i++) {
+            *i -= (size_t)document->shift;
+        }
+    } else if (index > before) {
+        size_t moved = index - before;
+        memmove(errors->last, document->later, moved * sizeof(size_t));
+        for (size_t* i = errors->last; i < errors->last + moved; i++) {
+            *i += (size_t)document->shift;
+        }
+        errors->last += moved;
+        document->later += moved;
+    }
+}
+
+/* Make sure the amount of errors fit into the gap. */
+void dil_parse__error_reserve(DilParseDocument* document, size_t amount)
+{
+    DilIndices* errors = &document->errors;
+    size_t      after  = errors->allocated - document->later;
+    size_t      later  = document->later - errors->first;
+    dil_indices_reserve(errors, amount + after);
+    document->later = errors->allocated - after;
+    if (after > 0) {
+        memmove(document->later, errors->first + later, after * sizeof(size_t));
+    }
+}
+
+/* Replace the errors recorded in the statements from the first offset upto
+ * the last one with the parsed errors. The offsets are the ones before the
+ * edit, and the parsed errors are after it. */
+void dil_parse__error_replace(
+    DilParseDocument* document,
+    DilIndices const* parsed,
+    size_t            first,
+    size_t            last)
+{
+    dil_parse__error_move(document, dil_parse__error_find(document, first));
+    while (document->later < document->errors.allocated &&
+           *document->later + (size_t)document->shift < last) {
+        document->later++;
+    }
+
+    size_t added = dil_indices_size(parsed);
+    dil_parse__error_reserve(document, added);
+    if (added > 0) {
+        memcpy(document->errors.last, parsed->first, added * sizeof(size_t));
+        document->errors.last += added;
+    }
+}
+
+/* Parse the source file with the options to edit it later. The errors are
+ * recorded by the document instead of the options, and counted in the source
+ * file. */
+void dil_parse_document_init(
+    DilParseDocument* document,
+    DilSource*        source,
+    DilParseOptions   options)
+{
+    *document = (DilParseDocument){
+        .base    = source->contents.first,
+        .options = options};
+    DilSource whole = *source;
+    whole.error     = 0;
+    options.errors  = &document->errors;
+    document->tree  = dil_parse_with(whole, options);
+    document->rest  = document->tree.allocated;
+    document->later = document->errors.allocated;
+    source->error   = dil_parse__error_size(document);
+}
+
+/* Applies the edit to the source file, which must be at the end of the
+ * buffer, and updates the document. Only the statements around the edit are
+ * parsed, until the parser starts a statement at the same characters as one
+ * in the tree after the edit, which would be parsed the same way. The rest of
+ * the tree is kept, so only the errors in the parsed statements are reported.
+ * The error count of the source file stays the same as a full parse would
+ * give. */
+void dil_parse_edit(
+    DilParseDocument*    document,
+    DilBuffer*           buffer,
+    DilSource*           source,
+    DilSourceEdit const* edit)
+{
+    // Nodes after the gap are moved through the base when the contents are
+    // reallocated, which happens less often the larger the buffer grows.
+    char const* previous = source->contents.first;
+    dil_source_edit(buffer, source, edit);
+    if (source->contents.first != previous) {
+        dil_parse__node_shift(
+            document->tree.first,
+            document->tree.last,
+            source->contents.first - previous);
+    }
+
+    // Reparse from the statement before the edit, since it might have looked
+    // at the characters after it. Statements are only the childeren of the
+    // root, so they are found among the nodes by their symbol.
+    size_t reparsed = dil_parse__node_find(document, source, edit->offset);
+    do {
+        reparsed--;
+    } while (reparsed > 0 &&
+             dil_parse__document_at(document, reparsed)->object.symbol !=
+                 DIL_SYMBOL_STATEMENT);
+
+    DilIndices      errors  = {0};
+    DilParseContext initial = {
+        .builder   = {.built = &initial.built},
+        .remaining = source->contents,
+        .source    = *source,
+        .options   = document->options};
+    initial.source.error   = 0;
+    initial.options.errors = &errors;
+    if (reparsed > 0) {
+        initial.remaining.first +=
+            dil_parse__document_offset(document, source, reparsed);
+    } else {
+        reparsed = 1;
+    }
+    dil_parse__node_move(document, source, reparsed);
+
+    if (document->options.memo != NULL) {
+        dil_memo_clear(document->options.memo);
+    }
+
+    // Parse the statements under a temporary root, until a statement would
+    // start at the same characters as one in the tree after the edit. The
+    // errors are placed the same way as in a full parse.
+    ptrdiff_t const amount = (ptrdiff_t)dil_string_size(&edit->inserted) -
+                             (ptrdiff_t)edit->removed;
+    size_t const after  = edit->offset + dil_string_size(&edit->inserted);
+    size_t       reused = dil_parse__document_size(document);
+    DilNode*     root   = dil_tree_start(&document->tree);
+    char const*  first  = initial.remaining.first;
+    size_t const start  = first - source->contents.first;
+    size_t       end    = SIZE_MAX;
+    size_t       placed = 0;
+    dil_parse__open(&initial);
+    dil_parse__skip_0(&initial);
+    dil_parse__place(&initial, &placed, first);
+    first = initial.remaining.first;
+    while (dil_parse_statement(&initial)) {
+        dil_parse__skip_0(&initial);
+        dil_parse__place(&initial, &placed, first);
+        first = initial.remaining.first;
+
+        size_t offset = initial.remaining.first - source->contents.first;
+        if (offset < after) {
+            continue;
+        }
+        offset -= amount;
+        size_t found = dil_parse__node_find(document, source, offset);
+        if (found == dil_parse__document_size(document)) {
+            continue;
+        }
+        if (dil_parse__document_at(document, found)->object.symbol ==
+                DIL_SYMBOL_STATEMENT &&
+            dil_parse__document_offset(document, source, found) == offset) {
+            // The reused statements end where the tree did, and the contents
+            // they left are not reported again, since their error is kept.
+            reused            = found;
+            end               = offset;
+            initial.remaining = (DilString){
+                .first = root->object.value.last + amount,
+                .last  = root->object.value.last + amount};
+            break;
+        }
+    }
+    dil_parse__close(&initial);
+    dil_parse__place(&initial, &placed, first);
+
+    // Replace the old statements, which are right after the gap, with the
+    // parsed ones. The reused ones after them are moved with the gap.
+    for (size_t i = reparsed; i < reused; i++) {
+        if (dil_parse__document_at(document, i)->object.symbol ==
+            DIL_SYMBOL_STATEMENT) {
+            root->childeren--;
+        }
+    }
+    DilNode const* parsed = dil_tree_start(&initial.built);
+    root->childeren += parsed->childeren;
+    root->object.value.last = parsed->object.value.last;
+
+    size_t added = dil_tree_size(&initial.built) - 1;
+    document->rest += reused - reparsed;
+    dil_parse__node_reserve(document, added);
+    memcpy(document->tree.last, parsed + 1, added * sizeof(DilNode));
+    document->tree.last += added;
+
+    dil_parse__error_replace(document, &errors, start, end);
+    document->shift += amount;
+    source->error = dil_parse__error_size(document);
+    dil_indices_free(&errors);
+    DilTree built = dil_parse__conclude(&initial);
+    dil_tree_free(&built);
+}
+
+/* Tree of the document, with the gap moved to the end. Keeps the document
+ * usable, but the next edit moves the nodes after it back. */
+DilTree const*
+dil_parse_document_tree(DilParseDocument* document, DilSource const* source)
+{
+    dil_parse__node_move(document, source, dil_parse__document_size(document));
+    return &document->tree;
+}
+
+/* Offsets of the statements of the recorded errors, with the gap moved to the
+ * end. */
+DilIndices const* dil_parse_document_errors(DilParseDocument* document)
+{
+    dil_parse__error_move(document, dil_parse__error_size(document));
+    return &document->errors;
+}
+
+/* Deallocate memory. */
+void dil_parse_document_free(DilParseDocument* document)
+{
+    dil_tree_free(&document->tree);
+    dil_indices_free(&document->errors);
+    document->rest  = NULL;
+    document->later = NULL;
+}
@@ -0,0 +1,217 @@
+// SPDX-FileCopyrightText: 2022 Cem Geçgel <gecgelcem@outlook.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Operation of an instruction of a compiled grammar. A test continues after
+ * the next instruction when it matches, and runs the next instruction when it
+ * does not, so each test is followed by what happens when it fails. */
+typedef enum {
+    /* Test the character at the operand. */
+    DIL_OPCODE_CHARACTER,
+    /* Test the set of the expression at the operand. */
+    DIL_OPCODE_SET,
+    /* Test the not set of the expression at the operand. */
+    DIL_OPCODE_NOT_SET,
+    /* Test the string of the expression at the operand. */
+    DIL_OPCODE_STRING,
+    /* Test whether the sequence at the operand can start with the remaining
+     * character, without consuming it. */
+    DIL_OPCODE_FIRST,
+    /* Open a node for the rule at the operand and run its function, which
+     * is a test that matches if the rule is accepted. */
+    DIL_OPCODE_CALL,
+    /* Parse as many characters from the set of the expression at the
+     * operand as possible. */
+    DIL_OPCODE_SET_RUN,
+    /* Parse as many characters from the not set of the expression at the
+     * operand as possible. */
+    DIL_OPCODE_NOT_SET_RUN,
+    /* Skip in the style at the operand as much as possible. */
+    DIL_OPCODE_SKIP,
+    /* Continue at the operand. */
+    DIL_OPCODE_JUMP,
+    /* Remember to continue at the operand if the instructions after it
+     * fail. */
+    DIL_OPCODE_CHOICE,
+    /* Forget the last choice and continue at the operand. */
+    DIL_OPCODE_COMMIT,
+    /* Forget the last choice, and continue at the operand if anything was
+     * consumed since it. Continues after the instruction otherwise, which
+     * ends a loop at the first time that consumes nothing. */
+    DIL_OPCODE_REPEAT,
+    /* Backtrack to the last choice, or reject the function if it has none. */
+    DIL_OPCODE_FAIL,
+    /* Report that the expression at the operand was expected, and accept the
+     * function. */
+    DIL_OPCODE_ERROR,
+    /* Accept the function and close its node if it has one. */
+    DIL_OPCODE_RETURN,
+    /* Amount of operations. */
+    DIL_OPCODE_COUNT
+} DilOpcode;
+
+/* Instruction of a compiled grammar. */
+typedef struct {
+    /* Operation of the instruction. */
+    DilOpcode opcode;
+    /* Character, expression, rule, skip style or address the operation is
+     * done with. */
+    unsigned operand;
+} DilInstruction;
+
+/* Contiguous, dynamicly allocated elements. */
+typedef struct {
+    /* Border before the first element. */
+    DilInstruction* first;
+    /* Border after the last element. */
+    DilInstruction* last;
+    /* Border after the last allocated element. */
+    DilInstruction* allocated;
+} DilInstructions;
+
+/* Amount of elements. */
+size_t dil_instructions_size(DilInstructions const* list)
+{
+    return list->last - list->first;
+}
+
+/* Amount of allocated elements. */
+size_t dil_instructions_capacity(DilInstructions const* list)
+{
+    return list->allocated - list->first;
+}
+
+/* Amount of allocated but unused elements. */
+size_t dil_instructions_space(DilInstructions const* list)
+{
+    return list->allocated - list->last;
+}
+
+/* Whether there are any elements. */
+bool dil_instructions_finite(DilInstructions const* list)
+{
+    return dil_instructions_size(list) > 0;
+}
+
+/* Pointer to the element at the index. */
+DilInstruction* dil_instructions_at(DilInstructions const* list, size_t index)
+{
+    return list->first + index;
+}
+
+/* Element at the index. */
+DilInstruction dil_instructions_get(DilInstructions const* list, size_t index)
+{
+    return *dil_instructions_at(list, index);
+}
+
+/* Pointer to the first element. */
+DilInstruction* dil_instructions_start(DilInstructions const* list)
+{
+    return list->first;
+}
+
+/* Pointer to the last element. */
+DilInstruction* dil_instructions_finish(DilInstructions const* list)
+{
+    return list->last - 1;
+}
+
+/* Make sure the amount of elements will fit. Grows by at least half if
+ * necessary. */
+void dil_instructions_reserve(DilInstructions* list, size_t amount)
+{
+    size_t space = dil_instructions_space(list);
+    if (amount <= space) {
+        return;
+    }
+
+    size_t growth       = amount - space;
+    size_t capacity     = dil_instructions_capacity(list);
+    size_t halfCapacity = capacity / 2;
+    if (growth < halfCapacity) {
+        growth = halfCapacity;
+    }
+
+    size_t          newCapacity = capacity + growth;
+    DilInstruction* memory =
+        realloc(list->first, newCapacity * sizeof(DilInstruction));
+
+    list->last      = memory + dil_instructions_size(list);
+    list->first     = memory;
+    list->allocated = memory + newCapacity;
+}
+
+/* Add the element to the end. */
+void dil_instructions_add(DilInstructions* list, DilInstruction element)
+{
+    dil_instructions_reserve(list, 1);
+    *list->last++ = element;
+}
+
+/* Open space at the index for the amount of element. Returns pointer to the
+ * first opened element. */
+DilInstruction*
+dil_instructions_open(DilInstructions* list, size_t index, size_t amount)
+{
+    dil_instructions_reserve(list, amount);
+    DilInstruction* position = list->first + index;
+    memmove(position + amount, position, amount * sizeof(DilInstruction));
+    list->last += amount;
+    return position;
+}
+
+/* Put the element to the given index. */
+void dil_instructions_put(
+    DilInstructions* list,
+    size_t           index,
+    DilInstruction   element)
+{
+    *dil_instructions_open(list, index, 1) = element;
+}
+
+/* Place the element the amount of times to the end. */
+void dil_instructions_place(
+    DilInstructions* list,
+    size_t           amount,
+    DilInstruction   element)
+{
+    dil_instructions_reserve(list, amount);
+    for (size_t i = 0; i < amount; i++) {
+        *list->last++ = element;
+    }
+}
+
+/* Remove from the end. */
+void dil_instructions_remove(DilInstructions* list)
+{
+    list->last--;
+}
+
+/* Remove from the end and return the removed element. */
+DilInstruction dil_instructions_pop(DilInstructions* list)
+{
+    dil_instructions_remove(list);
+    return *list->last;
+}
+
+/* Remove all the elements. Keeps the memory. */
+void dil_instructions_clear(DilInstructions* list)
+{
+    list->last = list->first;
+}
+
+/* Deallocate memory. */
+void dil_instructions_free(DilInstructions* list)
+{
+    free(list->first);
+    list->first     = NULL;
+    list->last      = NULL;
+    list->allocated = NULL;
+}
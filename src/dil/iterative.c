@@ -0,0 +1,503 @@
+// SPDX-FileCopyrightText: 2022 Cem Geçgel <gecgelcem@outlook.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "dil/frames.c"
+#include "dil/object.c"
+#include "dil/parser.c"
+#include "dil/source.c"
+#include "dil/string.c"
+#include "dil/tree.c"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/* Parses the same grammar as the recursive functions in the parser, but keeps
+ * the rules that can nest without a bound on the heap. Each such rule is a
+ * frame that remembers where it stopped when it called another rule, and
+ * continues from there once that rule returns. The rules that cannot nest are
+ * called recursively as they are. */
+
+/* Report that the rule could not be entered because of the depth limit. */
+void dil_parse__error_depth(DilParseContext* context, char const* symbol)
+{
+    dil_parse__report(
+        context,
+        (DilDiagnostic){
+            .kind    = DIL_DIAGNOSTIC_DEPTH,
+            .limit   = context->options.depth,
+            .symbol  = symbol,
+            .portion = {
+                        .first = context->remaining.first,
+                        .last  = context->remaining.first + 1}
+    });
+}
+
+/* Pointer to the frame of the rule that is being parsed. */
+DilFrame* dil_parse__frame(DilParseContext* context)
+{
+    return dil_frames_finish(&context->frames);
+}
+
+/* Call the rule, and continue the current one from the state after it
+ * returns. */
+void dil_parse__call(
+    DilParseContext* context,
+    unsigned         state,
+    DilSymbol        symbol,
+    char const*      name)
+{
+    dil_parse__frame(context)->state = state;
+
+    bool accept = false;
+    if (dil_parse__decided(context, symbol, &accept)) {
+        context->result = accept;
+        return;
+    }
+
+    // The frame at the bottom is not a rule, so it is not counted.
+    if (context->options.depth != 0 &&
+        dil_frames_size(&context->frames) > context->options.depth) {
+        dil_parse__error_depth(context, name);
+        context->result = false;
+        return;
+    }
+
+    dil_parse__create(context, symbol);
+    dil_frames_add(&context->frames, (DilFrame){.symbol = symbol});
+}
+
+/* End the current rule or remove it from the tree. */
+void dil_parse__finish(DilParseContext* context, bool accept)
+{
+    context->result = dil_parse__return(context, accept);
+    dil_frames_remove(&context->frames);
+}
+
+/* Continue parsing a group. */
+void dil_parse__group_step(DilParseContext* context)
+{
+    switch (dil_parse__frame(context)->state) {
+        case 0:
+            if (!dil_parse__character(context, '(')) {
+                dil_parse__finish(context, false);
+                return;
+            }
+            dil_parse__skip_0(context);
+            dil_parse__call(context, 1, DIL_SYMBOL_PATTERN, "Pattern");
+            return;
+        case 1:
+            if (!context->result) {
+                dil_parse__error_skip(
+                    context,
+                    &dil_parse__skip_0_once,
+                    dil_parse__skip_0_first(),
+                    "Pattern",
+                    "Group");
+                dil_parse__finish(context, true);
+                return;
+            }
+            dil_parse__skip_0(context);
+            dil_parse__call(context, 2, DIL_SYMBOL_PATTERN, "Pattern");
+            return;
+        default:
+            if (context->result) {
+                dil_parse__skip_0(context);
+                dil_parse__call(context, 2, DIL_SYMBOL_PATTERN, "Pattern");
+                return;
+            }
+            if (!dil_parse__character(context, ')')) {
+                dil_parse__error_character(context, ')', "Group");
+            }
+            dil_parse__finish(context, true);
+            return;
+    }
+}
+
+/* Continue parsing a fixed times. */
+void dil_parse__fixed_times_step(DilParseContext* context)
+{
+    if (dil_parse__frame(context)->state == 0) {
+        if (!dil_parse_number(context)) {
+            dil_parse__finish(context, false);
+            return;
+        }
+        dil_parse__skip_0(context);
+        dil_parse__call(context, 1, DIL_SYMBOL_UNIT, "Unit");
+        return;
+    }
+    if (!context->result) {
+        dil_parse__error_skip(
+            context,
+            &dil_parse__skip_0_once,
+            dil_parse__skip_0_first(),
+            "Unit",
+            "FixedTimes");
+    }
+    dil_parse__finish(context, true);
+}
+
+/* Continue parsing a one or more, zero or more or optional, which are the
+ * character and the unit after it. */
+void dil_parse__prefixed_step(
+    DilParseContext* context,
+    char             prefix,
+    char const*      symbol)
+{
+    if (dil_parse__frame(context)->state == 0) {
+        if (!dil_parse__character(context, prefix)) {
+            dil_parse__finish(context, false);
+            return;
+        }
+        dil_parse__skip_0(context);
+        dil_parse__call(context, 1, DIL_SYMBOL_UNIT, "Unit");
+        return;
+    }
+    if (!context->result) {
+        dil_parse__error_skip(
+            context,
+            &dil_parse__skip_0_once,
+            dil_parse__skip_0_first(),
+            "Unit",
+            symbol);
+    }
+    dil_parse__finish(context, true);
+}
+
+/* Continue parsing a unit. */
+void dil_parse__unit_step(DilParseContext* context)
+{
+    DilFrame* frame = dil_parse__frame(context);
+    if (frame->state == 0) {
+        frame->viable = dil_parse__unit_first(context);
+    } else if (context->result) {
+        dil_parse__finish(context, true);
+        return;
+    }
+
+    // States after the first are the index of the alternative to try next.
+    for (unsigned i = frame->state; i < 9; i++) {
+        if (!dil_parse__try(context, frame->viable, i)) {
+            continue;
+        }
+        switch (i) {
+            case 0:
+                context->result = dil_parse_set(context);
+                break;
+            case 1:
+                context->result = dil_parse_not_set(context);
+                break;
+            case 2:
+                context->result = dil_parse_string(context);
+                break;
+            case 3:
+                context->result = dil_parse_reference(context);
+                break;
+            case 4:
+                dil_parse__call(context, i + 1, DIL_SYMBOL_GROUP, "Group");
+                return;
+            case 5:
+                dil_parse__call(
+                    context,
+                    i + 1,
+                    DIL_SYMBOL_FIXED_TIMES,
+                    "FixedTimes");
+                return;
+            case 6:
+                dil_parse__call(
+                    context,
+                    i + 1,
+                    DIL_SYMBOL_ONE_OR_MORE,
+                    "OneOrMore");
+                return;
+            case 7:
+                dil_parse__call(
+                    context,
+                    i + 1,
+                    DIL_SYMBOL_ZERO_OR_MORE,
+                    "ZeroOrMore");
+                return;
+            default:
+                dil_parse__call(
+                    context,
+                    i + 1,
+                    DIL_SYMBOL_OPTIONAL,
+                    "Optional");
+                return;
+        }
+        if (context->result) {
+            dil_parse__finish(context, true);
+            return;
+        }
+    }
+    dil_parse__finish(context, false);
+}
+
+/* Continue parsing an alternative. */
+void dil_parse__alternative_step(DilParseContext* context)
+{
+    switch (dil_parse__frame(context)->state) {
+        case 0:
+            dil_parse__call(context, 1, DIL_SYMBOL_UNIT, "Unit");
+            return;
+        case 1:
+            if (!context->result) {
+                dil_parse__finish(context, false);
+                return;
+            }
+            dil_parse__skip_0(context);
+            dil_parse__call(context, 2, DIL_SYMBOL_UNIT, "Unit");
+            return;
+        default:
+            if (!context->result) {
+                dil_parse__finish(context, true);
+                return;
+            }
+            dil_parse__skip_0(context);
+            dil_parse__call(context, 2, DIL_SYMBOL_UNIT, "Unit");
+            return;
+    }
+}
+
+/* Continue parsing a pattern. */
+void dil_parse__pattern_step(DilParseContext* context)
+{
+    switch (dil_parse__frame(context)->state) {
+        case 0:
+            dil_parse__call(context, 1, DIL_SYMBOL_ALTERNATIVE, "Alternative");
+            return;
+        case 1:
+            if (!context->result) {
+                dil_parse__finish(context, false);
+                return;
+            }
+            break;
+        default:
+            if (!context->result) {
+                dil_parse__error_skip(
+                    context,
+                    &dil_parse__skip_0_once,
+                    dil_parse__skip_0_first(),
+                    "Alternative",
+                    "Pattern");
+                dil_parse__finish(context, true);
+                return;
+            }
+            break;
+    }
+
+    dil_parse__skip_0(context);
+
+    if (!dil_parse__character(context, '|')) {
+        dil_parse__finish(context, true);
+        return;
+    }
+
+    dil_parse__skip_0(context);
+    dil_parse__call(context, 2, DIL_SYMBOL_ALTERNATIVE, "Alternative");
+}
+
+/* Continue parsing a rule. */
+void dil_parse__rule_step(DilParseContext* context)
+{
+    if (dil_parse__frame(context)->state == 0) {
+        if (!dil_parse_identifier(context)) {
+            dil_parse__finish(context, false);
+            return;
+        }
+
+        dil_parse__skip_0(context);
+
+        if (!dil_parse__character(context, '=')) {
+            dil_parse__error_character(context, '=', "Rule");
+            dil_parse__finish(context, true);
+            return;
+        }
+
+        dil_parse__skip_0(context);
+        dil_parse__call(context, 1, DIL_SYMBOL_PATTERN, "Pattern");
+        return;
+    }
+
+    if (!context->result) {
+        dil_parse__error_skip(
+            context,
+            &dil_parse__skip_0_once,
+            dil_parse__skip_0_first(),
+            "Pattern",
+            "Rule");
+        dil_parse__finish(context, true);
+        return;
+    }
+
+    dil_parse__skip_0(context);
+
+    if (!dil_parse__character(context, ';')) {
+        dil_parse__error_character(context, ';', "Rule");
+    }
+    dil_parse__finish(context, true);
+}
+
+/* Continue parsing a start. */
+void dil_parse__start_step(DilParseContext* context)
+{
+    if (dil_parse__frame(context)->state == 0) {
+        static char const      STRING_0[]  = "start";
+        static DilString const TERMINALS_0 = {
+            .first = STRING_0,
+            .last  = STRING_0 + sizeof(STRING_0) - 1};
+
+        if (!dil_parse__string(context, &TERMINALS_0)) {
+            dil_parse__finish(context, false);
+            return;
+        }
+
+        dil_parse__skip_0(context);
+        dil_parse__call(context, 1, DIL_SYMBOL_PATTERN, "Pattern");
+        return;
+    }
+
+    if (!context->result) {
+        dil_parse__error_skip(
+            context,
+            &dil_parse__skip_0_once,
+            dil_parse__skip_0_first(),
+            "Pattern",
+            "Start");
+        dil_parse__finish(context, true);
+        return;
+    }
+
+    dil_parse__skip_0(context);
+
+    if (!dil_parse__character(context, ';')) {
+        dil_parse__error_character(context, ';', "Start");
+        dil_parse__finish(context, false);
+        return;
+    }
+    dil_parse__finish(context, true);
+}
+
+/* Continue parsing a skip. */
+void dil_parse__skip_step(DilParseContext* context)
+{
+    if (dil_parse__frame(context)->state == 0) {
+        static char const      STRING_0[]  = "skip";
+        static DilString const TERMINALS_0 = {
+            .first = STRING_0,
+            .last  = STRING_0 + sizeof(STRING_0) - 1};
+
+        if (!dil_parse__string(context, &TERMINALS_0)) {
+            dil_parse__finish(context, false);
+            return;
+        }
+
+        dil_parse__skip_0(context);
+        dil_parse__call(context, 1, DIL_SYMBOL_PATTERN, "Pattern");
+        return;
+    }
+
+    if (context->result) {
+        dil_parse__skip_0(context);
+    }
+
+    if (!dil_parse__character(context, ';')) {
+        dil_parse__error_character(context, ';', "Skip");
+    }
+    dil_parse__finish(context, true);
+}
+
+/* Continue parsing a statement. */
+void dil_parse__statement_step(DilParseContext* context)
+{
+    DilFrame* frame = dil_parse__frame(context);
+    if (frame->state == 0) {
+        frame->viable = dil_parse__statement_first(context);
+    } else if (context->result) {
+        dil_parse__finish(context, true);
+        return;
+    }
+
+    // States after the first are the index of the alternative to try next.
+    for (unsigned i = frame->state; i < 3; i++) {
+        if (!dil_parse__try(context, frame->viable, i)) {
+            continue;
+        }
+        switch (i) {
+            case 0:
+                dil_parse__call(context, i + 1, DIL_SYMBOL_SKIP, "Skip");
+                return;
+            case 1:
+                dil_parse__call(context, i + 1, DIL_SYMBOL_START, "Start");
+                return;
+            default:
+                dil_parse__call(context, i + 1, DIL_SYMBOL_RULE, "Rule");
+                return;
+        }
+    }
+    dil_parse__finish(context, false);
+}
+
+/* Continue parsing the rule at the top of the stack. */
+void dil_parse__step(DilParseContext* context)
+{
+    switch (dil_parse__frame(context)->symbol) {
+        case DIL_SYMBOL_STATEMENT:
+            dil_parse__statement_step(context);
+            return;
+        case DIL_SYMBOL_SKIP:
+            dil_parse__skip_step(context);
+            return;
+        case DIL_SYMBOL_START:
+            dil_parse__start_step(context);
+            return;
+        case DIL_SYMBOL_RULE:
+            dil_parse__rule_step(context);
+            return;
+        case DIL_SYMBOL_PATTERN:
+            dil_parse__pattern_step(context);
+            return;
+        case DIL_SYMBOL_ALTERNATIVE:
+            dil_parse__alternative_step(context);
+            return;
+        case DIL_SYMBOL_UNIT:
+            dil_parse__unit_step(context);
+            return;
+        case DIL_SYMBOL_OPTIONAL:
+            dil_parse__prefixed_step(context, '?', "Optional");
+            return;
+        case DIL_SYMBOL_ZERO_OR_MORE:
+            dil_parse__prefixed_step(context, '*', "ZeroOrMore");
+            return;
+        case DIL_SYMBOL_ONE_OR_MORE:
+            dil_parse__prefixed_step(context, '+', "OneOrMore");
+            return;
+        case DIL_SYMBOL_FIXED_TIMES:
+            dil_parse__fixed_times_step(context);
+            return;
+        default:
+            dil_parse__group_step(context);
+            return;
+    }
+}
+
+/* Try to parse a statement without nesting the C calls. */
+bool dil_parse__iterative_statement(DilParseContext* context)
+{
+    dil_frames_add(&context->frames, (DilFrame){0});
+    dil_parse__call(context, 0, DIL_SYMBOL_STATEMENT, "Statement");
+    while (dil_frames_size(&context->frames) > 1) {
+        dil_parse__step(context);
+    }
+    dil_frames_remove(&context->frames);
+    return context->result;
+}
+
+/* Parses the source file with the options without nesting the C calls for
+ * the nested rules. Creates the same tree as the recursive parser. */
+DilTree dil_parse_iterative(DilSource source, DilParseOptions options)
+{
+    return dil_parse__process(source, options, &dil_parse__iterative_statement);
+}
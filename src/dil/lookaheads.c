@@ -0,0 +1,176 @@
+// SPDX-FileCopyrightText: 2022 Cem Geçgel <gecgelcem@outlook.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "dil/class.c"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Characters around an expression in a grammar. */
+typedef struct {
+    /* Characters the expression can start with when it consumes any. */
+    DilCharClass first;
+    /* Characters that can come after the expression. */
+    DilCharClass follow;
+    /* Whether the expression can match without consuming a character. */
+    bool nullable;
+    /* Whether the generated parser can accept the expression without
+     * consuming a character. The sequences whose first element is nullable
+     * are only included if all of their elements are, since the others are
+     * decided on their first characters. */
+    bool vacuous;
+    /* Whether the end of the contents can come after the expression. */
+    bool ends;
+} DilLookahead;
+
+/* Contiguous, dynamicly allocated elements. */
+typedef struct {
+    /* Border before the first element. */
+    DilLookahead* first;
+    /* Border after the last element. */
+    DilLookahead* last;
+    /* Border after the last allocated element. */
+    DilLookahead* allocated;
+} DilLookaheads;
+
+/* Amount of elements. */
+size_t dil_lookaheads_size(DilLookaheads const* list)
+{
+    return list->last - list->first;
+}
+
+/* Amount of allocated elements. */
+size_t dil_lookaheads_capacity(DilLookaheads const* list)
+{
+    return list->allocated - list->first;
+}
+
+/* Amount of allocated but unused elements. */
+size_t dil_lookaheads_space(DilLookaheads const* list)
+{
+    return list->allocated - list->last;
+}
+
+/* Whether there are any elements. */
+bool dil_lookaheads_finite(DilLookaheads const* list)
+{
+    return dil_lookaheads_size(list) > 0;
+}
+
+/* Pointer to the element at the index. */
+DilLookahead* dil_lookaheads_at(DilLookaheads const* list, size_t index)
+{
+    return list->first + index;
+}
+
+/* Element at the index. */
+DilLookahead dil_lookaheads_get(DilLookaheads const* list, size_t index)
+{
+    return *dil_lookaheads_at(list, index);
+}
+
+/* Pointer to the first element. */
+DilLookahead* dil_lookaheads_start(DilLookaheads const* list)
+{
+    return list->first;
+}
+
+/* Pointer to the last element. */
+DilLookahead* dil_lookaheads_finish(DilLookaheads const* list)
+{
+    return list->last - 1;
+}
+
+/* Make sure the amount of elements will fit. Grows by at least half if
+ * necessary. */
+void dil_lookaheads_reserve(DilLookaheads* list, size_t amount)
+{
+    size_t space = dil_lookaheads_space(list);
+    if (amount <= space) {
+        return;
+    }
+
+    size_t growth       = amount - space;
+    size_t capacity     = dil_lookaheads_capacity(list);
+    size_t halfCapacity = capacity / 2;
+    if (growth < halfCapacity) {
+        growth = halfCapacity;
+    }
+
+    size_t        newCapacity = capacity + growth;
+    DilLookahead* memory =
+        realloc(list->first, newCapacity * sizeof(DilLookahead));
+
+    list->last      = memory + dil_lookaheads_size(list);
+    list->first     = memory;
+    list->allocated = memory + newCapacity;
+}
+
+/* Add the element to the end. */
+void dil_lookaheads_add(DilLookaheads* list, DilLookahead element)
+{
+    dil_lookaheads_reserve(list, 1);
+    *list->last++ = element;
+}
+
+/* Open space at the index for the amount of element. Returns pointer to the
+ * first opened element. */
+DilLookahead*
+dil_lookaheads_open(DilLookaheads* list, size_t index, size_t amount)
+{
+    dil_lookaheads_reserve(list, amount);
+    DilLookahead* position = list->first + index;
+    memmove(position + amount, position, amount * sizeof(DilLookahead));
+    list->last += amount;
+    return position;
+}
+
+/* Put the element to the given index. */
+void dil_lookaheads_put(DilLookaheads* list, size_t index, DilLookahead element)
+{
+    *dil_lookaheads_open(list, index, 1) = element;
+}
+
+/* Place the element the amount of times to the end. */
+void dil_lookaheads_place(
+    DilLookaheads* list,
+    size_t         amount,
+    DilLookahead   element)
+{
+    dil_lookaheads_reserve(list, amount);
+    for (size_t i = 0; i < amount; i++) {
+        *list->last++ = element;
+    }
+}
+
+/* Remove from the end. */
+void dil_lookaheads_remove(DilLookaheads* list)
+{
+    list->last--;
+}
+
+/* Remove from the end and return the removed element. */
+DilLookahead dil_lookaheads_pop(DilLookaheads* list)
+{
+    dil_lookaheads_remove(list);
+    return *list->last;
+}
+
+/* Remove all the elements. Keeps the memory. */
+void dil_lookaheads_clear(DilLookaheads* list)
+{
+    list->last = list->first;
+}
+
+/* Deallocate memory. */
+void dil_lookaheads_free(DilLookaheads* list)
+{
+    free(list->first);
+    list->first     = NULL;
+    list->last      = NULL;
+    list->allocated = NULL;
+}
@@ -0,0 +1,402 @@
+// SPDX-FileCopyrightText: 2022 Cem Geçgel <gecgelcem@outlook.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "dil/analysis.c"
+#include "dil/expressions.c"
+#include "dil/grammar.c"
+#include "dil/indices.c"
+#include "dil/instructions.c"
+#include "dil/memo.c"
+#include "dil/object.c"
+#include "dil/parser.c"
+#include "dil/points.c"
+#include "dil/program.c"
+#include "dil/source.c"
+#include "dil/string.c"
+#include "dil/tree.c"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Dispatch with a jump to the label of each operation where the compiler can
+// take the addresses of labels, and with a switch otherwise.
+#if defined(__GNUC__)
+#    define DIL_MACHINE_LABELS
+#    define DIL_MACHINE_LABEL(opcode)     __extension__ && operation_##opcode
+#    define DIL_MACHINE_OPERATION(opcode) operation_##opcode:
+#    define DIL_MACHINE_NEXT() \
+        __extension__({ goto* OPERATIONS[instruction->opcode]; })
+#else
+#    define DIL_MACHINE_OPERATION(opcode) case opcode:
+#    define DIL_MACHINE_NEXT()            goto dispatch
+#endif
+
+/* Process that parses a source file by running a program. */
+typedef struct {
+    /* Context of the parsing process. It is the first member, so the skip
+     * that is given to the runtime finds the machine from the context. */
+    DilParseContext context;
+    /* Program that is run. */
+    DilProgram const* program;
+    /* Called functions and the choices in them. */
+    DilPoints points;
+    /* Skip style of the skip that is given to the runtime. */
+    size_t style;
+} DilMachine;
+
+bool dil_machine__run(DilMachine* machine, size_t function);
+
+/* Whether the pattern can be accepted at the remaining contents, since it
+ * can match nothing or starts with the remaining character. */
+bool dil_machine__viable(DilMachine const* machine, size_t pattern)
+{
+    DilString const*    remaining = &machine->context.remaining;
+    DilLookahead const* lookahead = dil_analysis_at(
+        &machine->program->analysis,
+        pattern);
+    return lookahead->vacuous ||
+           (dil_string_finite(remaining) &&
+            dil_char_class_contains(&lookahead->first, *remaining->first));
+}
+
+/* Try to skip in the style once. Fails if nothing is skipped. */
+bool dil_machine__once(DilMachine* machine, size_t style)
+{
+    DilParseContext* context = &machine->context;
+    char const*      first   = context->remaining.first;
+    bool             skip    = context->skip;
+    if (!dil_machine__viable(
+            machine,
+            dil_indices_get(&machine->program->grammar.skips, style))) {
+        return false;
+    }
+
+    context->skip = true;
+    bool accept   = dil_machine__run(
+        machine,
+        dil_program_skip(machine->program, style));
+    context->skip = skip;
+    return accept && context->remaining.first != first;
+}
+
+/* Try to skip once in the style of the machine of the context. */
+bool dil_machine__skip_once(DilParseContext* context)
+{
+    DilMachine* machine = (DilMachine*)context;
+    return dil_machine__once(machine, machine->style);
+}
+
+/* Report that the expression at the index was expected by the function the
+ * last call point is of. */
+void dil_machine__report(DilMachine* machine, size_t index)
+{
+    DilParseContext*     context    = &machine->context;
+    DilProgram const*    program    = machine->program;
+    DilExpression const* expression = dil_grammar_at(&program->grammar, index);
+    DilExpression const* head       = dil_program_head(program, expression);
+    DilPoint const*      point      = dil_points_finish(&machine->points);
+    while (!point->call) {
+        point--;
+    }
+    char const* symbol = dil_program_name(program, point->function);
+    if (head == NULL || expression->kind == DIL_EXPRESSION_CHOICE) {
+        dil_parse__error_unexpected(context, symbol);
+        return;
+    }
+
+    size_t head_index = head - program->grammar.expressions.first;
+    switch (head->kind) {
+        case DIL_EXPRESSION_CHARACTER:
+            dil_parse__error_character(context, head->character, symbol);
+            break;
+        case DIL_EXPRESSION_SET:
+            dil_parse__error_set(
+                context,
+                dil_program_text(program, head_index),
+                symbol);
+            break;
+        case DIL_EXPRESSION_NOT_SET:
+            dil_parse__error_not_set(
+                context,
+                dil_program_text(program, head_index),
+                symbol);
+            break;
+        case DIL_EXPRESSION_STRING: {
+            DilString text = dil_grammar_text(&program->grammar, head);
+            dil_parse__error_string(context, &text, symbol);
+            break;
+        }
+        default: {
+            DilRule const* current =
+                dil_rules_at(&program->functions, point->function);
+            char const* expected = dil_program_name(program, head->rule);
+            if (!current->skipped) {
+                dil_parse__error_reference(context, expected, symbol);
+                break;
+            }
+            size_t style   = machine->style;
+            machine->style = current->skip;
+            dil_parse__error_skip(
+                context,
+                &dil_machine__skip_once,
+                &dil_analysis_at(
+                     &program->analysis,
+                     dil_indices_get(&program->grammar.skips, current->skip))
+                     ->first,
+                expected,
+                symbol);
+            machine->style = style;
+            break;
+        }
+    }
+}
+
+/* Run the function until it returns. Returns whether it was accepted. Calls
+ * to the rules are points on the stack of the machine instead of recursing,
+ * but the skips recurse. */
+bool dil_machine__run(DilMachine* machine, size_t function)
+{
+#if defined(DIL_MACHINE_LABELS)
+    static void* const OPERATIONS[DIL_OPCODE_COUNT] = {
+        [DIL_OPCODE_CHARACTER]   = DIL_MACHINE_LABEL(DIL_OPCODE_CHARACTER),
+        [DIL_OPCODE_SET]         = DIL_MACHINE_LABEL(DIL_OPCODE_SET),
+        [DIL_OPCODE_NOT_SET]     = DIL_MACHINE_LABEL(DIL_OPCODE_NOT_SET),
+        [DIL_OPCODE_STRING]      = DIL_MACHINE_LABEL(DIL_OPCODE_STRING),
+        [DIL_OPCODE_FIRST]       = DIL_MACHINE_LABEL(DIL_OPCODE_FIRST),
+        [DIL_OPCODE_CALL]        = DIL_MACHINE_LABEL(DIL_OPCODE_CALL),
+        [DIL_OPCODE_SET_RUN]     = DIL_MACHINE_LABEL(DIL_OPCODE_SET_RUN),
+        [DIL_OPCODE_NOT_SET_RUN] = DIL_MACHINE_LABEL(DIL_OPCODE_NOT_SET_RUN),
+        [DIL_OPCODE_SKIP]        = DIL_MACHINE_LABEL(DIL_OPCODE_SKIP),
+        [DIL_OPCODE_JUMP]        = DIL_MACHINE_LABEL(DIL_OPCODE_JUMP),
+        [DIL_OPCODE_CHOICE]      = DIL_MACHINE_LABEL(DIL_OPCODE_CHOICE),
+        [DIL_OPCODE_COMMIT]      = DIL_MACHINE_LABEL(DIL_OPCODE_COMMIT),
+        [DIL_OPCODE_REPEAT]      = DIL_MACHINE_LABEL(DIL_OPCODE_REPEAT),
+        [DIL_OPCODE_FAIL]        = DIL_MACHINE_LABEL(DIL_OPCODE_FAIL),
+        [DIL_OPCODE_ERROR]       = DIL_MACHINE_LABEL(DIL_OPCODE_ERROR),
+        [DIL_OPCODE_RETURN]      = DIL_MACHINE_LABEL(DIL_OPCODE_RETURN)};
+#endif
+
+    DilParseContext*      context     = &machine->context;
+    DilProgram const*     program     = machine->program;
+    DilGrammar const*     grammar     = &program->grammar;
+    DilPoints*            points      = &machine->points;
+    DilInstruction const* code        = program->code.first;
+    size_t                base        = dil_points_size(points);
+    DilInstruction const* instruction = code;
+    DilPoint              point       = {0};
+    bool                  accept      = false;
+
+    dil_points_add(points, (DilPoint){.function = function, .call = true});
+    instruction += dil_indices_get(&program->addresses, function);
+
+#if defined(DIL_MACHINE_LABELS)
+    DIL_MACHINE_NEXT();
+#else
+dispatch:
+    switch (instruction->opcode) {
+#endif
+    // The characters are looked at before the runtime is called, which only
+    // creates the node of a terminal to remove it if it does not match.
+    DIL_MACHINE_OPERATION(DIL_OPCODE_CHARACTER)
+    {
+        accept = dil_string_finite(&context->remaining) &&
+                 *context->remaining.first == (char)instruction->operand &&
+                 dil_parse__character(context, (char)instruction->operand);
+        instruction += 1 + accept;
+        DIL_MACHINE_NEXT();
+    }
+    DIL_MACHINE_OPERATION(DIL_OPCODE_SET)
+    {
+        DilCharClass const* set =
+            &dil_grammar_at(grammar, instruction->operand)->set;
+        accept = dil_string_finite(&context->remaining) &&
+                 dil_char_class_contains(set, *context->remaining.first) &&
+                 dil_parse__set(context, set);
+        instruction += 1 + accept;
+        DIL_MACHINE_NEXT();
+    }
+    DIL_MACHINE_OPERATION(DIL_OPCODE_NOT_SET)
+    {
+        DilCharClass const* set =
+            &dil_grammar_at(grammar, instruction->operand)->set;
+        accept = dil_string_finite(&context->remaining) &&
+                 !dil_char_class_contains(set, *context->remaining.first) &&
+                 dil_parse__not_set(context, set);
+        instruction += 1 + accept;
+        DIL_MACHINE_NEXT();
+    }
+    DIL_MACHINE_OPERATION(DIL_OPCODE_STRING)
+    {
+        DilString text = dil_grammar_text(
+            grammar,
+            dil_grammar_at(grammar, instruction->operand));
+        instruction += 1 + dil_parse__string(context, &text);
+        DIL_MACHINE_NEXT();
+    }
+    DIL_MACHINE_OPERATION(DIL_OPCODE_FIRST)
+    {
+        instruction += 1 + dil_machine__viable(machine, instruction->operand);
+        DIL_MACHINE_NEXT();
+    }
+    DIL_MACHINE_OPERATION(DIL_OPCODE_CALL)
+    {
+        size_t    rule   = instruction->operand;
+        DilSymbol symbol = (DilSymbol)(DIL_SYMBOL__START + 1 + rule);
+        // Fail without creating the node if the rule cannot start here.
+        if (!dil_machine__viable(
+                machine,
+                dil_rules_at(&grammar->rules, rule)->pattern)) {
+            if (context->options.statistics != NULL) {
+                context->options.statistics->avoided++;
+            }
+            instruction++;
+            DIL_MACHINE_NEXT();
+        }
+        if (dil_parse__decided(context, symbol, &accept)) {
+            instruction += 1 + accept;
+            DIL_MACHINE_NEXT();
+        }
+        dil_parse__create(context, symbol);
+        dil_points_add(
+            points,
+            (DilPoint){
+                .address  = instruction - code,
+                .function = rule,
+                .call     = true,
+                .node     = true});
+        instruction = code + dil_indices_get(&program->addresses, rule);
+        DIL_MACHINE_NEXT();
+    }
+    DIL_MACHINE_OPERATION(DIL_OPCODE_SET_RUN)
+    {
+        dil_parse__set_run(
+            context,
+            &dil_grammar_at(grammar, instruction->operand)->set);
+        instruction++;
+        DIL_MACHINE_NEXT();
+    }
+    DIL_MACHINE_OPERATION(DIL_OPCODE_NOT_SET_RUN)
+    {
+        dil_parse__not_set_run(
+            context,
+            &dil_grammar_at(grammar, instruction->operand)->set);
+        instruction++;
+        DIL_MACHINE_NEXT();
+    }
+    DIL_MACHINE_OPERATION(DIL_OPCODE_SKIP)
+    {
+        while (dil_machine__once(machine, instruction->operand)) {}
+        instruction++;
+        DIL_MACHINE_NEXT();
+    }
+    DIL_MACHINE_OPERATION(DIL_OPCODE_JUMP)
+    {
+        instruction = code + instruction->operand;
+        DIL_MACHINE_NEXT();
+    }
+    DIL_MACHINE_OPERATION(DIL_OPCODE_CHOICE)
+    {
+        dil_points_add(
+            points,
+            (DilPoint){
+                .address  = instruction->operand,
+                .position = context->remaining.first});
+        instruction++;
+        DIL_MACHINE_NEXT();
+    }
+    DIL_MACHINE_OPERATION(DIL_OPCODE_COMMIT)
+    {
+        dil_points_remove(points);
+        instruction = code + instruction->operand;
+        DIL_MACHINE_NEXT();
+    }
+    DIL_MACHINE_OPERATION(DIL_OPCODE_REPEAT)
+    {
+        point = dil_points_pop(points);
+        instruction++;
+        if (context->remaining.first != point.position) {
+            instruction = code + instruction[-1].operand;
+        }
+        DIL_MACHINE_NEXT();
+    }
+    DIL_MACHINE_OPERATION(DIL_OPCODE_FAIL)
+    {
+        point = dil_points_pop(points);
+        if (!point.call) {
+            context->remaining.first = point.position;
+            instruction              = code + point.address;
+            DIL_MACHINE_NEXT();
+        }
+        if (point.node) {
+            (void)dil_parse__return(context, false);
+        }
+        if (dil_points_size(points) == base) {
+            return false;
+        }
+        instruction = code + point.address + 1;
+        DIL_MACHINE_NEXT();
+    }
+    DIL_MACHINE_OPERATION(DIL_OPCODE_ERROR)
+    {
+        dil_machine__report(machine, instruction->operand);
+        // Accept the function without the choices that are left in it.
+        while (!dil_points_finish(points)->call) {
+            dil_points_remove(points);
+        }
+        goto accept;
+    }
+    DIL_MACHINE_OPERATION(DIL_OPCODE_RETURN)
+accept:
+    {
+        point = dil_points_pop(points);
+        if (point.node) {
+            (void)dil_parse__return(context, true);
+        }
+        if (dil_points_size(points) == base) {
+            return true;
+        }
+        instruction = code + point.address + 2;
+        DIL_MACHINE_NEXT();
+    }
+#if !defined(DIL_MACHINE_LABELS)
+    default:
+        return false;
+    }
+#endif
+}
+
+/* Parses the source file with the options by running the program. The tree
+ * is the same as the one of the exact parser that would be generated from
+ * the grammar of the program. */
+DilTree dil_machine_parse_with(
+    DilProgram const* program,
+    DilSource         source,
+    DilParseOptions   options)
+{
+    DilMachine machine = {
+        .context = {
+                    .builder   = {.built = &machine.context.built},
+                    .remaining = source.contents,
+                    .source    = source,
+                    .options   = options},
+        .program = program
+    };
+
+    if (options.memo != NULL) {
+        dil_memo_clear(options.memo);
+    }
+
+    dil_parse__open(&machine.context);
+    (void)dil_machine__run(&machine, dil_program_start(program));
+    dil_parse__close(&machine.context);
+    dil_points_free(&machine.points);
+    return dil_parse__conclude(&machine.context);
+}
+
+/* Parses the source file by running the program. */
+DilTree dil_machine_parse(DilProgram const* program, DilSource source)
+{
+    return dil_machine_parse_with(program, source, (DilParseOptions){0});
+}
@@ -0,0 +1,246 @@
+// SPDX-FileCopyrightText: 2022 Cem Geçgel <gecgelcem@outlook.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "dil/indices.c"
+#include "dil/object.c"
+#include "dil/tree.c"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Remembered result of parsing a symbol at an offset. */
+typedef struct {
+    /* Parsed symbol. */
+    DilSymbol symbol;
+    /* Offset of the border before the symbol in the source contents. */
+    size_t offset;
+    /* Offset of the border after the symbol if it was accepted. */
+    size_t end;
+    /* Index of the first node of the subtree in the built tree, or in the
+     * memo nodes after the built tree removed it. */
+    size_t first;
+    /* Amount of nodes in the subtree. */
+    size_t amount;
+    /* Amount of terminals in the subtree that were parsed without nodes. */
+    size_t omitted;
+    /* Amount of errors the symbol reported. */
+    size_t errors;
+    /* Index of the first diagnostic of the errors. */
+    size_t diagnostic;
+    /* Amount of the errors that were recorded as diagnostics. */
+    size_t recorded;
+    /* Whether the symbol was accepted. */
+    bool accept;
+    /* Whether the subtree is in the built tree. */
+    bool built;
+    /* Whether the entry holds a result. */
+    bool used;
+} DilMemoEntry;
+
+/* Results of parsing symbols keyed by the symbol and the offset. */
+typedef struct {
+    /* Open addressed entries. Capacity is zero or a power of two. */
+    DilMemoEntry* entries;
+    /* Amount of allocated entries. */
+    size_t capacity;
+    /* Amount of used entries. */
+    size_t size;
+    /* Copies of the subtrees of the accepted symbols that the built tree
+     * removed. */
+    DilTree nodes;
+    /* Offsets and symbols of the accepted symbols whose subtrees are in the
+     * built tree, in the order they were remembered. */
+    DilIndices kept;
+    /* Amount of lookups that found a result. */
+    size_t hits;
+    /* Amount of lookups that did not find a result. */
+    size_t misses;
+} DilMemo;
+
+/* Index of the entry the key hashes to. */
+size_t dil_memo_hash(DilMemo const* memo, DilSymbol symbol, size_t offset)
+{
+    size_t const MULTIPLIER = 0x9E3779B97F4A7C15ULL;
+    size_t       key        = offset * 32 + (size_t)symbol;
+    return (key * MULTIPLIER >> 16) & (memo->capacity - 1);
+}
+
+/* Pointer to the entry with the key, or to the unused entry it would go to. */
+DilMemoEntry*
+dil_memo_probe(DilMemo const* memo, DilSymbol symbol, size_t offset)
+{
+    size_t        index = dil_memo_hash(memo, symbol, offset);
+    DilMemoEntry* entry = memo->entries + index;
+    while (entry->used &&
+           (entry->symbol != symbol || entry->offset != offset)) {
+        index = (index + 1) & (memo->capacity - 1);
+        entry = memo->entries + index;
+    }
+    return entry;
+}
+
+/* Double the capacity and rehash the entries. */
+void dil_memo_grow(DilMemo* memo)
+{
+    DilMemoEntry* entries  = memo->entries;
+    size_t        capacity = memo->capacity;
+
+    memo->capacity = capacity == 0 ? 64 : capacity * 2;
+    memo->entries  = calloc(memo->capacity, sizeof(DilMemoEntry));
+
+    for (size_t i = 0; i < capacity; i++) {
+        if (entries[i].used) {
+            *dil_memo_probe(memo, entries[i].symbol, entries[i].offset) =
+                entries[i];
+        }
+    }
+    free(entries);
+}
+
+/* Find the result of the symbol at the offset. Returns null if there is none.
+ * The pointer is valid until the next record. */
+DilMemoEntry const*
+dil_memo_find(DilMemo* memo, DilSymbol symbol, size_t offset)
+{
+    if (memo->size != 0) {
+        DilMemoEntry const* entry = dil_memo_probe(memo, symbol, offset);
+        if (entry->used) {
+            memo->hits++;
+            return entry;
+        }
+    }
+    memo->misses++;
+    return NULL;
+}
+
+/* Remember a rejected symbol at the offset. */
+void dil_memo_reject(DilMemo* memo, DilSymbol symbol, size_t offset)
+{
+    if (2 * (memo->size + 1) > memo->capacity) {
+        dil_memo_grow(memo);
+    }
+    DilMemoEntry* entry = dil_memo_probe(memo, symbol, offset);
+    if (!entry->used) {
+        memo->size++;
+    }
+    *entry = (DilMemoEntry){
+        .symbol = symbol,
+        .offset = offset,
+        .used   = true};
+}
+
+/* Remember an accepted symbol at the offset, whose subtree is at the index
+ * in the built tree. The nodes are not copied, since the built tree keeps
+ * them unless it removes them, which must be released first. */
+void dil_memo_accept(DilMemo* memo, DilMemoEntry result)
+{
+    if (2 * (memo->size + 1) > memo->capacity) {
+        dil_memo_grow(memo);
+    }
+    DilMemoEntry* entry = dil_memo_probe(memo, result.symbol, result.offset);
+    if (!entry->used) {
+        memo->size++;
+    }
+    result.accept = true;
+    result.built  = true;
+    result.used   = true;
+    *entry        = result;
+    dil_indices_add(&memo->kept, result.offset);
+    dil_indices_add(&memo->kept, (size_t)result.symbol);
+}
+
+/* Copy the subtrees of the remembered symbols that are in the built tree
+ * from the index on to the memo nodes, since the built tree removes them.
+ * They are the last ones that were remembered, because a symbol is
+ * remembered after all the nodes in its subtree were built. */
+void dil_memo_release(DilMemo* memo, DilTree const* built, size_t index)
+{
+    size_t released = dil_indices_size(&memo->kept);
+    size_t first    = dil_tree_size(built);
+    while (released > 0) {
+        DilMemoEntry const* entry = dil_memo_probe(
+            memo,
+            (DilSymbol)dil_indices_get(&memo->kept, released - 1),
+            dil_indices_get(&memo->kept, released - 2));
+        if (entry->built && entry->first < index) {
+            break;
+        }
+        if (entry->built && entry->first < first) {
+            first = entry->first;
+        }
+        released -= 2;
+    }
+    if (released == dil_indices_size(&memo->kept)) {
+        return;
+    }
+
+    size_t start  = dil_tree_size(&memo->nodes);
+    size_t amount = dil_tree_size(built) - first;
+    dil_tree_reserve(&memo->nodes, amount);
+    memcpy(
+        memo->nodes.last,
+        dil_tree_at(built, first),
+        amount * sizeof(DilNode));
+    memo->nodes.last += amount;
+    for (size_t i = released; i < dil_indices_size(&memo->kept); i += 2) {
+        DilMemoEntry* entry = dil_memo_probe(
+            memo,
+            (DilSymbol)dil_indices_get(&memo->kept, i + 1),
+            dil_indices_get(&memo->kept, i));
+        if (entry->built) {
+            entry->first = start + entry->first - first;
+            entry->built = false;
+        }
+    }
+    memo->kept.last = dil_indices_at(&memo->kept, released);
+}
+
+/* Remove all the results, but keep the counters. Keeps the memory. */
+void dil_memo_forget(DilMemo* memo)
+{
+    if (memo->entries != NULL) {
+        memset(memo->entries, 0, memo->capacity * sizeof(DilMemoEntry));
+    }
+    memo->size = 0;
+    dil_tree_clear(&memo->nodes);
+    dil_indices_clear(&memo->kept);
+}
+
+/* Remove all the results and reset the counters. Keeps the memory. */
+void dil_memo_clear(DilMemo* memo)
+{
+    dil_memo_forget(memo);
+    memo->hits   = 0;
+    memo->misses = 0;
+}
+
+/* Deallocate memory. */
+void dil_memo_free(DilMemo* memo)
+{
+    free(memo->entries);
+    memo->entries  = NULL;
+    memo->capacity = 0;
+    memo->size     = 0;
+    dil_tree_free(&memo->nodes);
+    dil_indices_free(&memo->kept);
+}
+
+/* Print the counters. */
+void dil_memo_print(FILE* stream, DilMemo const* memo)
+{
+    size_t lookups = memo->hits + memo->misses;
+    (void)fprintf(
+        stream,
+        "Memo: %llu hits, %llu misses, %.2f%% hit rate, %llu entries, %llu "
+        "nodes.\n",
+        memo->hits,
+        memo->misses,
+        lookups == 0 ? 0.0 : 100.0 * (double)memo->hits / (double)lookups,
+        memo->size,
+        dil_tree_size(&memo->nodes));
+}
@@ -0,0 +1,239 @@
+// SPDX-FileCopyrightText: 2022 Cem Geçgel <gecgelcem@outlook.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "dil/boundary.c"
+#include "dil/builder.c"
+#include "dil/indices.c"
+#include "dil/memo.c"
+#include "dil/parser.c"
+#include "dil/source.c"
+#include "dil/string.c"
+#include "dil/tree.c"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <threads.h>
+
+/* Least amount of characters a thread parses. Smaller files are parsed by
+ * fewer threads. */
+#define DIL_PARSE_PARALLEL_MINIMUM ((size_t)1 << 16)
+
+/* Part of the source file that is parsed by a thread. */
+typedef struct {
+    /* Context the part is parsed in, which does not print the errors or add
+     * them to the sink. */
+    DilParseContext context;
+    /* Memo of the thread if the parsing process uses one. */
+    DilMemo memo;
+    /* Counters of the thread if the parsing process counts. */
+    DilParseStatistics statistics;
+    /* Amount of rules the part may enter if the budget has fuel, which is
+     * its share by its size. */
+    size_t fuel;
+    /* Whether the part is the last one in the source file. */
+    bool last;
+    /* Whether the part was parsed the way the whole source file would be. */
+    bool clean;
+} DilParsePart;
+
+/* Parse the statements in the part under a temporary root. */
+int dil_parse__part(void* argument)
+{
+    DilParsePart*    part    = argument;
+    DilParseContext* context = &part->context;
+    context->builder.built   = &context->built;
+
+    dil_parse__open(context);
+    if (part->last) {
+        (void)dil_parse__statements(context, &dil_parse_statement);
+    } else {
+        // The statement parser is only called at the end of the source file.
+        dil_parse__skip_0(context);
+        while (dil_string_finite(&context->remaining) &&
+               dil_parse_statement(context)) {
+            dil_parse__skip_0(context);
+        }
+    }
+    dil_parse__close(context);
+
+    // Without errors, the last statement ended with the semicolon before the
+    // part's end, so the following characters could not change it.
+    part->clean = context->source.error == 0;
+    return 0;
+}
+
+/* Amount of rules the part entered from its share of the fuel. */
+size_t dil_parse__part_spent(DilParsePart const* part, size_t fuel)
+{
+    size_t steps = part->context.steps - (fuel - part->fuel);
+    return steps < part->fuel ? steps : part->fuel;
+}
+
+/* Parses the source file with the options on the amount of threads. Finds
+ * the boundaries between the statements first, and parses a part between
+ * them on each thread. The trees are joined under a single __start__ symbol.
+ * Falls back to parsing the source file on this thread when there is an
+ * error, so the tree and the errors are the same as dil_parse_with unless
+ * the budget runs out. The work of every thread is thrown away then, so a
+ * source file with a single error takes the time of the parallel parse and
+ * a sequential one after it. Each thread uses a memo of its own if the options
+ * have one, and its counters are added to the memo and the statistics of
+ * the options. The fuel of the budget is shared by the parts by their
+ * sizes, and the fallback only gets what they left, so together they enter
+ * at most as many rules as the fuel. */
+DilTree
+dil_parse_parallel(DilSource source, DilParseOptions options, size_t threads)
+{
+    size_t size = dil_string_size(&source.contents);
+    if (threads > size / DIL_PARSE_PARALLEL_MINIMUM) {
+        threads = size / DIL_PARSE_PARALLEL_MINIMUM;
+    }
+    if (threads < 2) {
+        return dil_parse_with(source, options);
+    }
+
+    // Cut the source file at the first boundary after each equal share.
+    DilParsePart* parts   = calloc(threads, sizeof(DilParsePart));
+    DilBoundary   scanner = {0};
+    char const*   first   = source.contents.first;
+    size_t        amount  = 0;
+    for (size_t i = 1; i <= threads; i++) {
+        char const* last = source.contents.last;
+        if (i < threads) {
+            char const* share = source.contents.first + size / threads * i;
+            char const* found = first;
+            do {
+                found = dil_boundary_next(&scanner, found, last);
+            } while (found != NULL && found < share);
+            if (found != NULL) {
+                last = found;
+            }
+        }
+
+        DilParsePart* part = &parts[amount++];
+        part->last         = last == source.contents.last;
+        part->context      = (DilParseContext){
+                 .remaining = {.first = first, .last = last},
+                 .source    = source,
+                 .options   = options};
+        part->context.options.quiet = true;
+        part->context.options.sink  = NULL;
+        if (options.budget != NULL && options.budget->fuel != 0) {
+            // Start the steps where the part has its share of the fuel left.
+            size_t fuel         = options.budget->fuel;
+            double share        = (double)(last - first) / (double)size;
+            part->fuel          = (size_t)((double)fuel * share);
+            part->context.steps = fuel - part->fuel;
+        }
+        if (options.memo != NULL) {
+            part->context.options.memo = &part->memo;
+        }
+        if (options.statistics != NULL) {
+            part->context.options.statistics = &part->statistics;
+        }
+
+        if (part->last) {
+            break;
+        }
+        first = last;
+    }
+
+    thrd_t* workers = calloc(amount, sizeof(thrd_t));
+    bool*   started = calloc(amount, sizeof(bool));
+    for (size_t i = 1; i < amount; i++) {
+        started[i] = thrd_create(&workers[i], &dil_parse__part, &parts[i]) ==
+                     thrd_success;
+    }
+    (void)dil_parse__part(&parts[0]);
+
+    bool clean = parts[0].clean;
+    for (size_t i = 1; i < amount; i++) {
+        if (started[i]) {
+            (void)thrd_join(workers[i], NULL);
+        } else {
+            (void)dil_parse__part(&parts[i]);
+        }
+        clean = clean && parts[i].clean;
+    }
+
+    // Join the parts' statements under a single root.
+    DilTree result = {0};
+    size_t  spent  = 0;
+    if (clean) {
+        size_t total = 0;
+        for (size_t i = 0; i < amount; i++) {
+            total += dil_tree_size(&parts[i].context.built) - 1;
+        }
+        dil_tree_reserve(&result, total + 1);
+        dil_tree_add(
+            &result,
+            (DilNode){
+                .object = {
+                           .symbol = DIL_SYMBOL__START,
+                           .value  = source.contents}
+        });
+        for (size_t i = 0; i < amount; i++) {
+            DilTree const* built = &parts[i].context.built;
+            size_t         nodes = dil_tree_size(built) - 1;
+            memcpy(result.last, built->first + 1, nodes * sizeof(DilNode));
+            result.last += nodes;
+            result.first->childeren += built->first->childeren;
+        }
+
+        if (options.statistics != NULL) {
+            for (size_t i = 0; i < amount; i++) {
+                options.statistics->avoided += parts[i].statistics.avoided;
+                options.statistics->omitted += parts[i].statistics.omitted;
+                options.statistics->collapsed +=
+                    parts[i].statistics.collapsed;
+                options.statistics->recall_hits +=
+                    parts[i].statistics.recall_hits;
+                options.statistics->recall_misses +=
+                    parts[i].statistics.recall_misses;
+            }
+        }
+        if (options.errors != NULL) {
+            dil_indices_clear(options.errors);
+        }
+        if (options.memo != NULL) {
+            dil_memo_clear(options.memo);
+            for (size_t i = 0; i < amount; i++) {
+                options.memo->hits += parts[i].memo.hits;
+                options.memo->misses += parts[i].memo.misses;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < amount; i++) {
+        if (options.budget != NULL && options.budget->fuel != 0) {
+            spent += dil_parse__part_spent(&parts[i], options.budget->fuel);
+        }
+        DilTree built = dil_parse__conclude(&parts[i].context);
+        dil_tree_free(&built);
+        dil_memo_free(&parts[i].memo);
+    }
+    free(started);
+    free(workers);
+    free(parts);
+
+    if (clean) {
+        return result;
+    }
+
+    // Parse the whole source file with the fuel the parts left.
+    DilParseContext initial = {
+        .builder   = {.built = &initial.built},
+        .remaining = source.contents,
+        .source    = source,
+        .options   = options,
+        .steps     = spent};
+    if (options.memo != NULL) {
+        dil_memo_clear(options.memo);
+    }
+    dil_parse__start(&initial, &dil_parse_statement);
+    return dil_parse__conclude(&initial);
+}
@@ -5,16 +5,139 @@
 
 #include "dil/buffer.c"
 #include "dil/builder.c"
+#include "dil/class.c"
+#include "dil/diagnostics.c"
+#include "dil/frames.c"
+#include "dil/memo.c"
 #include "dil/object.c"
+#include "dil/recall.c"
+#include "dil/scan.c"
+#include "dil/scanner.c"
+#include "dil/sink.c"
 #include "dil/source.c"
 #include "dil/string.c"
 #include "dil/tree.c"
 
+#include <limits.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdatomic.h>
 #include <stdio.h>
+#include <time.h>
 #include <winnls.h>
 
+/* Counters of the parsing process. */
+typedef struct {
+    /* Amount of alternatives that were not tried because they cannot start
+     * with the remaining character. Each would have created at least a node
+     * and removed it. */
+    size_t avoided;
+    /* Amount of terminal nodes the tree would have if it was not compact. */
+    size_t omitted;
+    /* Amount of nodes the tree would have in addition if the rules a
+     * generated parser collapsed kept them. */
+    size_t collapsed;
+    /* Amount of times a generated parser found that a rule it remembers was
+     * rejected at the offset before, so it did not try the rule again. */
+    size_t recall_hits;
+    /* Amount of times it did not find that, so it tried the rule. */
+    size_t recall_misses;
+    /* Amount of errors that were found. */
+    size_t errors;
+    /* Amount of parsing processes that were stopped by their budget. */
+    size_t exhausted;
+} DilParseStatistics;
+
+/* Amount of rules between the checks of the clock and the cancellation. */
+#define DIL_PARSE_BUDGET_INTERVAL 1024
+
+/* Limits of a parsing process. When one is reached, every rule is rejected,
+ * so the parser returns quickly with the tree it built until then and an
+ * error. */
+typedef struct {
+    /* Maximum amount of rules each process enters, or zero for no limit. */
+    size_t fuel;
+    /* Time the processes must stop at, or zero for no limit. */
+    struct timespec deadline;
+    /* Whether the processes must stop, which can be set from any thread. */
+    atomic_bool cancelled;
+} DilParseBudget;
+
+/* Set the deadline of the budget to the amount of seconds from now. */
+void dil_parse_budget_timeout(DilParseBudget* budget, double seconds)
+{
+    (void)timespec_get(&budget->deadline, TIME_UTC);
+    double whole = (double)(time_t)seconds;
+    budget->deadline.tv_sec += (time_t)seconds;
+    budget->deadline.tv_nsec += (long)((seconds - whole) * 1e9);
+    if (budget->deadline.tv_nsec >= 1000000000) {
+        budget->deadline.tv_sec++;
+        budget->deadline.tv_nsec -= 1000000000;
+    }
+}
+
+/* Whether the deadline of the budget has passed. */
+bool dil_parse_budget_late(DilParseBudget const* budget)
+{
+    if (budget->deadline.tv_sec == 0 && budget->deadline.tv_nsec == 0) {
+        return false;
+    }
+    struct timespec now;
+    (void)timespec_get(&now, TIME_UTC);
+    return now.tv_sec > budget->deadline.tv_sec ||
+           (now.tv_sec == budget->deadline.tv_sec &&
+            now.tv_nsec >= budget->deadline.tv_nsec);
+}
+
+/* Stop the processes that use the budget. Can be called from any thread. */
+void dil_parse_budget_cancel(DilParseBudget* budget)
+{
+    atomic_store_explicit(&budget->cancelled, true, memory_order_relaxed);
+}
+
+/* Options of the parsing process. */
+typedef struct {
+    /* Table to memoize the parsed rules in, or null to parse without it. */
+    DilMemo* memo;
+    /* Counters to add to, or null to parse without counting. */
+    DilParseStatistics* statistics;
+    /* Whether the terminals only extend the rule they are in instead of
+     * creating a node each. */
+    bool compact;
+    /* Maximum amount of rules the iterative parser nests, or zero for no
+     * limit. */
+    size_t depth;
+    /* Whether the errors are only counted instead of printed. */
+    bool quiet;
+    /* Sink to add the errors to when the parsing process ends, or null to
+     * print them then. */
+    DilSink* sink;
+    /* Limits to stop the parsing process at, or null to parse until the
+     * end. */
+    DilParseBudget* budget;
+    /* Offset of the statement each error is in, or null to not record them.
+     * The errors before the first statement are at zero, and the ones in the
+     * skip after a statement are in it. Recorded when the whole source file
+     * is parsed at once, and needed by dil_parse_edit to keep the error
+     * count of the source file. */
+    DilIndices* errors;
+} DilParseOptions;
+
+/* Callbacks of a parsing process that calls them instead of building a tree.
+ * The rules are entered and left, and the terminals are given as tokens, in
+ * the order of the tree that would have been built; nothing is called for
+ * the ones that the parser backtracks over. Any callback can be null. */
+typedef struct {
+    /* Pointer that is given to the callbacks. */
+    void* data;
+    /* Called when a rule with the symbol is entered at the position. */
+    void (*enter)(void* data, DilSymbol symbol, char const* position);
+    /* Called when a rule with the symbol is left after parsing the range. */
+    void (*leave)(void* data, DilSymbol symbol, DilString range);
+    /* Called when a terminal with the symbol is parsed from the range. */
+    void (*token)(void* data, DilSymbol symbol, DilString range);
+} DilParseEvents;
+
 /* Context of the parsing process. */
 typedef struct {
     /* Tree that is built. */
@@ -27,24 +150,417 @@ typedef struct {
     DilSource source;
     /* Whether the parser is in skip mode. */
     bool skip;
+    /* Options of the parsing process. */
+    DilParseOptions options;
+    /* Omitted terminal counter when each of the parents was created. Only
+     * used when counting in compact mode. */
+    DilIndices omissions;
+    /* Error counter and amount of diagnostics when each of the parents was
+     * created. Only used with a memo. */
+    DilIndices reports;
+    /* Rules that are being parsed by the iterative parser. */
+    DilFrames frames;
+    /* Result of the rule the iterative parser returned from last. */
+    bool result;
+    /* Errors that were found, which are printed or added to the sink at the
+     * end. */
+    DilDiagnostics diagnostics;
+    /* Amount of rules that were entered, if there is a budget. */
+    size_t steps;
+    /* Whether the budget ran out. */
+    bool exhausted;
+    /* Offsets each symbol was rejected at, indexed by the symbol, if a
+     * generated parser remembers them. */
+    DilRecall* recalls;
+    /* Callbacks to call instead of building the tree, or null. The built
+     * tree is only the stack of the open objects then. */
+    DilParseEvents const* events;
+    /* Amount of the open objects whose enter callback was called. */
+    size_t entered;
 } DilParseContext;
 
+/* Parser of a top level statement. */
+typedef bool (*DilParseStatement)(DilParseContext* context);
+
+/* Alternatives of an ordered choice that can start with each character, as a
+ * bit for every alternative in the order they are tried. */
+typedef unsigned short DilParseFirst[UCHAR_MAX + 1];
+
+/* Alternatives that can start with the remaining character. */
+unsigned dil_parse__viable(
+    DilParseContext const* context,
+    DilParseFirst const    first)
+{
+    if (!dil_string_finite(&context->remaining)) {
+        return 0;
+    }
+    return first[(unsigned char)*context->remaining.first];
+}
+
+/* Whether the alternative is viable. Counts it as avoided otherwise. */
+bool dil_parse__try(
+    DilParseContext* context,
+    unsigned         viable,
+    unsigned         alternative)
+{
+    if ((viable >> alternative) & 1) {
+        return true;
+    }
+    if (context->options.statistics != NULL) {
+        context->options.statistics->avoided++;
+    }
+    return false;
+}
+
+/* Whether the remaining character is in the set, which decides a sequence
+ * whose first elements can match nothing. Does not consume it. */
+bool dil_parse__starts(DilParseContext const* context, DilCharClass const* set)
+{
+    return dil_string_finite(&context->remaining) &&
+           dil_char_class_contains(set, *context->remaining.first);
+}
+
+/* Whether the omitted terminals are counted. */
+bool dil_parse__counting(DilParseContext const* context)
+{
+    return context->options.compact && context->options.statistics != NULL;
+}
+
 /* Create an object in the tree. */
 void dil_parse__create(DilParseContext* context, DilSymbol symbol)
 {
-    dil_builder_add(
-        &context->builder,
-        (DilObject){
-            .symbol = symbol,
-            .value  = {.first = context->remaining.first}});
-    dil_builder_push(&context->builder);
+    DilObject object = {
+        .symbol = symbol,
+        .value  = {.first = context->remaining.first}};
+    if (context->events != NULL) {
+        dil_tree_add(&context->built, (DilNode){.object = object});
+    } else {
+        dil_builder_add(&context->builder, object);
+        dil_builder_push(&context->builder);
+    }
+    if (dil_parse__counting(context)) {
+        dil_indices_add(
+            &context->omissions,
+            context->options.statistics->omitted);
+    }
+    if (context->options.memo != NULL && context->events == NULL) {
+        dil_indices_add(&context->reports, context->source.error);
+        dil_indices_add(
+            &context->reports,
+            dil_diagnostics_size(&context->diagnostics));
+    }
+}
+
+/* Last open object. */
+DilObject* dil_parse__last(DilParseContext* context)
+{
+    if (context->events != NULL) {
+        return &dil_tree_finish(&context->built)->object;
+    }
+    return &dil_builder_parent(&context->builder)->object;
+}
+
+/* Count the terminal that was parsed without a node if it was accepted. */
+bool dil_parse__omit(DilParseContext* context, bool accept)
+{
+    if (accept && context->options.statistics != NULL) {
+        context->options.statistics->omitted++;
+    }
+    return accept;
+}
+
+/* Count the nodes of the rules that passed through without them if they were
+ * accepted. */
+bool dil_parse__collapse(DilParseContext* context, size_t amount, bool accept)
+{
+    if (accept && !context->skip && context->options.statistics != NULL) {
+        context->options.statistics->collapsed += amount;
+    }
+    return accept;
+}
+
+/* Amount of terminals omitted since the last pushed parent was created. */
+size_t dil_parse__omitted(DilParseContext const* context)
+{
+    if (!dil_parse__counting(context)) {
+        return 0;
+    }
+    return context->options.statistics->omitted -
+           *dil_indices_finish(&context->omissions);
+}
+
+/* Offset of the pointer from the start of the source file contents. */
+size_t dil_parse__offset(DilParseContext const* context, char const* position)
+{
+    return position - context->source.contents.first;
+}
+
+/* Remember the result of the last pushed object if it is a rule and there is a
+ * memo table. The subtree stays in the built tree, so a rejected object
+ * releases the remembered subtrees in it before they are removed. */
+void dil_parse__remember(DilParseContext* context, bool accept)
+{
+    DilMemo* memo = context->options.memo;
+    if (memo == NULL) {
+        return;
+    }
+
+    size_t diagnostics = dil_indices_pop(&context->reports);
+    size_t errors      = dil_indices_pop(&context->reports);
+    size_t index       = *dil_indices_finish(&context->builder.parents);
+    if (!accept) {
+        dil_memo_release(memo, &context->built, index);
+    }
+    DilNode const* node   = dil_tree_at(&context->built, index);
+    DilSymbol      symbol = node->object.symbol;
+    if (symbol == DIL_SYMBOL__CHARACTER || symbol == DIL_SYMBOL__STRING) {
+        return;
+    }
+
+    size_t offset = dil_parse__offset(context, node->object.value.first);
+    if (!accept) {
+        dil_memo_reject(memo, symbol, offset);
+        return;
+    }
+    dil_memo_accept(
+        memo,
+        (DilMemoEntry){
+            .symbol     = symbol,
+            .offset     = offset,
+            .end        = dil_parse__offset(context, node->object.value.last),
+            .first      = index,
+            .amount     = dil_tree_size(&context->built) - index,
+            .omitted    = dil_parse__omitted(context),
+            .errors     = context->source.error - errors,
+            .diagnostic = diagnostics,
+            .recorded =
+                dil_diagnostics_size(&context->diagnostics) - diagnostics});
+}
+
+/* Count the error, and record it unless the parser is quiet or the sink
+ * would drop it. */
+void dil_parse__report(DilParseContext* context, DilDiagnostic diagnostic)
+{
+    // Errors after the budget ran out are caused by the rules failing.
+    if (context->exhausted) {
+        return;
+    }
+    context->source.error++;
+    if (context->options.quiet ||
+        (context->options.sink != NULL &&
+         dil_sink_full(
+             context->options.sink,
+             dil_diagnostics_size(&context->diagnostics)))) {
+        return;
+    }
+    dil_diagnostics_add(&context->diagnostics, diagnostic);
+}
+
+/* Stop the parsing process if the budget ran out. Only looks at the clock
+ * and the cancellation once in an interval of steps, so it is cheap to check
+ * at each rule. */
+bool dil_parse__exhausted(DilParseContext* context)
+{
+    DilParseBudget* budget = context->options.budget;
+    if (budget == NULL) {
+        return false;
+    }
+    if (context->exhausted) {
+        return true;
+    }
+
+    context->steps++;
+    char const* reason = NULL;
+    if (budget->fuel != 0 && context->steps > budget->fuel) {
+        reason = "fuel limit";
+    } else if (context->steps % DIL_PARSE_BUDGET_INTERVAL == 0) {
+        if (atomic_load_explicit(&budget->cancelled, memory_order_relaxed)) {
+            reason = "cancellation";
+        } else if (dil_parse_budget_late(budget)) {
+            reason = "deadline";
+        }
+    }
+    if (reason == NULL) {
+        return false;
+    }
+
+    dil_parse__report(
+        context,
+        (DilDiagnostic){
+            .kind     = DIL_DIAGNOSTIC_BUDGET,
+            .expected = dil_string_terminated(reason),
+            .portion  = {
+                         .first = context->remaining.first,
+                         .last  = context->remaining.first}
+    });
+    context->exhausted = true;
+    if (context->options.statistics != NULL) {
+        context->options.statistics->exhausted++;
+    }
+    return true;
+}
+
+/* Whether the result of the rule at the remaining contents is decided without
+ * parsing it. Puts the decision to the accept and replays the memoized subtree
+ * if there is one. Rejects every rule after the budget runs out. */
+bool dil_parse__decided(
+    DilParseContext* context,
+    DilSymbol        symbol,
+    bool*            accept)
+{
+    if (dil_parse__exhausted(context)) {
+        *accept = false;
+        return true;
+    }
+
+    DilMemo* memo = context->options.memo;
+    if (memo == NULL || context->skip) {
+        return false;
+    }
+
+    DilMemoEntry const* entry = dil_memo_find(
+        memo,
+        symbol,
+        dil_parse__offset(context, context->remaining.first));
+    if (entry == NULL) {
+        return false;
+    }
+
+    *accept = entry->accept;
+    if (entry->accept) {
+        // Reserve first, since the subtree might be in the built tree.
+        DilTree const* nodes = entry->built ? &context->built : &memo->nodes;
+        dil_tree_reserve(&context->built, entry->amount);
+        dil_builder_graft(
+            &context->builder,
+            dil_tree_at(nodes, entry->first),
+            entry->amount);
+        if (dil_parse__counting(context)) {
+            context->options.statistics->omitted += entry->omitted;
+        }
+        context->remaining.first = context->source.contents.first + entry->end;
+
+        // Report the errors again, as parsing the symbol would.
+        for (size_t i = 0; i < entry->recorded; i++) {
+            dil_parse__report(
+                context,
+                dil_diagnostics_get(
+                    &context->diagnostics,
+                    entry->diagnostic + i));
+        }
+        context->source.error += entry->errors - entry->recorded;
+    }
+    return true;
+}
+
+/* Whether the symbol is remembered to be rejected at the remaining contents,
+ * so it is rejected without trying it again. */
+bool dil_parse__recalled(DilParseContext* context, DilSymbol symbol)
+{
+    return dil_recall_find(
+        context->recalls + symbol,
+        dil_parse__offset(context, context->remaining.first));
+}
+
+/* Remember that the last pushed object was rejected if its symbol is
+ * remembered. */
+void dil_parse__reject(DilParseContext* context)
+{
+    if (context->recalls == NULL) {
+        return;
+    }
+    DilObject const* object = dil_parse__last(context);
+    DilRecall*       recall = context->recalls + object->symbol;
+    if (recall->kind != DIL_RECALL_OFF) {
+        dil_recall_add(recall, dil_parse__offset(context, object->value.first));
+    }
+}
+
+/* Forget the omitted terminals of the last pushed parent if they are not going
+ * to be in the tree. */
+void dil_parse__restore(DilParseContext* context, bool keep)
+{
+    if (!dil_parse__counting(context)) {
+        return;
+    }
+    size_t omitted = dil_indices_pop(&context->omissions);
+    if (!keep) {
+        context->options.statistics->omitted = omitted;
+    }
+}
+
+/* Call the enter callback for the open objects upto the amount that were not
+ * entered yet. A generated parser only rejects a rule before anything in it
+ * is accepted, so the open rules are entered once something in them is
+ * accepted, and the rejected ones are never entered. */
+void dil_parse__commit(DilParseContext* context, size_t amount)
+{
+    DilParseEvents const* events = context->events;
+    for (; context->entered < amount; context->entered++) {
+        DilObject const* object =
+            &dil_tree_at(&context->built, context->entered)->object;
+        if (events->enter != NULL) {
+            events->enter(events->data, object->symbol, object->value.first);
+        }
+    }
+}
+
+/* Call the callbacks for the last open object, which was accepted, and remove
+ * it from the stack. */
+void dil_parse__emit(DilParseContext* context)
+{
+    DilParseEvents const* events = context->events;
+    DilObject const*      object = dil_parse__last(context);
+    size_t                open   = dil_tree_size(&context->built) - 1;
+    if (object->symbol == DIL_SYMBOL__CHARACTER ||
+        object->symbol == DIL_SYMBOL__STRING) {
+        dil_parse__commit(context, open);
+        if (events->token != NULL) {
+            events->token(events->data, object->symbol, object->value);
+        }
+    } else {
+        dil_parse__commit(context, open + 1);
+        if (events->leave != NULL) {
+            events->leave(events->data, object->symbol, object->value);
+        }
+        context->entered = open;
+    }
+    dil_tree_remove(&context->built);
+}
+
+/* End the last open object and call the callbacks for it, or forget it. */
+bool dil_parse__leave(DilParseContext* context, bool accept)
+{
+    DilObject* object = dil_parse__last(context);
+    if (accept && !context->skip) {
+        object->value.last = context->remaining.first;
+        dil_parse__restore(context, true);
+        dil_parse__emit(context);
+        return true;
+    }
+    dil_parse__restore(context, false);
+    if (!accept) {
+        dil_parse__reject(context);
+        context->remaining.first = object->value.first;
+    }
+    dil_tree_remove(&context->built);
+    return accept;
 }
 
 /* End an object or remove it from the tree. */
 bool dil_parse__return(DilParseContext* context, bool accept)
 {
+    if (context->events != NULL) {
+        return dil_parse__leave(context, accept);
+    }
     if (context->skip) {
+        dil_parse__restore(context, false);
+        if (context->options.memo != NULL) {
+            dil_indices_remove(&context->reports);
+            dil_indices_remove(&context->reports);
+        }
         if (!accept) {
+            dil_parse__reject(context);
             context->remaining.first =
                 dil_builder_parent(&context->builder)->object.value.first;
         }
@@ -55,9 +571,14 @@ bool dil_parse__return(DilParseContext* context, bool accept)
     if (accept) {
         dil_builder_parent(&context->builder)->object.value.last =
             context->remaining.first;
+        dil_parse__remember(context, true);
+        dil_parse__restore(context, true);
         dil_builder_pop(&context->builder);
         return true;
     }
+    dil_parse__remember(context, false);
+    dil_parse__restore(context, false);
+    dil_parse__reject(context);
     context->remaining.first =
         dil_builder_parent(&context->builder)->object.value.first;
     dil_builder_remove(&context->builder);
@@ -87,24 +608,14 @@ bool dil_parse_start(DilParseContext* context);
 bool dil_parse_skip(DilParseContext* context);
 bool dil_parse_statement(DilParseContext* context);
 
-/* Try to skip in style 0 once. */
-bool dil_parse__skip_0_once(DilParseContext* context)
-{
-    context->skip = true;
-    bool accept   = dil_parse_whitespace(context) || dil_parse_comment(context);
-    context->skip = false;
-    return accept;
-}
-
-/* Skip in style 0 as much as possible. */
-void dil_parse__skip_0(DilParseContext* context)
-{
-    while (dil_parse__skip_0_once(context)) {}
-}
-
 /* Try to parse a character. */
 bool dil_parse__character(DilParseContext* context, char element)
 {
+    if (context->options.compact) {
+        return dil_parse__omit(
+            context,
+            dil_string_prefix_element(&context->remaining, element));
+    }
     dil_parse__create(context, DIL_SYMBOL__CHARACTER);
     return dil_parse__return(
         context,
@@ -112,195 +623,437 @@ bool dil_parse__character(DilParseContext* context, char element)
 }
 
 /* Try to parse a character from a set. */
-bool dil_parse__set(DilParseContext* context, DilString const* set)
+bool dil_parse__set(DilParseContext* context, DilCharClass const* set)
 {
+    if (context->options.compact) {
+        return dil_parse__omit(
+            context,
+            dil_string_prefix_class(&context->remaining, set));
+    }
     dil_parse__create(context, DIL_SYMBOL__CHARACTER);
     return dil_parse__return(
         context,
-        dil_string_prefix_set(&context->remaining, set));
+        dil_string_prefix_class(&context->remaining, set));
 }
 
 /* Try to parse a character from a not set. */
-bool dil_parse__not_set(DilParseContext* context, DilString const* set)
+bool dil_parse__not_set(DilParseContext* context, DilCharClass const* set)
 {
+    if (context->options.compact) {
+        return dil_parse__omit(
+            context,
+            dil_string_prefix_not_class(&context->remaining, set));
+    }
     dil_parse__create(context, DIL_SYMBOL__CHARACTER);
     return dil_parse__return(
         context,
-        dil_string_prefix_not_set(&context->remaining, set));
+        dil_string_prefix_not_class(&context->remaining, set));
+}
+
+/* Call the token callback for the characters upto the end one by one. */
+void dil_parse__tokens(DilParseContext* context, char const* end)
+{
+    DilParseEvents const* events = context->events;
+    if (end == context->remaining.first) {
+        return;
+    }
+    dil_parse__commit(context, dil_tree_size(&context->built));
+    if (events->token == NULL) {
+        return;
+    }
+    for (char const* i = context->remaining.first; i < end; i++) {
+        events->token(
+            events->data,
+            DIL_SYMBOL__CHARACTER,
+            (DilString){.first = i, .last = i + 1});
+    }
+}
+
+/* Parse the characters upto the end as separate characters. */
+void dil_parse__run(DilParseContext* context, char const* end)
+{
+    size_t amount = end - context->remaining.first;
+    if (context->options.compact) {
+        if (context->options.statistics != NULL) {
+            context->options.statistics->omitted += amount;
+        }
+    } else if (!context->skip && context->events != NULL) {
+        dil_parse__tokens(context, end);
+    } else if (!context->skip) {
+        dil_tree_reserve(&context->built, amount);
+        for (char const* i = context->remaining.first; i < end; i++) {
+            dil_builder_add(
+                &context->builder,
+                (DilObject){
+                    .symbol = DIL_SYMBOL__CHARACTER,
+                    .value  = {.first = i, .last = i + 1}
+            });
+        }
+    }
+    context->remaining.first = end;
+}
+
+/* Parse as many characters from a set as possible. */
+void dil_parse__set_run(DilParseContext* context, DilCharClass const* set)
+{
+    dil_parse__run(
+        context,
+        dil_scan_while(
+            context->remaining.first,
+            context->remaining.last,
+            set));
+}
+
+/* Parse as many characters from a not set as possible. */
+void dil_parse__not_set_run(DilParseContext* context, DilCharClass const* set)
+{
+    dil_parse__run(
+        context,
+        dil_scan_until(
+            context->remaining.first,
+            context->remaining.last,
+            set));
 }
 
 /* Try to parse a string. */
 bool dil_parse__string(DilParseContext* context, DilString const* set)
 {
+    if (context->options.compact) {
+        return dil_parse__omit(
+            context,
+            dil_string_prefix_check(&context->remaining, set));
+    }
     dil_parse__create(context, DIL_SYMBOL__STRING);
     return dil_parse__return(
         context,
         dil_string_prefix_check(&context->remaining, set));
 }
 
-/* Skip over the erronous characters and print them. */
+/* Run the scanner of a rule at the remaining contents. Puts the border after
+ * the recognized characters to the end. */
+DilScannerOutcome dil_parse__scan(
+    DilParseContext const* context,
+    DilScanner const*      scanner,
+    char const**           end)
+{
+    return dil_scanner_run(
+        scanner,
+        context->remaining.first,
+        context->remaining.last,
+        end);
+}
+
+/* Whether the terminals are not in the tree, so the characters a scanner
+ * recognized can be parsed as a run even if they were matched as strings. */
+bool dil_parse__flat(DilParseContext const* context)
+{
+    return context->skip ||
+           (context->options.compact && context->options.statistics == NULL);
+}
+
+/* Parse the characters upto the end, which a scanner recognized, as the
+ * rule. */
+bool dil_parse__recognize(
+    DilParseContext* context,
+    DilSymbol        symbol,
+    char const*      end)
+{
+    if (context->skip) {
+        context->remaining.first = end;
+        return true;
+    }
+    dil_parse__create(context, symbol);
+    dil_parse__run(context, end);
+    return dil_parse__return(context, true);
+}
+
+/* Report the error at the remaining character. */
+void dil_parse__error(
+    DilParseContext*  context,
+    DilDiagnosticKind kind,
+    char const*       expected,
+    char const*       symbol)
+{
+    dil_parse__report(
+        context,
+        (DilDiagnostic){
+            .kind     = kind,
+            .expected = dil_string_terminated(expected),
+            .symbol   = symbol,
+            .portion  = {
+                         .first = context->remaining.first,
+                         .last  = context->remaining.first + 1}
+    });
+}
+
+/* Skip over the erronous characters and report them. Only tries to skip at
+ * the characters a skip can start with, and scans over the others. */
 void dil_parse__error_skip(
     DilParseContext* context,
     bool (*skip)(DilParseContext*),
+    DilCharClass const* first,
     char const* expected,
     char const* symbol)
 {
-    size_t const BUFFER_SIZE = 1024;
-    char         buffer[BUFFER_SIZE];
-    (void)sprintf_s(
-        buffer,
-        BUFFER_SIZE,
-        "Expected `%s` in `%s`!",
-        expected,
-        symbol);
     DilString portion = {
         .first = context->remaining.first,
         .last  = context->remaining.first};
-    while (context->remaining.first <= context->remaining.last &&
-           !skip(context)) {
+    while (true) {
+        context->remaining.first = dil_scan_until(
+            context->remaining.first,
+            context->remaining.last,
+            first);
+        portion.last = context->remaining.first;
+        if (!dil_string_finite(&context->remaining) || skip(context) ||
+            context->exhausted) {
+            break;
+        }
         context->remaining.first++;
-        portion.last++;
     }
-    context->source.error++;
-    dil_source_print(&context->source, &portion, "error", buffer);
+    dil_parse__report(
+        context,
+        (DilDiagnostic){
+            .kind     = DIL_DIAGNOSTIC_SKIP,
+            .expected = dil_string_terminated(expected),
+            .symbol   = symbol,
+            .portion  = portion});
 }
 
-/* Print the expected character. */
+/* Report the expected character. */
 void dil_parse__error_character(
     DilParseContext* context,
     char             character,
     char const*      symbol)
 {
-    size_t const BUFFER_SIZE = 1024;
-    char         buffer[BUFFER_SIZE];
-    (void)sprintf_s(
-        buffer,
-        BUFFER_SIZE,
-        "Expected `%c` in `%s`!",
-        character,
-        symbol);
-    DilString portion = {
-        .first = context->remaining.first,
-        .last  = context->remaining.first + 1};
-    context->source.error++;
-    dil_source_print(&context->source, &portion, "error", buffer);
+    dil_parse__report(
+        context,
+        (DilDiagnostic){
+            .kind      = DIL_DIAGNOSTIC_CHARACTER,
+            .character = character,
+            .symbol    = symbol,
+            .portion   = {
+                          .first = context->remaining.first,
+                          .last  = context->remaining.first + 1}
+    });
 }
 
-/* Print the expected set. */
+/* Report the expected set. */
 void dil_parse__error_set(
     DilParseContext* context,
-    DilString const* set,
+    char const*      set,
     char const*      symbol)
 {
-    size_t const BUFFER_SIZE = 1024;
-    char         buffer[BUFFER_SIZE];
-    (void)sprintf_s(
-        buffer,
-        BUFFER_SIZE,
-        "Expected one of `%.*s` in `%s`!",
-        (int)dil_string_size(set),
-        set->first,
-        symbol);
-    DilString portion = {
-        .first = context->remaining.first,
-        .last  = context->remaining.first + 1};
-    context->source.error++;
-    dil_source_print(&context->source, &portion, "error", buffer);
+    dil_parse__error(context, DIL_DIAGNOSTIC_SET, set, symbol);
 }
 
-/* Print the expected not set. */
+/* Report the expected not set. */
 void dil_parse__error_not_set(
     DilParseContext* context,
-    DilString const* set,
+    char const*      set,
     char const*      symbol)
 {
-    size_t const BUFFER_SIZE = 1024;
-    char         buffer[BUFFER_SIZE];
-    (void)sprintf_s(
-        buffer,
-        BUFFER_SIZE,
-        "Expected none of `%.*s` in `%s`!",
-        (int)dil_string_size(set),
-        set->first,
-        symbol);
-    DilString portion = {
-        .first = context->remaining.first,
-        .last  = context->remaining.first + 1};
-    context->source.error++;
-    dil_source_print(&context->source, &portion, "error", buffer);
+    dil_parse__error(context, DIL_DIAGNOSTIC_NOT_SET, set, symbol);
 }
 
-/* Print the expected string. */
+/* Report the expected string. */
 void dil_parse__error_string(
     DilParseContext* context,
     DilString const* string,
     char const*      symbol)
 {
-    size_t const BUFFER_SIZE = 1024;
-    char         buffer[BUFFER_SIZE];
-    (void)sprintf_s(
-        buffer,
-        BUFFER_SIZE,
-        "Expected `%.*s` in `%s`!",
-        (int)dil_string_size(string),
-        string->first,
-        symbol);
-    DilString portion = {
-        .first = context->remaining.first,
-        .last  = context->remaining.first + 1};
-    context->source.error++;
-    dil_source_print(&context->source, &portion, "error", buffer);
+    dil_parse__report(
+        context,
+        (DilDiagnostic){
+            .kind     = DIL_DIAGNOSTIC_STRING,
+            .expected = *string,
+            .symbol   = symbol,
+            .portion  = {
+                         .first = context->remaining.first,
+                         .last  = context->remaining.first + 1}
+    });
 }
 
-/* Print the expected terminal. */
+/* Report the expected terminal. */
 void dil_parse__error_reference(
     DilParseContext* context,
     char const*      expected,
     char const*      symbol)
 {
-    size_t const BUFFER_SIZE = 1024;
-    char         buffer[BUFFER_SIZE];
-    (void)sprintf_s(
-        buffer,
-        BUFFER_SIZE,
-        "Expected `%s` in `%s`!",
-        expected,
-        symbol);
-    DilString portion = {
-        .first = context->remaining.first,
-        .last  = context->remaining.first + 1};
-    context->source.error++;
-    dil_source_print(&context->source, &portion, "error", buffer);
+    dil_parse__error(context, DIL_DIAGNOSTIC_REFERENCE, expected, symbol);
 }
 
-/* Print the unexpected character. */
+/* Report the unexpected character. */
 void dil_parse__error_unexpected(DilParseContext* context, char const* symbol)
 {
-    size_t const BUFFER_SIZE = 1024;
-    char         buffer[BUFFER_SIZE];
-    (void)
-        sprintf_s(buffer, BUFFER_SIZE, "Unexpected character in `%s`!", symbol);
-    DilString portion = {
-        .first = context->remaining.first,
-        .last  = context->remaining.first + 1};
-    context->source.error++;
-    dil_source_print(&context->source, &portion, "error", buffer);
+    dil_parse__error(context, DIL_DIAGNOSTIC_UNEXPECTED, "", symbol);
+}
+
+/* Characters a skip in style 0 can start with. */
+DilCharClass const* dil_parse__skip_0_first(void)
+{
+    /* '\t\n /' */
+    static DilCharClass const FIRST = {
+        .bits = {0x0000800100000600, 0, 0, 0}};
+
+    return &FIRST;
+}
+
+/* Try to skip in style 0 once, which is a single whitespace character or a
+ * whole comment. Recognizes the whitespace and comment rules directly on the
+ * contents, since skipped rules do not stay in the tree. */
+bool dil_parse__skip_0_once(DilParseContext* context)
+{
+    static char const      STRING_0[]  = "//";
+    static DilString const TERMINALS_0 = {
+        .first = STRING_0,
+        .last  = STRING_0 + sizeof(STRING_0) - 1};
+    /* '\t\n ' */
+    static DilCharClass const SET_0 = {
+        .bits = {0x0000000100000600, 0, 0, 0}};
+    /* '\n' */
+    static DilCharClass const SET_1 = {
+        .bits = {0x0000000000000400, 0, 0, 0}};
+
+    DilString* remaining = &context->remaining;
+    if (dil_string_prefix_class(remaining, &SET_0)) {
+        return true;
+    }
+
+    if (!dil_string_prefix_check(remaining, &TERMINALS_0)) {
+        return false;
+    }
+    remaining->first =
+        dil_scan_until(remaining->first, remaining->last, &SET_1);
+    if (!dil_string_prefix_element(remaining, '\n')) {
+        dil_parse__error_character(context, '\n', "Comment");
+    }
+    return true;
+}
+
+/* Skip in style 0 as much as possible. The whitespace runs are scanned at
+ * once instead of a character each time. */
+void dil_parse__skip_0(DilParseContext* context)
+{
+    /* '\t\n ' */
+    static DilCharClass const SET_0 = {
+        .bits = {0x0000000100000600, 0, 0, 0}};
+
+    DilString* remaining = &context->remaining;
+    do {
+        remaining->first =
+            dil_scan_while(remaining->first, remaining->last, &SET_0);
+    } while (dil_parse__skip_0_once(context));
+}
+
+/* Alternatives of a unit that can start with the remaining character. */
+unsigned dil_parse__unit_first(DilParseContext const* context)
+{
+    static DilParseFirst const FIRST = {
+        ['\''] = 1 << 0,
+        ['!']  = 1 << 1,
+        ['"']  = 1 << 2,
+        ['A']  = 1 << 3,
+        ['B']  = 1 << 3,
+        ['C']  = 1 << 3,
+        ['D']  = 1 << 3,
+        ['E']  = 1 << 3,
+        ['F']  = 1 << 3,
+        ['G']  = 1 << 3,
+        ['H']  = 1 << 3,
+        ['I']  = 1 << 3,
+        ['J']  = 1 << 3,
+        ['K']  = 1 << 3,
+        ['L']  = 1 << 3,
+        ['M']  = 1 << 3,
+        ['N']  = 1 << 3,
+        ['O']  = 1 << 3,
+        ['P']  = 1 << 3,
+        ['Q']  = 1 << 3,
+        ['R']  = 1 << 3,
+        ['S']  = 1 << 3,
+        ['T']  = 1 << 3,
+        ['U']  = 1 << 3,
+        ['V']  = 1 << 3,
+        ['W']  = 1 << 3,
+        ['X']  = 1 << 3,
+        ['Y']  = 1 << 3,
+        ['Z']  = 1 << 3,
+        ['(']  = 1 << 4,
+        ['1']  = 1 << 5,
+        ['2']  = 1 << 5,
+        ['3']  = 1 << 5,
+        ['4']  = 1 << 5,
+        ['5']  = 1 << 5,
+        ['6']  = 1 << 5,
+        ['7']  = 1 << 5,
+        ['8']  = 1 << 5,
+        ['9']  = 1 << 5,
+        ['+']  = 1 << 6,
+        ['*']  = 1 << 7,
+        ['?']  = 1 << 8};
+
+    return dil_parse__viable(context, FIRST);
+}
+
+/* Alternatives of a statement that can start with the remaining character. */
+unsigned dil_parse__statement_first(DilParseContext const* context)
+{
+    static DilParseFirst const FIRST = {
+        ['s'] = 1 << 0 | 1 << 1,
+        ['A'] = 1 << 2,
+        ['B'] = 1 << 2,
+        ['C'] = 1 << 2,
+        ['D'] = 1 << 2,
+        ['E'] = 1 << 2,
+        ['F'] = 1 << 2,
+        ['G'] = 1 << 2,
+        ['H'] = 1 << 2,
+        ['I'] = 1 << 2,
+        ['J'] = 1 << 2,
+        ['K'] = 1 << 2,
+        ['L'] = 1 << 2,
+        ['M'] = 1 << 2,
+        ['N'] = 1 << 2,
+        ['O'] = 1 << 2,
+        ['P'] = 1 << 2,
+        ['Q'] = 1 << 2,
+        ['R'] = 1 << 2,
+        ['S'] = 1 << 2,
+        ['T'] = 1 << 2,
+        ['U'] = 1 << 2,
+        ['V'] = 1 << 2,
+        ['W'] = 1 << 2,
+        ['X'] = 1 << 2,
+        ['Y'] = 1 << 2,
+        ['Z'] = 1 << 2};
+
+    return dil_parse__viable(context, FIRST);
 }
 
 /* Try to parse a comment. */
 bool dil_parse_comment(DilParseContext* context)
 {
+    bool accept = false;
+    if (dil_parse__decided(context, DIL_SYMBOL_COMMENT, &accept)) {
+        return accept;
+    }
+
     dil_parse__create(context, DIL_SYMBOL_COMMENT);
 
-    DilString const TERMINALS_0 = dil_string_terminated("//");
-    DilString const SET_0       = dil_string_terminated("\n");
-    char const      CHARACTER_0 = '\n';
+    static char const      STRING_0[]  = "//";
+    static DilString const TERMINALS_0 = {
+        .first = STRING_0,
+        .last  = STRING_0 + sizeof(STRING_0) - 1};
+    /* '\n' */
+    static DilCharClass const SET_0 = {
+        .bits = {0x0000000000000400, 0, 0, 0}};
+    char const CHARACTER_0 = '\n';
 
     if (!dil_parse__string(context, &TERMINALS_0)) {
         return dil_parse__return(context, false);
     }
 
-    while (dil_parse__not_set(context, &SET_0)) {}
+    dil_parse__not_set_run(context, &SET_0);
 
     if (!dil_parse__character(context, CHARACTER_0)) {
         dil_parse__error_character(context, CHARACTER_0, "Comment");
@@ -313,9 +1066,16 @@ bool dil_parse_comment(DilParseContext* context)
 /* Try to parse a whitespace. */
 bool dil_parse_whitespace(DilParseContext* context)
 {
+    bool accept = false;
+    if (dil_parse__decided(context, DIL_SYMBOL_WHITESPACE, &accept)) {
+        return accept;
+    }
+
     dil_parse__create(context, DIL_SYMBOL_WHITESPACE);
 
-    DilString const SET_0 = dil_string_terminated("\t\n ");
+    /* '\t\n ' */
+    static DilCharClass const SET_0 = {
+        .bits = {0x0000000100000600, 0, 0, 0}};
 
     if (!dil_parse__set(context, &SET_0)) {
         return dil_parse__return(context, false);
@@ -327,17 +1087,25 @@ bool dil_parse_whitespace(DilParseContext* context)
 /* Try to parse an identifier. */
 bool dil_parse_identifier(DilParseContext* context)
 {
+    bool accept = false;
+    if (dil_parse__decided(context, DIL_SYMBOL_IDENTIFIER, &accept)) {
+        return accept;
+    }
+
     dil_parse__create(context, DIL_SYMBOL_IDENTIFIER);
 
-    DilString const SET_0 = dil_string_terminated("ABCDEFGHIJKLMNOPQRSTUVWXYZ");
-    DilString const SET_1 = dil_string_terminated(
-        "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ");
+    /* 'A~Z' */
+    static DilCharClass const SET_0 = {
+        .bits = {0, 0x0000000007FFFFFE, 0, 0}};
+    /* 'a~zA~Z' */
+    static DilCharClass const SET_1 = {
+        .bits = {0, 0x07FFFFFE07FFFFFE, 0, 0}};
 
     if (!dil_parse__set(context, &SET_0)) {
         return dil_parse__return(context, false);
     }
 
-    while (dil_parse__set(context, &SET_1)) {}
+    dil_parse__set_run(context, &SET_1);
 
     return dil_parse__return(context, true);
 }
@@ -345,17 +1113,31 @@ bool dil_parse_identifier(DilParseContext* context)
 /* Try to parse an escaped character. */
 bool dil_parse_escaped(DilParseContext* context)
 {
+    bool accept = false;
+    if (dil_parse__decided(context, DIL_SYMBOL_ESCAPED, &accept)) {
+        return accept;
+    }
+
     dil_parse__create(context, DIL_SYMBOL_ESCAPED);
 
-    DilString const SET_0 = dil_string_terminated("0123456789abcdefABCDEF");
-    DilString const SET_1 = dil_string_terminated("tn\\'~");
-    DilString const SET_2 = dil_string_terminated("\\'~");
+    /* '0~9a~fA~F' */
+    static DilCharClass const SET_0 = {
+        .bits = {0x03FF000000000000, 0x0000007E0000007E, 0, 0}};
+    /* 'tn\\\'\~' */
+    static DilCharClass const SET_1 = {
+        .bits = {0x0000008000000000, 0x4010400010000000, 0, 0}};
+    /* '\\\'\~' */
+    static DilCharClass const SET_2 = {
+        .bits = {0x0000008000000000, 0x4000000010000000, 0, 0}};
 
     if (dil_parse__character(context, '\\')) {
         if (dil_parse__set(context, &SET_0)) {
             for (size_t i = 0; i < 2 - 1; i++) {
                 if (!dil_parse__set(context, &SET_0)) {
-                    dil_parse__error_set(context, &SET_0, "Escaped");
+                    dil_parse__error_set(
+                        context,
+                        "0123456789abcdefABCDEF",
+                        "Escaped");
                     return dil_parse__return(context, true);
                 }
             }
@@ -380,16 +1162,25 @@ bool dil_parse_escaped(DilParseContext* context)
 /* Try to parse a number. */
 bool dil_parse_number(DilParseContext* context)
 {
+    bool accept = false;
+    if (dil_parse__decided(context, DIL_SYMBOL_NUMBER, &accept)) {
+        return accept;
+    }
+
     dil_parse__create(context, DIL_SYMBOL_NUMBER);
 
-    DilString const SET_0 = dil_string_terminated("123456789");
-    DilString const SET_1 = dil_string_terminated("0123456789");
+    /* '1~9' */
+    static DilCharClass const SET_0 = {
+        .bits = {0x03FE000000000000, 0, 0, 0}};
+    /* '0~9' */
+    static DilCharClass const SET_1 = {
+        .bits = {0x03FF000000000000, 0, 0, 0}};
 
     if (!dil_parse__set(context, &SET_0)) {
         return dil_parse__return(context, false);
     }
 
-    while (dil_parse__set(context, &SET_1)) {}
+    dil_parse__set_run(context, &SET_1);
 
     return dil_parse__return(context, true);
 }
@@ -397,6 +1188,11 @@ bool dil_parse_number(DilParseContext* context)
 /* Try to parse a set. */
 bool dil_parse_set(DilParseContext* context)
 {
+    bool accept = false;
+    if (dil_parse__decided(context, DIL_SYMBOL_SET, &accept)) {
+        return accept;
+    }
+
     dil_parse__create(context, DIL_SYMBOL_SET);
 
     if (!dil_parse__character(context, '\'')) {
@@ -424,6 +1220,11 @@ bool dil_parse_set(DilParseContext* context)
 /* Try to parse a not set. */
 bool dil_parse_not_set(DilParseContext* context)
 {
+    bool accept = false;
+    if (dil_parse__decided(context, DIL_SYMBOL_NOT_SET, &accept)) {
+        return accept;
+    }
+
     dil_parse__create(context, DIL_SYMBOL_NOT_SET);
 
     if (!dil_parse__character(context, '!')) {
@@ -441,11 +1242,22 @@ bool dil_parse_not_set(DilParseContext* context)
 /* Try to parse a string. */
 bool dil_parse_string(DilParseContext* context)
 {
+    bool accept = false;
+    if (dil_parse__decided(context, DIL_SYMBOL_STRING, &accept)) {
+        return accept;
+    }
+
     dil_parse__create(context, DIL_SYMBOL_STRING);
 
-    DilString const SET_0 = dil_string_terminated("0123456789abcdefABCDEF");
-    DilString const SET_1 = dil_string_terminated("tn\\\"");
-    DilString const SET_2 = dil_string_terminated("\\\"");
+    /* '0~9a~fA~F' */
+    static DilCharClass const SET_0 = {
+        .bits = {0x03FF000000000000, 0x0000007E0000007E, 0, 0}};
+    /* 'tn\\"' */
+    static DilCharClass const SET_1 = {
+        .bits = {0x0000000400000000, 0x0010400010000000, 0, 0}};
+    /* '\\"' */
+    static DilCharClass const SET_2 = {
+        .bits = {0x0000000400000000, 0x0000000010000000, 0, 0}};
 
     if (!dil_parse__character(context, '"')) {
         return dil_parse__return(context, false);
@@ -456,7 +1268,10 @@ bool dil_parse_string(DilParseContext* context)
             if (dil_parse__set(context, &SET_0)) {
                 for (size_t i = 0; i < 2 - 1; i++) {
                     if (!dil_parse__set(context, &SET_0)) {
-                        dil_parse__error_set(context, &SET_0, "String");
+                        dil_parse__error_set(
+                            context,
+                            "0123456789abcdefABCDEF",
+                            "String");
                         return dil_parse__return(context, true);
                     }
                 }
@@ -485,6 +1300,11 @@ bool dil_parse_string(DilParseContext* context)
 /* Try to parse a reference. */
 bool dil_parse_reference(DilParseContext* context)
 {
+    bool accept = false;
+    if (dil_parse__decided(context, DIL_SYMBOL_REFERENCE, &accept)) {
+        return accept;
+    }
+
     dil_parse__create(context, DIL_SYMBOL_REFERENCE);
     return dil_parse__return(context, dil_parse_identifier(context));
 }
@@ -492,6 +1312,11 @@ bool dil_parse_reference(DilParseContext* context)
 /* Try to parse a group. */
 bool dil_parse_group(DilParseContext* context)
 {
+    bool accept = false;
+    if (dil_parse__decided(context, DIL_SYMBOL_GROUP, &accept)) {
+        return accept;
+    }
+
     dil_parse__create(context, DIL_SYMBOL_GROUP);
 
     if (!dil_parse__character(context, '(')) {
@@ -504,6 +1329,7 @@ bool dil_parse_group(DilParseContext* context)
         dil_parse__error_skip(
             context,
             &dil_parse__skip_0_once,
+            dil_parse__skip_0_first(),
             "Pattern",
             "Group");
         return dil_parse__return(context, true);
@@ -511,10 +1337,6 @@ bool dil_parse_group(DilParseContext* context)
 
     dil_parse__skip_0(context);
 
-    while (dil_parse_pattern(context)) {
-        dil_parse__skip_0(context);
-    }
-
     if (!dil_parse__character(context, ')')) {
         dil_parse__error_character(context, ')', "Group");
         return dil_parse__return(context, true);
@@ -526,6 +1348,11 @@ bool dil_parse_group(DilParseContext* context)
 /* Try to parse a fixed times. */
 bool dil_parse_fixed_times(DilParseContext* context)
 {
+    bool accept = false;
+    if (dil_parse__decided(context, DIL_SYMBOL_FIXED_TIMES, &accept)) {
+        return accept;
+    }
+
     dil_parse__create(context, DIL_SYMBOL_FIXED_TIMES);
 
     if (!dil_parse_number(context)) {
@@ -538,6 +1365,7 @@ bool dil_parse_fixed_times(DilParseContext* context)
         dil_parse__error_skip(
             context,
             &dil_parse__skip_0_once,
+            dil_parse__skip_0_first(),
             "Unit",
             "FixedTimes");
         return dil_parse__return(context, true);
@@ -549,6 +1377,11 @@ bool dil_parse_fixed_times(DilParseContext* context)
 /* Try to parse a one or more. */
 bool dil_parse_one_or_more(DilParseContext* context)
 {
+    bool accept = false;
+    if (dil_parse__decided(context, DIL_SYMBOL_ONE_OR_MORE, &accept)) {
+        return accept;
+    }
+
     dil_parse__create(context, DIL_SYMBOL_ONE_OR_MORE);
 
     if (!dil_parse__character(context, '+')) {
@@ -561,6 +1394,7 @@ bool dil_parse_one_or_more(DilParseContext* context)
         dil_parse__error_skip(
             context,
             &dil_parse__skip_0_once,
+            dil_parse__skip_0_first(),
             "Unit",
             "OneOrMore");
         return dil_parse__return(context, true);
@@ -572,6 +1406,11 @@ bool dil_parse_one_or_more(DilParseContext* context)
 /* Try to parse a zero or more. */
 bool dil_parse_zero_or_more(DilParseContext* context)
 {
+    bool accept = false;
+    if (dil_parse__decided(context, DIL_SYMBOL_ZERO_OR_MORE, &accept)) {
+        return accept;
+    }
+
     dil_parse__create(context, DIL_SYMBOL_ZERO_OR_MORE);
 
     if (!dil_parse__character(context, '*')) {
@@ -584,6 +1423,7 @@ bool dil_parse_zero_or_more(DilParseContext* context)
         dil_parse__error_skip(
             context,
             &dil_parse__skip_0_once,
+            dil_parse__skip_0_first(),
             "Unit",
             "ZeroOrMore");
         return dil_parse__return(context, true);
@@ -595,6 +1435,11 @@ bool dil_parse_zero_or_more(DilParseContext* context)
 /* Try to parse a optional. */
 bool dil_parse_optional(DilParseContext* context)
 {
+    bool accept = false;
+    if (dil_parse__decided(context, DIL_SYMBOL_OPTIONAL, &accept)) {
+        return accept;
+    }
+
     dil_parse__create(context, DIL_SYMBOL_OPTIONAL);
 
     if (!dil_parse__character(context, '?')) {
@@ -607,6 +1452,7 @@ bool dil_parse_optional(DilParseContext* context)
         dil_parse__error_skip(
             context,
             &dil_parse__skip_0_once,
+            dil_parse__skip_0_first(),
             "Unit",
             "Optional");
         return dil_parse__return(context, true);
@@ -618,19 +1464,41 @@ bool dil_parse_optional(DilParseContext* context)
 /* Try to parse a unit. */
 bool dil_parse_unit(DilParseContext* context)
 {
+    bool accept = false;
+    if (dil_parse__decided(context, DIL_SYMBOL_UNIT, &accept)) {
+        return accept;
+    }
+
     dil_parse__create(context, DIL_SYMBOL_UNIT);
+
+    unsigned viable = dil_parse__unit_first(context);
     return dil_parse__return(
         context,
-        dil_parse_set(context) || dil_parse_not_set(context) ||
-            dil_parse_string(context) || dil_parse_reference(context) ||
-            dil_parse_group(context) || dil_parse_fixed_times(context) ||
-            dil_parse_one_or_more(context) || dil_parse_zero_or_more(context) ||
-            dil_parse_optional(context));
+        (dil_parse__try(context, viable, 0) && dil_parse_set(context)) ||
+            (dil_parse__try(context, viable, 1) &&
+             dil_parse_not_set(context)) ||
+            (dil_parse__try(context, viable, 2) && dil_parse_string(context)) ||
+            (dil_parse__try(context, viable, 3) &&
+             dil_parse_reference(context)) ||
+            (dil_parse__try(context, viable, 4) && dil_parse_group(context)) ||
+            (dil_parse__try(context, viable, 5) &&
+             dil_parse_fixed_times(context)) ||
+            (dil_parse__try(context, viable, 6) &&
+             dil_parse_one_or_more(context)) ||
+            (dil_parse__try(context, viable, 7) &&
+             dil_parse_zero_or_more(context)) ||
+            (dil_parse__try(context, viable, 8) &&
+             dil_parse_optional(context)));
 }
 
 /* Try to parse alternatives. */
 bool dil_parse_alternative(DilParseContext* context)
 {
+    bool accept = false;
+    if (dil_parse__decided(context, DIL_SYMBOL_ALTERNATIVE, &accept)) {
+        return accept;
+    }
+
     dil_parse__create(context, DIL_SYMBOL_ALTERNATIVE);
 
     if (!dil_parse_unit(context)) {
@@ -649,6 +1517,11 @@ bool dil_parse_alternative(DilParseContext* context)
 /* Try to parse a pattern. */
 bool dil_parse_pattern(DilParseContext* context)
 {
+    bool accept = false;
+    if (dil_parse__decided(context, DIL_SYMBOL_PATTERN, &accept)) {
+        return accept;
+    }
+
     dil_parse__create(context, DIL_SYMBOL_PATTERN);
 
     if (!dil_parse_alternative(context)) {
@@ -664,6 +1537,7 @@ bool dil_parse_pattern(DilParseContext* context)
             dil_parse__error_skip(
                 context,
                 &dil_parse__skip_0_once,
+                dil_parse__skip_0_first(),
                 "Alternative",
                 "Pattern");
             return dil_parse__return(context, true);
@@ -678,6 +1552,11 @@ bool dil_parse_pattern(DilParseContext* context)
 /* Try to parse a rule. */
 bool dil_parse_rule(DilParseContext* context)
 {
+    bool accept = false;
+    if (dil_parse__decided(context, DIL_SYMBOL_RULE, &accept)) {
+        return accept;
+    }
+
     dil_parse__create(context, DIL_SYMBOL_RULE);
 
     if (!dil_parse_identifier(context)) {
@@ -697,6 +1576,7 @@ bool dil_parse_rule(DilParseContext* context)
         dil_parse__error_skip(
             context,
             &dil_parse__skip_0_once,
+            dil_parse__skip_0_first(),
             "Pattern",
             "Rule");
         return dil_parse__return(context, true);
@@ -715,9 +1595,17 @@ bool dil_parse_rule(DilParseContext* context)
 /* Try to parse a start. */
 bool dil_parse_start(DilParseContext* context)
 {
+    bool accept = false;
+    if (dil_parse__decided(context, DIL_SYMBOL_START, &accept)) {
+        return accept;
+    }
+
     dil_parse__create(context, DIL_SYMBOL_START);
 
-    DilString const TERMINALS_0 = dil_string_terminated("start");
+    static char const      STRING_0[]  = "start";
+    static DilString const TERMINALS_0 = {
+        .first = STRING_0,
+        .last  = STRING_0 + sizeof(STRING_0) - 1};
 
     if (!dil_parse__string(context, &TERMINALS_0)) {
         return dil_parse__return(context, false);
@@ -729,6 +1617,7 @@ bool dil_parse_start(DilParseContext* context)
         dil_parse__error_skip(
             context,
             &dil_parse__skip_0_once,
+            dil_parse__skip_0_first(),
             "Pattern",
             "Start");
         return dil_parse__return(context, true);
@@ -738,7 +1627,7 @@ bool dil_parse_start(DilParseContext* context)
 
     if (!dil_parse__character(context, ';')) {
         dil_parse__error_character(context, ';', "Start");
-        return dil_parse__return(context, false);
+        return dil_parse__return(context, true);
     }
 
     return dil_parse__return(context, true);
@@ -747,9 +1636,17 @@ bool dil_parse_start(DilParseContext* context)
 /* Try to parse a skip. */
 bool dil_parse_skip(DilParseContext* context)
 {
+    bool accept = false;
+    if (dil_parse__decided(context, DIL_SYMBOL_SKIP, &accept)) {
+        return accept;
+    }
+
     dil_parse__create(context, DIL_SYMBOL_SKIP);
 
-    DilString const TERMINALS_0 = dil_string_terminated("skip");
+    static char const      STRING_0[]  = "skip";
+    static DilString const TERMINALS_0 = {
+        .first = STRING_0,
+        .last  = STRING_0 + sizeof(STRING_0) - 1};
 
     if (!dil_parse__string(context, &TERMINALS_0)) {
         return dil_parse__return(context, false);
@@ -772,15 +1669,23 @@ bool dil_parse_skip(DilParseContext* context)
 /* Try to parse a statement. */
 bool dil_parse_statement(DilParseContext* context)
 {
+    bool accept = false;
+    if (dil_parse__decided(context, DIL_SYMBOL_STATEMENT, &accept)) {
+        return accept;
+    }
+
     dil_parse__create(context, DIL_SYMBOL_STATEMENT);
+
+    unsigned viable = dil_parse__statement_first(context);
     return dil_parse__return(
         context,
-        dil_parse_skip(context) || dil_parse_start(context) ||
-            dil_parse_rule(context));
+        (dil_parse__try(context, viable, 0) && dil_parse_skip(context)) ||
+            (dil_parse__try(context, viable, 1) && dil_parse_start(context)) ||
+            (dil_parse__try(context, viable, 2) && dil_parse_rule(context)));
 }
 
-/* Parses the __start__ symbol. */
-void dil_parse__start(DilParseContext* context)
+/* Create the __start__ symbol as the parent of the statements. */
+void dil_parse__open(DilParseContext* context)
 {
     dil_tree_add(
         &context->built,
@@ -789,44 +1694,237 @@ void dil_parse__start(DilParseContext* context)
                        .symbol = DIL_SYMBOL__START,
                        .value  = {.first = context->remaining.first}}
     });
-    dil_builder_push(&context->builder);
+    if (context->events == NULL) {
+        dil_builder_push(&context->builder);
+    }
+}
 
+/* Parse the statements in the remaining contents with the statement parser.
+ * Returns whether the contents ran out before a statement was rejected. */
+bool dil_parse__statements(
+    DilParseContext*  context,
+    DilParseStatement statement)
+{
     dil_parse__skip_0(context);
-    while (dil_parse_statement(context)) {
+    while (statement(context)) {
         dil_parse__skip_0(context);
     }
+    return !dil_string_finite(&context->remaining);
+}
 
-    dil_builder_parent(&context->builder)->object.value.last =
-        context->remaining.first;
-    dil_builder_pop(&context->builder);
+/* End the __start__ symbol and report the contents that were not parsed. */
+void dil_parse__close(DilParseContext* context)
+{
+    dil_parse__last(context)->value.last = context->remaining.first;
+    if (context->events != NULL) {
+        dil_parse__emit(context);
+    } else {
+        dil_builder_pop(&context->builder);
+    }
 
     if (dil_string_finite(&context->remaining)) {
-        context->source.error++;
-        dil_source_print(
-            &context->source,
-            &context->remaining,
-            "error",
-            "There are unexpected characters left in the file!");
+        dil_parse__report(
+            context,
+            (DilDiagnostic){
+                .kind    = DIL_DIAGNOSTIC_LEFT,
+                .portion = context->remaining});
     }
 }
 
-/* Parses the source file. */
-DilTree dil_parse(DilSource source)
+/* Record the errors after the amount that were placed as in the statement
+ * that starts at the position, if the errors are recorded. */
+void dil_parse__place(
+    DilParseContext* context,
+    size_t*          placed,
+    char const*      statement)
+{
+    DilIndices* errors = context->options.errors;
+    if (errors == NULL) {
+        return;
+    }
+    for (; *placed < context->source.error; (*placed)++) {
+        dil_indices_add(errors, statement - context->source.contents.first);
+    }
+}
+
+/* Parses the __start__ symbol with the statement parser. */
+void dil_parse__start(DilParseContext* context, DilParseStatement statement)
+{
+    dil_parse__open(context);
+    if (context->options.errors == NULL) {
+        (void)dil_parse__statements(context, statement);
+        dil_parse__close(context);
+        return;
+    }
+
+    // Same as parsing the statements, but places the errors after each one.
+    dil_indices_clear(context->options.errors);
+    size_t      placed = context->source.error;
+    char const* first  = context->remaining.first;
+    dil_parse__skip_0(context);
+    dil_parse__place(context, &placed, first);
+    first = context->remaining.first;
+    while (statement(context)) {
+        dil_parse__skip_0(context);
+        dil_parse__place(context, &placed, first);
+        first = context->remaining.first;
+    }
+    dil_parse__close(context);
+    dil_parse__place(context, &placed, first);
+}
+
+/* Print the amount of errors the source file had, if it had any. */
+void dil_parse_summarize(DilSource const* source)
+{
+    if (source->error != 0) {
+        printf(
+            "%s: error: File had %llu errors.\n",
+            source->path,
+            source->error);
+    }
+}
+
+/* Print the errors or add them to the sink, and add them to the
+ * statistics. */
+void dil_parse__deliver(DilParseContext* context)
+{
+    if (context->options.sink != NULL) {
+        dil_sink_add(
+            context->options.sink,
+            &context->diagnostics,
+            context->source.error);
+    } else if (!context->options.quiet) {
+        dil_diagnostics_print(&context->diagnostics, &context->source);
+        dil_parse_summarize(&context->source);
+    }
+
+    if (context->options.statistics != NULL) {
+        context->options.statistics->errors += context->source.error;
+    }
+}
+
+/* Remember the offsets the symbols were rejected at in the amount of recalls,
+ * which are indexed by the symbol. */
+void dil_parse__recall(
+    DilParseContext* context,
+    DilRecall*       recalls,
+    size_t           amount)
+{
+    context->recalls = recalls;
+    for (size_t i = 0; i < amount; i++) {
+        dil_recall_start(
+            recalls + i,
+            dil_string_size(&context->source.contents));
+    }
+}
+
+/* Add the counters of the amount of recalls to the statistics, and deallocate
+ * them. */
+void dil_parse__forget(DilParseContext* context, size_t amount)
+{
+    DilParseStatistics* statistics = context->options.statistics;
+    for (size_t i = 0; i < amount; i++) {
+        DilRecall* recall = context->recalls + i;
+        if (statistics != NULL) {
+            statistics->recall_hits += recall->hits;
+            statistics->recall_misses += recall->misses;
+        }
+        dil_recall_free(recall);
+    }
+    context->recalls = NULL;
+}
+
+/* Deliver the errors, and deallocate the memory of the context except the
+ * built tree, which is returned. */
+DilTree dil_parse__conclude(DilParseContext* context)
+{
+    dil_parse__deliver(context);
+    dil_builder_free(&context->builder);
+    dil_indices_free(&context->omissions);
+    dil_indices_free(&context->reports);
+    dil_frames_free(&context->frames);
+    dil_diagnostics_free(&context->diagnostics);
+    return context->built;
+}
+
+/* Deliver the errors, and deallocate the memory of the context, which called
+ * the callbacks instead of building a tree. */
+void dil_parse__dismiss(DilParseContext* context)
+{
+    DilTree stack = dil_parse__conclude(context);
+    dil_tree_free(&stack);
+}
+
+/* Parses the source file with the options and the statement parser. */
+DilTree dil_parse__process(
+    DilSource         source,
+    DilParseOptions   options,
+    DilParseStatement statement)
 {
     DilParseContext initial = {
         .builder   = {.built = &initial.built},
         .remaining = source.contents,
-        .source    = source};
+        .source    = source,
+        .options   = options};
 
-    dil_parse__start(&initial);
+    if (options.memo != NULL) {
+        dil_memo_clear(options.memo);
+    }
 
-    if (initial.source.error != 0) {
-        printf(
-            "%s: error: File had %llu errors.\n",
-            initial.source.path,
-            initial.source.error);
+    dil_parse__start(&initial, statement);
+    return dil_parse__conclude(&initial);
+}
+
+/* Parses the source file with the options. */
+DilTree dil_parse_with(DilSource source, DilParseOptions options)
+{
+    return dil_parse__process(source, options, &dil_parse_statement);
+}
+
+/* Parses the source file. */
+DilTree dil_parse(DilSource source)
+{
+    return dil_parse_with(source, (DilParseOptions){0});
+}
+
+/* Print the counters with the size of the tree they were counted for. */
+void dil_parse_statistics_print(
+    FILE*                     stream,
+    DilParseStatistics const* statistics,
+    DilTree const*            tree)
+{
+    size_t nodes = dil_tree_size(tree);
+    size_t full  = nodes + statistics->omitted;
+    (void)fprintf(
+        stream,
+        "Tree: %llu nodes, %llu in full, %llu bytes saved, %.2f%% smaller.\n"
+        "Choices: %llu alternatives avoided.\n",
+        nodes,
+        full,
+        statistics->omitted * sizeof(DilNode),
+        full == 0 ? 0.0 : 100.0 * (double)statistics->omitted / (double)full,
+        statistics->avoided);
+    if (nodes == 0) {
+        return;
     }
 
-    dil_builder_free(&initial.builder);
-    return initial.built;
+    DilString const* source   = &dil_tree_at(tree, 0)->object.value;
+    size_t           bytes    = dil_string_size(source);
+    size_t           expanded = nodes + statistics->collapsed;
+    (void)fprintf(
+        stream,
+        "Density: %.3f nodes per byte, %.3f with %llu collapsed nodes.\n",
+        bytes == 0 ? 0.0 : (double)nodes / (double)bytes,
+        bytes == 0 ? 0.0 : (double)expanded / (double)bytes,
+        statistics->collapsed);
+
+    size_t lookups = statistics->recall_hits + statistics->recall_misses;
+    if (lookups != 0) {
+        (void)fprintf(
+            stream,
+            "Recall: %llu hits, %llu misses, %.2f%% hit rate.\n",
+            statistics->recall_hits,
+            statistics->recall_misses,
+            100.0 * (double)statistics->recall_hits / (double)lookups);
+    }
 }
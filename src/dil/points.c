@@ -0,0 +1,168 @@
+// SPDX-FileCopyrightText: 2022 Cem Geçgel <gecgelcem@outlook.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Point the machine returns or backtracks to, which is a called function or
+ * a choice in one. */
+typedef struct {
+    /* Address of the call, or the address to backtrack to if it is a
+     * choice. */
+    size_t address;
+    /* Remaining contents when the choice was made. */
+    char const* position;
+    /* Called function. */
+    size_t function;
+    /* Whether the point is a call instead of a choice. */
+    bool call;
+    /* Whether the called function has a node. */
+    bool node;
+} DilPoint;
+
+/* Contiguous, dynamicly allocated elements. */
+typedef struct {
+    /* Border before the first element. */
+    DilPoint* first;
+    /* Border after the last element. */
+    DilPoint* last;
+    /* Border after the last allocated element. */
+    DilPoint* allocated;
+} DilPoints;
+
+/* Amount of elements. */
+size_t dil_points_size(DilPoints const* list)
+{
+    return list->last - list->first;
+}
+
+/* Amount of allocated elements. */
+size_t dil_points_capacity(DilPoints const* list)
+{
+    return list->allocated - list->first;
+}
+
+/* Amount of allocated but unused elements. */
+size_t dil_points_space(DilPoints const* list)
+{
+    return list->allocated - list->last;
+}
+
+/* Whether there are any elements. */
+bool dil_points_finite(DilPoints const* list)
+{
+    return dil_points_size(list) > 0;
+}
+
+/* Pointer to the element at the index. */
+DilPoint* dil_points_at(DilPoints const* list, size_t index)
+{
+    return list->first + index;
+}
+
+/* Element at the index. */
+DilPoint dil_points_get(DilPoints const* list, size_t index)
+{
+    return *dil_points_at(list, index);
+}
+
+/* Pointer to the first element. */
+DilPoint* dil_points_start(DilPoints const* list)
+{
+    return list->first;
+}
+
+/* Pointer to the last element. */
+DilPoint* dil_points_finish(DilPoints const* list)
+{
+    return list->last - 1;
+}
+
+/* Make sure the amount of elements will fit. Grows by at least half if
+ * necessary. */
+void dil_points_reserve(DilPoints* list, size_t amount)
+{
+    size_t space = dil_points_space(list);
+    if (amount <= space) {
+        return;
+    }
+
+    size_t growth       = amount - space;
+    size_t capacity     = dil_points_capacity(list);
+    size_t halfCapacity = capacity / 2;
+    if (growth < halfCapacity) {
+        growth = halfCapacity;
+    }
+
+    size_t    newCapacity = capacity + growth;
+    DilPoint* memory = realloc(list->first, newCapacity * sizeof(DilPoint));
+
+    list->last      = memory + dil_points_size(list);
+    list->first     = memory;
+    list->allocated = memory + newCapacity;
+}
+
+/* Add the element to the end. */
+void dil_points_add(DilPoints* list, DilPoint element)
+{
+    dil_points_reserve(list, 1);
+    *list->last++ = element;
+}
+
+/* Open space at the index for the amount of element. Returns pointer to the
+ * first opened element. */
+DilPoint* dil_points_open(DilPoints* list, size_t index, size_t amount)
+{
+    dil_points_reserve(list, amount);
+    DilPoint* position = list->first + index;
+    memmove(position + amount, position, amount * sizeof(DilPoint));
+    list->last += amount;
+    return position;
+}
+
+/* Put the element to the given index. */
+void dil_points_put(DilPoints* list, size_t index, DilPoint element)
+{
+    *dil_points_open(list, index, 1) = element;
+}
+
+/* Place the element the amount of times to the end. */
+void dil_points_place(DilPoints* list, size_t amount, DilPoint element)
+{
+    dil_points_reserve(list, amount);
+    for (size_t i = 0; i < amount; i++) {
+        *list->last++ = element;
+    }
+}
+
+/* Remove from the end. */
+void dil_points_remove(DilPoints* list)
+{
+    list->last--;
+}
+
+/* Remove from the end and return the removed element. */
+DilPoint dil_points_pop(DilPoints* list)
+{
+    dil_points_remove(list);
+    return *list->last;
+}
+
+/* Remove all the elements. Keeps the memory. */
+void dil_points_clear(DilPoints* list)
+{
+    list->last = list->first;
+}
+
+/* Deallocate memory. */
+void dil_points_free(DilPoints* list)
+{
+    free(list->first);
+    list->first     = NULL;
+    list->last      = NULL;
+    list->allocated = NULL;
+}
@@ -0,0 +1,509 @@
+// SPDX-FileCopyrightText: 2022 Cem Geçgel <gecgelcem@outlook.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "dil/analysis.c"
+#include "dil/buffer.c"
+#include "dil/expressions.c"
+#include "dil/grammar.c"
+#include "dil/indices.c"
+#include "dil/instructions.c"
+#include "dil/rules.c"
+#include "dil/string.c"
+#include "dil/tree.c"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/* Grammar that is compiled to instructions at runtime, which the machine in
+ * `dil/machine.c` runs instead of a generated parser. Each rule, skip style
+ * and the start pattern is a function, which are in that order. */
+typedef struct {
+    /* Compiled grammar, whose expressions are the operands of the tests. */
+    DilGrammar grammar;
+    /* Characters around the expressions of the grammar. */
+    DilAnalysis analysis;
+    /* Instructions of all the functions. */
+    DilInstructions code;
+    /* Address of each function. */
+    DilIndices addresses;
+    /* Rule of each function, which decides how it skips. */
+    DilRules functions;
+    /* Names of the functions and the texts of the sets, which are null
+     * terminated since the errors refer to them. */
+    DilBuffer strings;
+    /* Index of the name of each function in the strings. */
+    DilIndices names;
+    /* Index of the text of each set or not set expression in the strings. */
+    DilIndices texts;
+} DilProgram;
+
+/* Function that is being compiled. */
+typedef struct {
+    /* Program that is compiled into. */
+    DilProgram* program;
+    /* Rule of the function. */
+    DilRule const* current;
+} DilCompiler;
+
+/* Index of the function of the skip style. */
+size_t dil_program_skip(DilProgram const* program, size_t skip)
+{
+    return dil_rules_size(&program->grammar.rules) + skip;
+}
+
+/* Index of the function of the start pattern. */
+size_t dil_program_start(DilProgram const* program)
+{
+    return dil_program_skip(program, dil_indices_size(&program->grammar.skips));
+}
+
+/* Name of the function in the errors. */
+char const* dil_program_name(DilProgram const* program, size_t function)
+{
+    return program->strings.first + dil_indices_get(&program->names, function);
+}
+
+/* Text of the set or not set expression at the index in the errors. */
+char const* dil_program_text(DilProgram const* program, size_t index)
+{
+    return program->strings.first + dil_indices_get(&program->texts, index);
+}
+
+/* Head of the expression, which is the simple expression it starts with, or
+ * null if it does not start with one. */
+DilExpression const*
+dil_program_head(DilProgram const* program, DilExpression const* expression)
+{
+    if (expression->kind <= DIL_EXPRESSION_REFERENCE) {
+        return expression;
+    }
+    switch (expression->kind) {
+        case DIL_EXPRESSION_SEQUENCE:
+        case DIL_EXPRESSION_ONE_OR_MORE:
+        case DIL_EXPRESSION_FIXED_TIMES: {
+            DilExpression const* first = dil_grammar_at(
+                &program->grammar,
+                dil_grammar_child(&program->grammar, expression, 0));
+            return first->kind <= DIL_EXPRESSION_REFERENCE ? first : NULL;
+        }
+        default:
+            return NULL;
+    }
+}
+
+/* Add the null terminated string to the strings. Returns its index. */
+size_t dil_program__string(DilProgram* program, DilString const* string)
+{
+    size_t index = dil_buffer_size(&program->strings);
+    for (char const* i = string->first; i < string->last; i++) {
+        dil_buffer_add(&program->strings, *i);
+    }
+    dil_buffer_add(&program->strings, 0);
+    return index;
+}
+
+/* Add the instruction. Returns its address. */
+size_t dil_program__emit(
+    DilCompiler* compiler,
+    DilOpcode    opcode,
+    size_t       operand)
+{
+    DilInstructions* code    = &compiler->program->code;
+    size_t           address = dil_instructions_size(code);
+    dil_instructions_add(
+        code,
+        (DilInstruction){.opcode = opcode, .operand = (unsigned)operand});
+    return address;
+}
+
+/* Make the instruction at the address continue at the next instruction that
+ * is added. */
+void dil_program__patch(DilCompiler* compiler, size_t address)
+{
+    DilInstructions* code = &compiler->program->code;
+    dil_instructions_at(code, address)->operand =
+        (unsigned)dil_instructions_size(code);
+}
+
+/* Child of the expression at the index. */
+DilExpression const* dil_program__child(
+    DilCompiler const*   compiler,
+    DilExpression const* expression,
+    size_t               index)
+{
+    DilGrammar const* grammar = &compiler->program->grammar;
+    return dil_grammar_at(
+        grammar,
+        dil_grammar_child(grammar, expression, index));
+}
+
+/* Index of the expression in the grammar. */
+size_t dil_program__index(
+    DilCompiler const*   compiler,
+    DilExpression const* expression)
+{
+    return expression - compiler->program->grammar.expressions.first;
+}
+
+/* Whether the expression is a sequence whose first element can match
+ * nothing, but not all of them can, which is decided on its first
+ * characters. */
+bool dil_program__leads(
+    DilCompiler const*   compiler,
+    DilExpression const* expression)
+{
+    if (expression->kind != DIL_EXPRESSION_SEQUENCE) {
+        return false;
+    }
+    DilAnalysis const* analysis = &compiler->program->analysis;
+    size_t             first    = dil_grammar_child(
+        &compiler->program->grammar,
+        expression,
+        0);
+    return dil_analysis_at(analysis, first)->vacuous &&
+           !dil_analysis_at(analysis, dil_program__index(compiler, expression))
+                ->vacuous;
+}
+
+/* Add the test of the simple expression. */
+void dil_program__test(DilCompiler* compiler, DilExpression const* expression)
+{
+    size_t index = dil_program__index(compiler, expression);
+    switch (expression->kind) {
+        case DIL_EXPRESSION_CHARACTER:
+            dil_program__emit(
+                compiler,
+                DIL_OPCODE_CHARACTER,
+                (unsigned char)expression->character);
+            break;
+        case DIL_EXPRESSION_SET:
+            dil_program__emit(compiler, DIL_OPCODE_SET, index);
+            break;
+        case DIL_EXPRESSION_NOT_SET:
+            dil_program__emit(compiler, DIL_OPCODE_NOT_SET, index);
+            break;
+        case DIL_EXPRESSION_STRING:
+            dil_program__emit(compiler, DIL_OPCODE_STRING, index);
+            break;
+        default:
+            dil_program__emit(compiler, DIL_OPCODE_CALL, expression->rule);
+            break;
+    }
+}
+
+/* Add the failure of the expression, which reports it and accepts the
+ * function, or backtracks. */
+void dil_program__fail(
+    DilCompiler*         compiler,
+    bool                 report,
+    DilExpression const* expression)
+{
+    if (report) {
+        dil_program__emit(
+            compiler,
+            DIL_OPCODE_ERROR,
+            dil_program__index(compiler, expression));
+    } else {
+        dil_program__emit(compiler, DIL_OPCODE_FAIL, 0);
+    }
+}
+
+/* Add the skip between the elements if the current function skips. */
+void dil_program__skip(DilCompiler* compiler)
+{
+    if (compiler->current->skipped) {
+        dil_program__emit(compiler, DIL_OPCODE_SKIP, compiler->current->skip);
+    }
+}
+
+void dil_program__match(
+    DilCompiler*         compiler,
+    DilExpression const* expression,
+    bool                 report);
+
+/* Add the instructions that match the expression after its head matched. */
+void dil_program__rest(
+    DilCompiler*         compiler,
+    DilExpression const* expression);
+
+/* Add the instructions that match the expression as many times as
+ * possible. */
+void dil_program__loop(
+    DilCompiler*         compiler,
+    DilExpression const* expression)
+{
+    bool skipped = compiler->current->skipped;
+    if (!skipped && expression->kind <= DIL_EXPRESSION_NOT_SET) {
+        dil_program__emit(
+            compiler,
+            expression->kind == DIL_EXPRESSION_NOT_SET
+                ? DIL_OPCODE_NOT_SET_RUN
+                : DIL_OPCODE_SET_RUN,
+            dil_program__index(compiler, expression));
+        return;
+    }
+
+    DilProgram*          program = compiler->program;
+    DilExpression const* head    = dil_program_head(program, expression);
+    size_t               start   = dil_instructions_size(&program->code);
+    if (head == NULL) {
+        size_t choice = dil_program__emit(compiler, DIL_OPCODE_CHOICE, 0);
+        dil_program__match(compiler, expression, false);
+        dil_program__skip(compiler);
+        dil_program__emit(compiler, DIL_OPCODE_REPEAT, start);
+        dil_program__patch(compiler, choice);
+        return;
+    }
+    dil_program__test(compiler, head);
+    size_t exit = dil_program__emit(compiler, DIL_OPCODE_JUMP, 0);
+    if (head != expression || skipped) {
+        dil_program__rest(compiler, expression);
+        dil_program__skip(compiler);
+    }
+    dil_program__emit(compiler, DIL_OPCODE_JUMP, start);
+    dil_program__patch(compiler, exit);
+}
+
+void dil_program__rest(
+    DilCompiler*         compiler,
+    DilExpression const* expression)
+{
+    DilExpression const* child = NULL;
+    switch (expression->kind) {
+        case DIL_EXPRESSION_SEQUENCE:
+            for (size_t i = 1; i < expression->amount; i++) {
+                dil_program__skip(compiler);
+                dil_program__match(
+                    compiler,
+                    dil_program__child(compiler, expression, i),
+                    true);
+            }
+            break;
+        case DIL_EXPRESSION_ONE_OR_MORE:
+            dil_program__skip(compiler);
+            dil_program__loop(
+                compiler,
+                dil_program__child(compiler, expression, 0));
+            break;
+        case DIL_EXPRESSION_FIXED_TIMES:
+            // Unrolled, since there is no counter to loop with.
+            child = dil_program__child(compiler, expression, 0);
+            for (size_t i = 1; i < expression->times; i++) {
+                dil_program__skip(compiler);
+                dil_program__match(compiler, child, true);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/* Add the instructions that match the first alternative that matches. The
+ * alternatives that start with a test are tried with jumps over them;
+ * otherwise, each alternative is a choice. */
+void dil_program__choice(
+    DilCompiler*         compiler,
+    DilExpression const* expression,
+    bool                 report)
+{
+    DilProgram* program = compiler->program;
+    bool        split   = true;
+    for (size_t i = 0; i < expression->amount; i++) {
+        DilExpression const* alternative =
+            dil_program__child(compiler, expression, i);
+        split = split && (alternative->kind == DIL_EXPRESSION_OPTIONAL ||
+                          alternative->kind == DIL_EXPRESSION_ZERO_OR_MORE ||
+                          dil_program_head(program, alternative) != NULL);
+    }
+
+    // Addresses of the jumps to the end of the choice.
+    DilIndices ends = {0};
+    bool       done = false;
+    for (size_t i = 0; i < expression->amount && !done; i++) {
+        DilExpression const* alternative =
+            dil_program__child(compiler, expression, i);
+        if (!split) {
+            size_t choice = dil_program__emit(compiler, DIL_OPCODE_CHOICE, 0);
+            dil_program__match(compiler, alternative, false);
+            dil_indices_add(
+                &ends,
+                dil_program__emit(compiler, DIL_OPCODE_COMMIT, 0));
+            dil_program__patch(compiler, choice);
+        } else if (
+            alternative->kind == DIL_EXPRESSION_OPTIONAL ||
+            alternative->kind == DIL_EXPRESSION_ZERO_OR_MORE) {
+            // Later alternatives are never tried.
+            dil_program__match(compiler, alternative, report);
+            done = true;
+        } else {
+            dil_program__test(compiler, dil_program_head(program, alternative));
+            size_t next = dil_program__emit(compiler, DIL_OPCODE_JUMP, 0);
+            dil_program__rest(compiler, alternative);
+            dil_indices_add(
+                &ends,
+                dil_program__emit(compiler, DIL_OPCODE_JUMP, 0));
+            dil_program__patch(compiler, next);
+        }
+    }
+    if (!done) {
+        dil_program__fail(compiler, report, expression);
+    }
+    for (size_t i = 0; i < dil_indices_size(&ends); i++) {
+        dil_program__patch(compiler, dil_indices_get(&ends, i));
+    }
+    dil_indices_free(&ends);
+}
+
+/* Add the instructions that match the expression. Mismatches at its start
+ * are reported if the report is true, and backtrack otherwise. The later
+ * mismatches are always reported, and accept the function. The sequences
+ * that are decided on their first characters test them at their start. */
+void dil_program__match(
+    DilCompiler*         compiler,
+    DilExpression const* expression,
+    bool                 report)
+{
+    if (expression->kind <= DIL_EXPRESSION_REFERENCE) {
+        dil_program__test(compiler, expression);
+        dil_program__fail(compiler, report, expression);
+        return;
+    }
+
+    DilExpression const* child = dil_program__child(compiler, expression, 0);
+    switch (expression->kind) {
+        case DIL_EXPRESSION_SEQUENCE:
+        case DIL_EXPRESSION_ONE_OR_MORE:
+        case DIL_EXPRESSION_FIXED_TIMES:
+            if (dil_program__leads(compiler, expression)) {
+                dil_program__emit(
+                    compiler,
+                    DIL_OPCODE_FIRST,
+                    dil_program__index(compiler, expression));
+                dil_program__fail(compiler, report, expression);
+            }
+            dil_program__match(compiler, child, report);
+            dil_program__rest(compiler, expression);
+            break;
+        case DIL_EXPRESSION_CHOICE:
+            dil_program__choice(compiler, expression, report);
+            break;
+        case DIL_EXPRESSION_ZERO_OR_MORE:
+            dil_program__loop(compiler, child);
+            break;
+        default: {
+            DilExpression const* head =
+                dil_program_head(compiler->program, child);
+            if (head != NULL) {
+                dil_program__test(compiler, head);
+                size_t end = dil_program__emit(compiler, DIL_OPCODE_JUMP, 0);
+                dil_program__rest(compiler, child);
+                dil_program__patch(compiler, end);
+            } else {
+                size_t choice =
+                    dil_program__emit(compiler, DIL_OPCODE_CHOICE, 0);
+                dil_program__match(compiler, child, false);
+                size_t end = dil_program__emit(compiler, DIL_OPCODE_COMMIT, 0);
+                dil_program__patch(compiler, choice);
+                dil_program__patch(compiler, end);
+            }
+            break;
+        }
+    }
+}
+
+/* Add the function of the rule that matches the pattern, and skips before it
+ * if it is the start pattern. */
+void dil_program__function(
+    DilProgram*    program,
+    DilRule const* rule,
+    size_t         pattern,
+    bool           start)
+{
+    DilCompiler compiler = {.program = program, .current = rule};
+    dil_indices_add(&program->addresses, dil_instructions_size(&program->code));
+    dil_rules_add(&program->functions, *rule);
+    dil_indices_add(&program->names, dil_program__string(program, &rule->name));
+    if (start) {
+        dil_program__skip(&compiler);
+    }
+    dil_program__match(
+        &compiler,
+        dil_grammar_at(&program->grammar, pattern),
+        false);
+    dil_program__emit(&compiler, DIL_OPCODE_RETURN, 0);
+}
+
+/* Compile the grammar in the tree into the program. The functions test the
+ * expressions the same way the parsers generated with `dil/generator.c` do,
+ * so the trees are the same as the ones of the exact generated parser.
+ * Returns whether the grammar could be read without errors, and has no
+ * repetitions of patterns that can match nothing or rules that reach
+ * themselves before consuming a character, which are printed. The program
+ * must be freed either way. */
+bool dil_program_compile(DilProgram* program, DilTree const* tree)
+{
+    program->grammar = dil_grammar_read(tree);
+    DilGrammar const* grammar = &program->grammar;
+    if (grammar->errors != 0) {
+        return false;
+    }
+    program->analysis = dil_analyze(grammar);
+    if (dil_analysis_unending(&program->analysis, stdout) != 0) {
+        return false;
+    }
+
+    size_t expressions = dil_expressions_size(&grammar->expressions);
+    dil_indices_place(&program->texts, expressions, 0);
+    for (size_t i = 0; i < expressions; i++) {
+        DilExpression const* expression = dil_grammar_at(grammar, i);
+        if (expression->kind == DIL_EXPRESSION_SET ||
+            expression->kind == DIL_EXPRESSION_NOT_SET) {
+            DilString text = dil_grammar_text(grammar, expression);
+            dil_indices_put(
+                &program->texts,
+                i,
+                dil_program__string(program, &text));
+        }
+    }
+
+    for (size_t i = 0; i < dil_rules_size(&grammar->rules); i++) {
+        DilRule const* rule = dil_rules_at(&grammar->rules, i);
+        dil_program__function(program, rule, rule->pattern, false);
+    }
+    DilRule skip = {.name = dil_string_terminated("skip")};
+    for (size_t i = 0; i < dil_indices_size(&grammar->skips); i++) {
+        dil_program__function(
+            program,
+            &skip,
+            dil_indices_get(&grammar->skips, i),
+            false);
+    }
+    dil_program__function(
+        program,
+        &grammar->start,
+        grammar->start.pattern,
+        true);
+    return true;
+}
+
+/* Amount of bytes the instructions take. */
+size_t dil_program_bytes(DilProgram const* program)
+{
+    return dil_instructions_size(&program->code) * sizeof(DilInstruction);
+}
+
+/* Deallocate memory. */
+void dil_program_free(DilProgram* program)
+{
+    dil_grammar_free(&program->grammar);
+    dil_analysis_free(&program->analysis);
+    dil_instructions_free(&program->code);
+    dil_indices_free(&program->addresses);
+    dil_rules_free(&program->functions);
+    dil_buffer_free(&program->strings);
+    dil_indices_free(&program->names);
+    dil_indices_free(&program->texts);
+}
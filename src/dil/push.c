@@ -0,0 +1,185 @@
+// SPDX-FileCopyrightText: 2022 Cem Geçgel <gecgelcem@outlook.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "dil/boundary.c"
+#include "dil/buffer.c"
+#include "dil/memo.c"
+#include "dil/parser.c"
+#include "dil/source.c"
+#include "dil/string.c"
+#include "dil/tree.c"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+/* Parsing process that is given the source file in chunks. The statements
+ * are parsed as soon as the boundary after them arrives, so the parser waits
+ * only for the chunks of the statement it is at. Statements that might be
+ * parsed differently with the contents after the boundary are parsed again
+ * when more chunks arrive. The contents are still kept together in the
+ * buffer, because the tree refers to them. */
+typedef struct {
+    /* Context of the parsing process. */
+    DilParseContext context;
+    /* Buffer the chunks are added to. */
+    DilBuffer* buffer;
+    /* Index of the first element of the source file in the buffer. */
+    size_t start;
+    /* Scanner of the boundaries in the chunks. */
+    DilBoundary scanner;
+    /* Index of the first element in the buffer the scanner did not see. */
+    size_t scanned;
+} DilParsePush;
+
+/* Move the tree, the errors and the context to the contents at the new
+ * position after the buffer is reallocated. */
+void dil_parse__rebase(DilParsePush* push, char const* old)
+{
+    char const* new = push->buffer->first;
+    for (DilNode* i = push->context.built.first; i < push->context.built.last;
+         i++) {
+        DilString* value = &i->object.value;
+        value->first     = new + (value->first - old);
+        if (value->last != NULL) {
+            value->last = new + (value->last - old);
+        }
+    }
+
+    for (DilDiagnostic* i = push->context.diagnostics.first;
+         i < push->context.diagnostics.last;
+         i++) {
+        i->portion.first = new + (i->portion.first - old);
+        i->portion.last  = new + (i->portion.last - old);
+    }
+
+    DilString* remaining = &push->context.remaining;
+    remaining->first     = new + (remaining->first - old);
+    remaining->last      = new + (remaining->last - old);
+
+    // Memoized nodes refer to the old contents as well.
+    if (push->context.options.memo != NULL) {
+        dil_memo_forget(push->context.options.memo);
+    }
+}
+
+/* Parse the statements upto the boundary without calling the statement
+ * parser at it, since that is only done once at the end of the source file.
+ * A statement that is rejected, or reports errors and reaches the boundary,
+ * might have stopped at the boundary instead of the characters after it. It
+ * is undone, and parsed again after the next boundary arrives. */
+void dil_parse__push(DilParsePush* push, char const* boundary)
+{
+    DilParseContext* context = &push->context;
+    context->remaining.last  = boundary;
+    dil_parse__skip_0(context);
+    while (dil_string_finite(&context->remaining)) {
+        char const* first       = context->remaining.first;
+        size_t      nodes       = dil_tree_size(&context->built);
+        size_t      childeren   = dil_tree_start(&context->built)->childeren;
+        size_t      diagnostics = dil_diagnostics_size(&context->diagnostics);
+        size_t      errors      = context->source.error;
+        DilParseStatistics statistics = {0};
+        if (context->options.statistics != NULL) {
+            statistics = *context->options.statistics;
+        }
+
+        if (dil_parse_statement(context) &&
+            (context->source.error == errors ||
+             dil_string_finite(&context->remaining))) {
+            dil_parse__skip_0(context);
+            continue;
+        }
+
+        context->remaining.first = first;
+        context->built.last      = dil_tree_at(&context->built, nodes);
+        dil_tree_start(&context->built)->childeren = childeren;
+        context->diagnostics.last =
+            dil_diagnostics_at(&context->diagnostics, diagnostics);
+        context->source.error = errors;
+        if (context->options.statistics != NULL) {
+            *context->options.statistics = statistics;
+        }
+        if (context->options.memo != NULL) {
+            dil_memo_forget(context->options.memo);
+        }
+        return;
+    }
+}
+
+/* Start parsing the source file at the path, which is added to the buffer in
+ * chunks. The buffer must stay until the tree is freed. */
+void dil_parse_begin(
+    DilParsePush*   push,
+    DilBuffer*      buffer,
+    char const*     path,
+    DilParseOptions options)
+{
+    *push = (DilParsePush){
+        .context = {
+                    .source  = {.path = path},
+                    .options = options},
+        .buffer  = buffer,
+        .start   = dil_buffer_size(buffer),
+        .scanned = dil_buffer_size(buffer)
+    };
+    push->context.builder.built = &push->context.built;
+
+    // Reserve an element so the contents have a position before the first
+    // chunk arrives.
+    dil_buffer_reserve(buffer, 1);
+    push->context.remaining = (DilString){
+        .first = buffer->first + push->start,
+        .last  = buffer->first + push->start};
+
+    if (options.memo != NULL) {
+        dil_memo_clear(options.memo);
+    }
+
+    dil_parse__open(&push->context);
+}
+
+/* Add the chunk to the source file, and parse the statements that are
+ * complete. */
+void dil_parse_feed(DilParsePush* push, DilString const* chunk)
+{
+    size_t      size = dil_string_size(chunk);
+    char const* old  = push->buffer->first;
+    dil_buffer_reserve(push->buffer, size);
+    memcpy(push->buffer->last, chunk->first, size);
+    push->buffer->last += size;
+    if (push->buffer->first != old) {
+        dil_parse__rebase(push, old);
+    }
+
+    push->context.source.contents = (DilString){
+        .first = push->buffer->first + push->start,
+        .last  = push->buffer->last};
+
+    char const* boundary = dil_boundary_last(
+        &push->scanner,
+        push->buffer->first + push->scanned,
+        push->buffer->last);
+    push->scanned = dil_buffer_size(push->buffer);
+    if (boundary != NULL) {
+        dil_parse__push(push, boundary);
+    }
+}
+
+/* Parse the rest of the source file. Returns the same tree that parsing the
+ * whole source file would. The source file stays in the context. */
+DilTree dil_parse_end(DilParsePush* push)
+{
+    DilParseContext* context = &push->context;
+    context->source.contents = (DilString){
+        .first = push->buffer->first + push->start,
+        .last  = push->buffer->last};
+    context->remaining.last = push->buffer->last;
+
+    (void)dil_parse__statements(context, &dil_parse_statement);
+
+    dil_parse__close(context);
+    return dil_parse__conclude(context);
+}
@@ -0,0 +1,150 @@
+// SPDX-FileCopyrightText: 2022 Cem Geçgel <gecgelcem@outlook.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Ways the offsets of a recall are stored. */
+typedef enum {
+    /* The symbol is not remembered. */
+    DIL_RECALL_OFF,
+    /* Keys of an open addressed hash table, which is for the symbols that
+     * are rejected at a few of the offsets. */
+    DIL_RECALL_SPARSE,
+    /* Bit for each offset of the source file contents, which is for the
+     * symbols that are tried at most of the offsets. */
+    DIL_RECALL_DENSE
+} DilRecallKind;
+
+/* Offsets a symbol was rejected at. Generated parsers remember them for the
+ * rules they can try again at the same offset. Accepted rules are never tried
+ * again at the same offset, so the offsets are all there is to remember. */
+typedef struct {
+    /* How the offsets are stored. */
+    DilRecallKind kind;
+    /* Bits of the offsets if dense, or the offsets plus one if sparse, which
+     * are zero for the unused slots. */
+    size_t* slots;
+    /* Amount of allocated slots. */
+    size_t capacity;
+    /* Amount of offsets if sparse. */
+    size_t size;
+    /* Amount of lookups that found the offset. */
+    size_t hits;
+    /* Amount of lookups that did not find the offset. */
+    size_t misses;
+} DilRecall;
+
+/* Amount of bits in a slot. */
+#define DIL_RECALL_BITS (sizeof(size_t) * CHAR_BIT)
+
+/* Index of the slot the offset hashes to if sparse. */
+size_t dil_recall_hash(DilRecall const* recall, size_t offset)
+{
+    size_t const MULTIPLIER = 0x9E3779B97F4A7C15ULL;
+    return (offset * MULTIPLIER >> 16) & (recall->capacity - 1);
+}
+
+/* Pointer to the slot of the offset, or to the unused slot it would go to, if
+ * sparse. */
+size_t* dil_recall_probe(DilRecall const* recall, size_t offset)
+{
+    size_t index = dil_recall_hash(recall, offset);
+    while (recall->slots[index] != 0 && recall->slots[index] != offset + 1) {
+        index = (index + 1) & (recall->capacity - 1);
+    }
+    return recall->slots + index;
+}
+
+/* Double the capacity and rehash the offsets if sparse. */
+void dil_recall_grow(DilRecall* recall)
+{
+    size_t* slots    = recall->slots;
+    size_t  capacity = recall->capacity;
+
+    recall->capacity = capacity == 0 ? 64 : capacity * 2;
+    recall->slots    = calloc(recall->capacity, sizeof(size_t));
+
+    for (size_t i = 0; i < capacity; i++) {
+        if (slots[i] != 0) {
+            *dil_recall_probe(recall, slots[i] - 1) = slots[i];
+        }
+    }
+    free(slots);
+}
+
+/* Forget the offsets and reset the counters before parsing contents of the
+ * size. Keeps the memory if it is enough. */
+void dil_recall_start(DilRecall* recall, size_t size)
+{
+    if (recall->kind == DIL_RECALL_DENSE) {
+        size_t needed = size / DIL_RECALL_BITS + 1;
+        if (recall->capacity < needed) {
+            free(recall->slots);
+            recall->slots    = malloc(needed * sizeof(size_t));
+            recall->capacity = needed;
+        }
+    }
+    if (recall->slots != NULL) {
+        memset(recall->slots, 0, recall->capacity * sizeof(size_t));
+    }
+    recall->size   = 0;
+    recall->hits   = 0;
+    recall->misses = 0;
+}
+
+/* Whether the symbol was rejected at the offset. */
+bool dil_recall_find(DilRecall* recall, size_t offset)
+{
+    bool found = false;
+    if (recall->kind == DIL_RECALL_DENSE) {
+        size_t bit = (size_t)1 << (offset % DIL_RECALL_BITS);
+        found      = (recall->slots[offset / DIL_RECALL_BITS] & bit) != 0;
+    } else if (recall->size != 0) {
+        found = *dil_recall_probe(recall, offset) != 0;
+    }
+    if (found) {
+        recall->hits++;
+    } else {
+        recall->misses++;
+    }
+    return found;
+}
+
+/* Remember that the symbol was rejected at the offset. */
+void dil_recall_add(DilRecall* recall, size_t offset)
+{
+    if (recall->kind == DIL_RECALL_DENSE) {
+        size_t bit = (size_t)1 << (offset % DIL_RECALL_BITS);
+        recall->slots[offset / DIL_RECALL_BITS] |= bit;
+        return;
+    }
+    if (2 * (recall->size + 1) > recall->capacity) {
+        dil_recall_grow(recall);
+    }
+    size_t* slot = dil_recall_probe(recall, offset);
+    if (*slot == 0) {
+        *slot = offset + 1;
+        recall->size++;
+    }
+}
+
+/* Amount of bytes the offsets take. */
+size_t dil_recall_bytes(DilRecall const* recall)
+{
+    return recall->capacity * sizeof(size_t);
+}
+
+/* Deallocate memory. */
+void dil_recall_free(DilRecall* recall)
+{
+    free(recall->slots);
+    recall->slots    = NULL;
+    recall->capacity = 0;
+    recall->size     = 0;
+}
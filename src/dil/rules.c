@@ -0,0 +1,166 @@
+// SPDX-FileCopyrightText: 2022 Cem Geçgel <gecgelcem@outlook.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "dil/string.c"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Rule in a grammar. */
+typedef struct {
+    /* Name of the rule in the grammar. */
+    DilString name;
+    /* Index of the expression the rule matches. */
+    size_t pattern;
+    /* Whether the rule skips between its elements. */
+    bool skipped;
+    /* Index of the skip style the rule uses if it skips. */
+    size_t skip;
+} DilRule;
+
+/* Contiguous, dynamicly allocated elements. */
+typedef struct {
+    /* Border before the first element. */
+    DilRule* first;
+    /* Border after the last element. */
+    DilRule* last;
+    /* Border after the last allocated element. */
+    DilRule* allocated;
+} DilRules;
+
+/* Amount of elements. */
+size_t dil_rules_size(DilRules const* list)
+{
+    return list->last - list->first;
+}
+
+/* Amount of allocated elements. */
+size_t dil_rules_capacity(DilRules const* list)
+{
+    return list->allocated - list->first;
+}
+
+/* Amount of allocated but unused elements. */
+size_t dil_rules_space(DilRules const* list)
+{
+    return list->allocated - list->last;
+}
+
+/* Whether there are any elements. */
+bool dil_rules_finite(DilRules const* list)
+{
+    return dil_rules_size(list) > 0;
+}
+
+/* Pointer to the element at the index. */
+DilRule* dil_rules_at(DilRules const* list, size_t index)
+{
+    return list->first + index;
+}
+
+/* Element at the index. */
+DilRule dil_rules_get(DilRules const* list, size_t index)
+{
+    return *dil_rules_at(list, index);
+}
+
+/* Pointer to the first element. */
+DilRule* dil_rules_start(DilRules const* list)
+{
+    return list->first;
+}
+
+/* Pointer to the last element. */
+DilRule* dil_rules_finish(DilRules const* list)
+{
+    return list->last - 1;
+}
+
+/* Make sure the amount of elements will fit. Grows by at least half if
+ * necessary. */
+void dil_rules_reserve(DilRules* list, size_t amount)
+{
+    size_t space = dil_rules_space(list);
+    if (amount <= space) {
+        return;
+    }
+
+    size_t growth       = amount - space;
+    size_t capacity     = dil_rules_capacity(list);
+    size_t halfCapacity = capacity / 2;
+    if (growth < halfCapacity) {
+        growth = halfCapacity;
+    }
+
+    size_t   newCapacity = capacity + growth;
+    DilRule* memory = realloc(list->first, newCapacity * sizeof(DilRule));
+
+    list->last      = memory + dil_rules_size(list);
+    list->first     = memory;
+    list->allocated = memory + newCapacity;
+}
+
+/* Add the element to the end. */
+void dil_rules_add(DilRules* list, DilRule element)
+{
+    dil_rules_reserve(list, 1);
+    *list->last++ = element;
+}
+
+/* Open space at the index for the amount of element. Returns pointer to the
+ * first opened element. */
+DilRule* dil_rules_open(DilRules* list, size_t index, size_t amount)
+{
+    dil_rules_reserve(list, amount);
+    DilRule* position = list->first + index;
+    memmove(position + amount, position, amount * sizeof(DilRule));
+    list->last += amount;
+    return position;
+}
+
+/* Put the element to the given index. */
+void dil_rules_put(DilRules* list, size_t index, DilRule element)
+{
+    *dil_rules_open(list, index, 1) = element;
+}
+
+/* Place the element the amount of times to the end. */
+void dil_rules_place(DilRules* list, size_t amount, DilRule element)
+{
+    dil_rules_reserve(list, amount);
+    for (size_t i = 0; i < amount; i++) {
+        *list->last++ = element;
+    }
+}
+
+/* Remove from the end. */
+void dil_rules_remove(DilRules* list)
+{
+    list->last--;
+}
+
+/* Remove from the end and return the removed element. */
+DilRule dil_rules_pop(DilRules* list)
+{
+    dil_rules_remove(list);
+    return *list->last;
+}
+
+/* Remove all the elements. Keeps the memory. */
+void dil_rules_clear(DilRules* list)
+{
+    list->last = list->first;
+}
+
+/* Deallocate memory. */
+void dil_rules_free(DilRules* list)
+{
+    free(list->first);
+    list->first     = NULL;
+    list->last      = NULL;
+    list->allocated = NULL;
+}
@@ -0,0 +1,247 @@
+// SPDX-FileCopyrightText: 2022 Cem Geçgel <gecgelcem@outlook.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "dil/class.c"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#    define DIL_SCAN_X86
+#    include <immintrin.h>
+#    if defined(_MSC_VER)
+#        include <intrin.h>
+#        define DIL_SCAN_AVX2
+#    else
+#        define DIL_SCAN_AVX2 __attribute__((target("avx2")))
+#    endif
+#endif
+
+/* Amount of elements that are tested one by one before a vectorized scan is
+ * prepared. Most runs in the source files are shorter than this. */
+#define DIL_SCAN_PREFIX 32
+
+/* Maximum amount of ranges a vectorized scan can test. */
+#define DIL_SCAN_RANGES 4
+
+/* Class as contiguous ranges of elements for the vectorized kernels. */
+typedef struct {
+    /* First element of each range. */
+    unsigned char start[DIL_SCAN_RANGES];
+    /* Amount of elements after the first one in each range. */
+    unsigned char extent[DIL_SCAN_RANGES];
+    /* Amount of ranges. */
+    size_t count;
+} DilScanRanges;
+
+/* Find the first element from the first to the last that is in the class if
+ * the target is true, or that is not in the class otherwise. Returns the last
+ * if there is none. Tests the elements one by one. */
+char const* dil_scan_scalar(
+    char const*         first,
+    char const*         last,
+    DilCharClass const* set,
+    bool                target)
+{
+    while (first < last && dil_char_class_contains(set, *first) != target) {
+        first++;
+    }
+    return first;
+}
+
+/* Convert the elements that are in the class if the target is true, or that
+ * are not in the class otherwise, to ranges. Returns whether they fit. */
+bool dil_scan_ranges(
+    DilScanRanges*      ranges,
+    DilCharClass const* set,
+    bool                target)
+{
+    ranges->count = 0;
+    unsigned value = 0;
+    while (value <= 255) {
+        if (dil_char_class_contains(set, (char)value) != target) {
+            value++;
+            continue;
+        }
+        if (ranges->count == DIL_SCAN_RANGES) {
+            return false;
+        }
+        unsigned start = value;
+        while (value <= 255 &&
+               dil_char_class_contains(set, (char)value) == target) {
+            value++;
+        }
+        ranges->start[ranges->count]  = (unsigned char)start;
+        ranges->extent[ranges->count] = (unsigned char)(value - 1 - start);
+        ranges->count++;
+    }
+    return true;
+}
+
+#if defined(DIL_SCAN_X86)
+
+/* Find the first element that is in the ranges, 16 elements at a time. Returns
+ * the last if there is none, and leaves at most 15 elements at the end. */
+char const* dil_scan_sse2(
+    char const*          first,
+    char const*          last,
+    DilScanRanges const* ranges)
+{
+    __m128i start[DIL_SCAN_RANGES];
+    __m128i extent[DIL_SCAN_RANGES];
+    for (size_t i = 0; i < ranges->count; i++) {
+        start[i]  = _mm_set1_epi8((char)ranges->start[i]);
+        extent[i] = _mm_set1_epi8((char)ranges->extent[i]);
+    }
+    __m128i const ZERO = _mm_setzero_si128();
+
+    for (; last - first >= 16; first += 16) {
+        __m128i block = _mm_loadu_si128((__m128i const*)first);
+        __m128i found = ZERO;
+        for (size_t i = 0; i < ranges->count; i++) {
+            // Element is in the range when its distance to the start does not
+            // exceed the extent, which saturates to zero.
+            __m128i distance = _mm_sub_epi8(block, start[i]);
+            __m128i excess   = _mm_subs_epu8(distance, extent[i]);
+            found = _mm_or_si128(found, _mm_cmpeq_epi8(excess, ZERO));
+        }
+        unsigned mask = (unsigned)_mm_movemask_epi8(found);
+        if (mask != 0) {
+#    if defined(_MSC_VER)
+            unsigned long index = 0;
+            _BitScanForward(&index, mask);
+            return first + index;
+#    else
+            return first + __builtin_ctz(mask);
+#    endif
+        }
+    }
+    return first;
+}
+
+/* Find the first element that is in the ranges, 32 elements at a time. Returns
+ * the last if there is none, and leaves at most 31 elements at the end. */
+DIL_SCAN_AVX2 char const* dil_scan_avx2(
+    char const*          first,
+    char const*          last,
+    DilScanRanges const* ranges)
+{
+    __m256i start[DIL_SCAN_RANGES];
+    __m256i extent[DIL_SCAN_RANGES];
+    for (size_t i = 0; i < ranges->count; i++) {
+        start[i]  = _mm256_set1_epi8((char)ranges->start[i]);
+        extent[i] = _mm256_set1_epi8((char)ranges->extent[i]);
+    }
+    __m256i const ZERO = _mm256_setzero_si256();
+
+    for (; last - first >= 32; first += 32) {
+        __m256i block = _mm256_loadu_si256((__m256i const*)first);
+        __m256i found = ZERO;
+        for (size_t i = 0; i < ranges->count; i++) {
+            __m256i distance = _mm256_sub_epi8(block, start[i]);
+            __m256i excess   = _mm256_subs_epu8(distance, extent[i]);
+            found = _mm256_or_si256(found, _mm256_cmpeq_epi8(excess, ZERO));
+        }
+        unsigned mask = (unsigned)_mm256_movemask_epi8(found);
+        if (mask != 0) {
+#    if defined(_MSC_VER)
+            unsigned long index = 0;
+            _BitScanForward(&index, mask);
+            return first + index;
+#    else
+            return first + __builtin_ctz(mask);
+#    endif
+        }
+    }
+    return first;
+}
+
+/* Whether the processor and the operating system support AVX2. */
+bool dil_scan_detect_avx2(void)
+{
+#    if defined(_MSC_VER)
+    int registers[4];
+    __cpuid(registers, 0);
+    if (registers[0] < 7) {
+        return false;
+    }
+    __cpuid(registers, 1);
+    bool osxsave = (registers[2] & (1 << 27)) != 0;
+    bool avx     = (registers[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+    __cpuidex(registers, 7, 0);
+    return (registers[1] & (1 << 5)) != 0;
+#    else
+    return __builtin_cpu_supports("avx2");
+#    endif
+}
+
+/* Kernel that finds the first element in the ranges on this processor. */
+typedef char const* (*DilScanKernel)(
+    char const*          first,
+    char const*          last,
+    DilScanRanges const* ranges);
+
+/* Kernel for this processor. Selected at the first vectorized scan; the
+ * threads that race to it select and store the same kernel atomically. */
+DilScanKernel dil_scan_kernel(void)
+{
+    static _Atomic(DilScanKernel) kernel = NULL;
+    DilScanKernel selected =
+        atomic_load_explicit(&kernel, memory_order_relaxed);
+    if (selected == NULL) {
+        selected = dil_scan_detect_avx2() ? &dil_scan_avx2 : &dil_scan_sse2;
+        atomic_store_explicit(&kernel, selected, memory_order_relaxed);
+    }
+    return selected;
+}
+
+#endif
+
+/* Find the first element from the first to the last that is in the class if
+ * the target is true, or that is not in the class otherwise. Returns the last
+ * if there is none. */
+char const* dil_scan_find(
+    char const*         first,
+    char const*         last,
+    DilCharClass const* set,
+    bool                target)
+{
+    char const* prefix = last - first > DIL_SCAN_PREFIX
+                           ? first + DIL_SCAN_PREFIX
+                           : last;
+    first = dil_scan_scalar(first, prefix, set, target);
+    if (first != prefix || first == last) {
+        return first;
+    }
+
+#if defined(DIL_SCAN_X86)
+    DilScanRanges ranges;
+    if (dil_scan_ranges(&ranges, set, target)) {
+        first = dil_scan_kernel()(first, last, &ranges);
+    }
+#endif
+
+    return dil_scan_scalar(first, last, set, target);
+}
+
+/* Position after the run of elements from the class that starts at the
+ * first. */
+char const*
+dil_scan_while(char const* first, char const* last, DilCharClass const* set)
+{
+    return dil_scan_find(first, last, set, false);
+}
+
+/* Position of the first element from the class, or the last if there is
+ * none. */
+char const*
+dil_scan_until(char const* first, char const* last, DilCharClass const* set)
+{
+    return dil_scan_find(first, last, set, true);
+}
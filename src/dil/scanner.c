@@ -0,0 +1,59 @@
+// SPDX-FileCopyrightText: 2022 Cem Geçgel <gecgelcem@outlook.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Ways a scanner stops, which are numbered before its states. */
+typedef enum {
+    /* Recognized the characters before the end. */
+    DIL_SCANNER_ACCEPT,
+    /* The rule cannot start at the first character. */
+    DIL_SCANNER_REJECT,
+    /* The characters are not recognized without an error, which the parser
+     * must report. */
+    DIL_SCANNER_FALLBACK,
+    /* Amount of ways, which is the number of the first state. */
+    DIL_SCANNER_STATES
+} DilScannerOutcome;
+
+/* Deterministic automaton that recognizes a rule byte by byte. The
+ * characters are grouped to columns that are not told apart by the rule. */
+typedef struct {
+    /* Column of each character, and of the end of the contents after
+     * them. */
+    unsigned char const* columns;
+    /* Amount of columns. */
+    size_t width;
+    /* Next state or the outcome at each column of each state, row by row
+     * from the first state. */
+    unsigned char const* table;
+    /* State the scanner starts at. */
+    unsigned char start;
+} DilScanner;
+
+/* Run the scanner on the characters from the first until the last. Puts the
+ * border after the recognized characters to the end. */
+DilScannerOutcome dil_scanner_run(
+    DilScanner const* scanner,
+    char const*       first,
+    char const*       last,
+    char const**      end)
+{
+    unsigned state = scanner->start;
+    while (true) {
+        unsigned column = first < last ? scanner->columns[(unsigned char)*first]
+                                       : scanner->columns[UCHAR_MAX + 1];
+        unsigned row    = state - DIL_SCANNER_STATES;
+        unsigned next   = scanner->table[row * scanner->width + column];
+        if (next < DIL_SCANNER_STATES) {
+            *end = first;
+            return (DilScannerOutcome)next;
+        }
+        state = next;
+        first++;
+    }
+}
@@ -0,0 +1,109 @@
+// SPDX-FileCopyrightText: 2022 Cem Geçgel <gecgelcem@outlook.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "dil/builder.c"
+#include "dil/diagnostics.c"
+#include "dil/frames.c"
+#include "dil/indices.c"
+#include "dil/memo.c"
+#include "dil/parser.c"
+#include "dil/source.c"
+#include "dil/tree.c"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Parsing processes that run one after the other and reuse the memory of the
+ * previous ones. The tree, the parent stack, the memo and the errors are
+ * cleared instead of deallocated, so parsing many small source files does
+ * not grow them from nothing each time. */
+typedef struct {
+    /* Context that is reused by each parsing process. */
+    DilParseContext context;
+    /* Memo that is reused if the options use one. */
+    DilMemo memo;
+    /* Options of the parsing processes. */
+    DilParseOptions options;
+    /* Amount of nodes or errors a buffer can hold before it is deallocated
+     * instead of cleared, or zero to always keep the memory. Keeps a single
+     * large source file from holding memory for the following small ones. */
+    size_t trim;
+} DilParseSession;
+
+/* Create a session that parses with the options, and trims the buffers that
+ * grew past the amount of elements unless it is zero. The memo of the options
+ * is replaced by the session's own if it is not null. */
+void dil_parse_session_init(
+    DilParseSession* session,
+    DilParseOptions  options,
+    size_t           trim)
+{
+    *session = (DilParseSession){.options = options, .trim = trim};
+    if (options.memo != NULL) {
+        session->options.memo = &session->memo;
+    }
+}
+
+/* Clear the buffers of the session, or deallocate the ones that grew past the
+ * trim amount. */
+void dil_parse_session_reset(DilParseSession* session)
+{
+    DilParseContext* context = &session->context;
+    size_t           trim    = session->trim;
+    if (trim != 0 && dil_tree_capacity(&context->built) > trim) {
+        dil_tree_free(&context->built);
+    }
+    if (trim != 0 && dil_diagnostics_capacity(&context->diagnostics) > trim) {
+        dil_diagnostics_free(&context->diagnostics);
+    }
+    if (trim != 0 && (session->memo.capacity > trim ||
+                      dil_tree_capacity(&session->memo.nodes) > trim)) {
+        dil_memo_free(&session->memo);
+    }
+
+    dil_tree_clear(&context->built);
+    dil_builder_clear(&context->builder);
+    dil_indices_clear(&context->omissions);
+    dil_indices_clear(&context->reports);
+    dil_frames_clear(&context->frames);
+    dil_diagnostics_clear(&context->diagnostics);
+    if (session->options.memo != NULL) {
+        dil_memo_clear(&session->memo);
+    }
+}
+
+/* Parses the source file in the session. Returns the tree, which belongs to
+ * the session and is valid until the next parsing process. */
+DilTree const* dil_parse_session(DilParseSession* session, DilSource source)
+{
+    dil_parse_session_reset(session);
+
+    DilParseContext* context = &session->context;
+    context->builder.built   = &context->built;
+    context->remaining       = source.contents;
+    context->source          = source;
+    context->skip            = false;
+    context->options         = session->options;
+    context->result          = false;
+    context->steps           = 0;
+    context->exhausted       = false;
+
+    dil_parse__start(context, &dil_parse_statement);
+    dil_parse__deliver(context);
+    return &context->built;
+}
+
+/* Deallocate memory. */
+void dil_parse_session_free(DilParseSession* session)
+{
+    DilParseContext* context = &session->context;
+    dil_tree_free(&context->built);
+    dil_builder_free(&context->builder);
+    dil_indices_free(&context->omissions);
+    dil_indices_free(&context->reports);
+    dil_frames_free(&context->frames);
+    dil_diagnostics_free(&context->diagnostics);
+    dil_memo_free(&session->memo);
+}
@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: 2022 Cem Geçgel <gecgelcem@outlook.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "dil/diagnostics.c"
+#include "dil/source.c"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <threads.h>
+
+/* Diagnostics that are collected from parsing processes, which might run on
+ * different threads. Each process records its diagnostics on its own, and
+ * adds them here at once when it ends, so the lock is not taken while
+ * parsing. */
+typedef struct {
+    /* Collected diagnostics, in the order the processes ended. Those of a
+     * process are together and in the order they were found. */
+    DilDiagnostics diagnostics;
+    /* Maximum amount of diagnostics that are kept, or zero for no limit. */
+    size_t limit;
+    /* Amount of diagnostics that were counted but not kept because of the
+     * limit. */
+    size_t dropped;
+    /* Lock of the collected diagnostics and the counter. */
+    mtx_t lock;
+} DilSink;
+
+/* Create a sink that keeps at most the limit of diagnostics, or all of them
+ * if the limit is zero. */
+void dil_sink_init(DilSink* sink, size_t limit)
+{
+    *sink = (DilSink){.limit = limit};
+    (void)mtx_init(&sink->lock, mtx_plain);
+}
+
+/* Add the diagnostics of a process that found the amount of errors, which
+ * might be more than it recorded. Counts the ones that are not kept as
+ * dropped. */
+void dil_sink_add(
+    DilSink*              sink,
+    DilDiagnostics const* diagnostics,
+    size_t                found)
+{
+    if (found == 0) {
+        return;
+    }
+
+    (void)mtx_lock(&sink->lock);
+    size_t kept = dil_diagnostics_size(diagnostics);
+    if (sink->limit != 0) {
+        size_t size  = dil_diagnostics_size(&sink->diagnostics);
+        size_t space = size < sink->limit ? sink->limit - size : 0;
+        if (kept > space) {
+            kept = space;
+        }
+    }
+    if (kept > 0) {
+        dil_diagnostics_reserve(&sink->diagnostics, kept);
+        memcpy(
+            sink->diagnostics.last,
+            diagnostics->first,
+            kept * sizeof(DilDiagnostic));
+        sink->diagnostics.last += kept;
+    }
+    sink->dropped += found - kept;
+    (void)mtx_unlock(&sink->lock);
+}
+
+/* Whether a process can stop recording after the amount of diagnostics,
+ * since the sink would drop the rest anyway. */
+bool dil_sink_full(DilSink const* sink, size_t amount)
+{
+    return sink->limit != 0 && amount >= sink->limit;
+}
+
+/* Print the kept diagnostics that are in the source file. Must not be called
+ * while processes are adding to the sink. */
+void dil_sink_print(DilSink const* sink, DilSource const* source)
+{
+    dil_diagnostics_print(&sink->diagnostics, source);
+}
+
+/* Deallocate memory. */
+void dil_sink_free(DilSink* sink)
+{
+    dil_diagnostics_free(&sink->diagnostics);
+    mtx_destroy(&sink->lock);
+}
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "dil/buffer.c"
+#include "dil/indices.c"
 #include "dil/string.c"
 
 #include <stddef.h>
@@ -18,6 +19,10 @@ typedef struct {
     DilString contents;
     /* Whether the file has errors. */
     size_t error;
+    /* Offset of the first character of each line, which is built by
+     * dil_source_index. Locations are found by walking the contents if it
+     * is empty. */
+    DilIndices lines;
 } DilSource;
 
 /* Location of a character in the source file. */
@@ -38,6 +43,16 @@ typedef struct {
     DilSourceLocation end;
 } DilSourcePortion;
 
+/* Change to a source file. */
+typedef struct {
+    /* Index of the first changed character. */
+    size_t offset;
+    /* Amount of characters that are removed from the offset. */
+    size_t removed;
+    /* Characters that are inserted to the offset. */
+    DilString inserted;
+} DilSourceEdit;
+
 /* Load the source file at the path to the memory to the buffer. */
 DilSource dil_source_load(DilBuffer* buffer, char const* path)
 {
@@ -66,11 +81,73 @@ DilSource dil_source_load(DilBuffer* buffer, char const* path)
     return result;
 }
 
+/* Build the line index of the contents. Must be built again after the
+ * contents change. */
+void dil_source_index(DilSource* source)
+{
+    dil_indices_clear(&source->lines);
+    dil_indices_add(&source->lines, 0);
+
+    char const* first = source->contents.first;
+    char const* last  = source->contents.last;
+    char const* found = first;
+    while ((found = memchr(found, '\n', last - found)) != NULL) {
+        found++;
+        dil_indices_add(&source->lines, found - first);
+    }
+}
+
+/* Apply the edit to the contents of the source file, which must be at the end
+ * of the buffer. Builds the line index again if there is one. */
+void dil_source_edit(
+    DilBuffer*           buffer,
+    DilSource*           source,
+    DilSourceEdit const* edit)
+{
+    size_t start    = source->contents.first - buffer->first;
+    size_t inserted = dil_string_size(&edit->inserted);
+    size_t kept =
+        dil_string_size(&source->contents) - edit->offset - edit->removed;
+    if (inserted > edit->removed) {
+        dil_buffer_reserve(buffer, inserted - edit->removed);
+    }
+
+    char* position = buffer->first + start + edit->offset;
+    memmove(position + inserted, position + edit->removed, kept);
+    memcpy(position, edit->inserted.first, inserted);
+    buffer->last = position + inserted + kept;
+
+    source->contents.first = buffer->first + start;
+    source->contents.last  = buffer->last;
+    if (dil_indices_finite(&source->lines)) {
+        dil_source_index(source);
+    }
+}
+
 /* Find the location of the character at the position in the source file. */
 DilSourceLocation
 dil_source_locate(DilSource const* source, char const* position)
 {
     DilSourceLocation result = {.position = position, .line = 1, .column = 1};
+
+    // Find the last line that starts before the position.
+    if (dil_indices_finite(&source->lines)) {
+        size_t offset = position - source->contents.first;
+        size_t first  = 1;
+        size_t last   = dil_indices_size(&source->lines);
+        while (first < last) {
+            size_t middle = first + (last - first) / 2;
+            if (dil_indices_get(&source->lines, middle) <= offset) {
+                first = middle + 1;
+            } else {
+                last = middle;
+            }
+        }
+        result.line   = first;
+        result.column = offset - dil_indices_get(&source->lines, first - 1) + 1;
+        return result;
+    }
+
     for (char const* i = source->contents.first; i < position; i++) {
         if (*i == '\n') {
             result.line++;
@@ -82,6 +159,48 @@ dil_source_locate(DilSource const* source, char const* position)
     return result;
 }
 
+/* Find the locations of the amount of positions, which must be in order, in
+ * a single pass over the source file. */
+void dil_source_locate_all(
+    DilSource const*   source,
+    char const* const* positions,
+    size_t             amount,
+    DilSourceLocation* locations)
+{
+    DilSourceLocation current = {
+        .position = source->contents.first,
+        .line     = 1,
+        .column   = 1};
+    size_t line = 1;
+    for (size_t i = 0; i < amount; i++) {
+        char const* position = positions[i];
+
+        // Move over the lines with the index, or over the characters.
+        if (dil_indices_finite(&source->lines)) {
+            size_t offset = position - source->contents.first;
+            while (line < dil_indices_size(&source->lines) &&
+                   dil_indices_get(&source->lines, line) <= offset) {
+                line++;
+            }
+            current = (DilSourceLocation){
+                .position = position,
+                .line     = line,
+                .column =
+                    offset - dil_indices_get(&source->lines, line - 1) + 1};
+        } else {
+            for (; current.position < position; current.position++) {
+                if (*current.position == '\n') {
+                    current.line++;
+                    current.column = 1;
+                } else {
+                    current.column++;
+                }
+            }
+        }
+        locations[i] = current;
+    }
+}
+
 /* Find the location of the begining of the line the location is in. */
 DilSourceLocation dil_source_locate_start(DilSourceLocation const* location)
 {
@@ -185,3 +304,9 @@ void dil_source_print(
     }
     printf("\n");
 }
+
+/* Deallocate memory. */
+void dil_source_free(DilSource* source)
+{
+    dil_indices_free(&source->lines);
+}
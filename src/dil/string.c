@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include "dil/class.c"
+
 #include <stdbool.h>
 #include <stddef.h>
 
@@ -123,6 +125,9 @@ bool dil_string_finishes_fit(DilString const* view, bool (*predicate)(char))
 /* Remove the elements from the ends if they exist. */
 void dil_string_unwrap(DilString* string, char opening, char closing)
 {
+    if (dil_string_size(string) < 2) {
+        return;
+    }
     bool starts   = dil_string_starts(string, opening);
     bool finishes = dil_string_finishes(string, closing);
     if (starts && finishes) {
@@ -249,6 +254,30 @@ bool dil_string_prefix_not_set(DilString* string, DilString const* set)
     return false;
 }
 
+/* Whether the view starts with an element of the class. Consumes the element
+ * when true. */
+bool dil_string_prefix_class(DilString* string, DilCharClass const* set)
+{
+    if (dil_string_finite(string) &&
+        dil_char_class_contains(set, *string->first)) {
+        string->first++;
+        return true;
+    }
+    return false;
+}
+
+/* Whether the view does not start with an element of the class. Consumes the
+ * element when true. */
+bool dil_string_prefix_not_class(DilString* string, DilCharClass const* set)
+{
+    if (dil_string_finite(string) &&
+        !dil_char_class_contains(set, *string->first)) {
+        string->first++;
+        return true;
+    }
+    return false;
+}
+
 /* Whether the view starts with the prefix. Consumes the prefix when true. */
 bool dil_string_prefix_check(DilString* string, DilString const* prefix)
 {
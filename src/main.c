@@ -1,18 +1,170 @@
 // SPDX-FileCopyrightText: 2022 Cem Geçgel <gecgelcem@outlook.com>
 // SPDX-License-Identifier: GPL-3.0-or-later
 
+#include "dil/batch.c"
+#include "dil/boundary.c"
+#include "dil/bounded.c"
 #include "dil/buffer.c"
 #include "dil/builder.c"
+#include "dil/diagnostics.c"
+#include "dil/generator.c"
+#include "dil/grammar.c"
+#include "dil/incremental.c"
 #include "dil/indices.c"
+#include "dil/iterative.c"
+#include "dil/machine.c"
 #include "dil/object.c"
+#include "dil/parallel.c"
 #include "dil/parser.c"
+#include "dil/program.c"
+#include "dil/push.c"
+#include "dil/session.c"
+#include "dil/sink.c"
 #include "dil/source.c"
 #include "dil/string.c"
 #include "dil/tree.c"
 
+#include <Windows.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sysinfoapi.h>
+
+/* Parse the source files at the arguments after the first one on a thread
+ * for each processor, or the amount given with `--threads`. */
+int main_batch(int argumentCount, char const* const* arguments)
+{
+    SYSTEM_INFO system;
+    GetSystemInfo(&system);
+
+    DilBatch batch = {.threads = system.dwNumberOfProcessors};
+    int      first = 2;
+    if (argumentCount > 3 && strcmp(arguments[2], "--threads") == 0) {
+        batch.threads = strtoull(arguments[3], NULL, 10);
+        first         = 4;
+    }
+    if (batch.threads == 0) {
+        batch.threads = 1;
+    }
+
+    dil_batch_run(&batch, arguments + first, argumentCount - first);
+    dil_batch_print(stdout, &batch);
+
+    bool failed = false;
+    for (size_t i = 0; i < batch.amount; i++) {
+        failed = failed || batch.files[i].source.error != 0;
+    }
+    dil_batch_free(&batch);
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/* Generate the parser of the grammar at the second argument to the path at
+ * the third one, with the prefix at the fourth one if it is given. The rules
+ * named after it keep their nodes, or every rule does with `--exact`. The
+ * parser can also call callbacks instead of building the tree with
+ * `--events`. */
+int main_generate(int argumentCount, char const* const* arguments)
+{
+    if (argumentCount < 4) {
+        printf(
+            "Usage: --generate <grammar> <output> [prefix [--events] "
+            "[--exact | rule...]]\n");
+        return EXIT_FAILURE;
+    }
+
+    DilBuffer          buffer     = {0};
+    DilBuffer          generated  = {0};
+    DilParseStatistics statistics = {0};
+    DilSource          source     = dil_source_load(&buffer, arguments[2]);
+    DilTree            tree       = dil_parse_with(
+        source,
+        (DilParseOptions){.statistics = &statistics});
+    DilGenerateOptions options    = {.report = stdout};
+    int                rest       = 5;
+    if (argumentCount > 4) {
+        options.prefix = arguments[4];
+    }
+    if (argumentCount > rest && strcmp(arguments[rest], "--events") == 0) {
+        options.events = true;
+        rest++;
+    }
+    if (argumentCount > rest && strcmp(arguments[rest], "--exact") == 0) {
+        options.exact = true;
+    } else if (argumentCount > rest) {
+        options.kept = arguments + rest;
+    }
+
+    bool succeeded = statistics.errors == 0 &&
+                     dil_generate_with(&generated, &tree, options);
+    if (succeeded) {
+        FILE* stream = fopen(arguments[3], "w");
+        if (stream == NULL) {
+            printf("Could not open file %s!\n", arguments[3]);
+            succeeded = false;
+        } else {
+            (void)fwrite(
+                generated.first,
+                sizeof(char),
+                dil_buffer_size(&generated),
+                stream);
+            (void)fclose(stream);
+        }
+    }
+
+    dil_buffer_free(&generated);
+    dil_tree_free(&tree);
+    dil_buffer_free(&buffer);
+    return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* Compile the grammar at the second argument at runtime, and parse the source
+ * files at the arguments after it by running the compiled grammar. */
+int main_machine(int argumentCount, char const* const* arguments)
+{
+    if (argumentCount < 3) {
+        printf("Usage: --machine <grammar> [source...]\n");
+        return EXIT_FAILURE;
+    }
+
+    DilBuffer          buffer     = {0};
+    DilParseStatistics statistics = {0};
+    DilSource          source     = dil_source_load(&buffer, arguments[2]);
+    DilTree            tree       = dil_parse_with(
+        source,
+        (DilParseOptions){.statistics = &statistics});
+    DilProgram         program    = {0};
+    bool               succeeded  = statistics.errors == 0 &&
+                                   dil_program_compile(&program, &tree);
+    if (succeeded) {
+        printf(
+            "%s: Compiled into %llu instructions.\n",
+            arguments[2],
+            dil_instructions_size(&program.code));
+    }
+
+    for (int i = 3; i < argumentCount && succeeded; i++) {
+        DilBuffer          file   = {0};
+        DilParseStatistics counts = {0};
+        DilSource          parsed = dil_source_load(&file, arguments[i]);
+        DilTree            result = dil_machine_parse_with(
+            &program,
+            parsed,
+            (DilParseOptions){.statistics = &counts});
+        printf(
+            "%s: Parsed %llu nodes.\n",
+            arguments[i],
+            dil_tree_size(&result));
+        succeeded = counts.errors == 0;
+        dil_tree_free(&result);
+        dil_buffer_free(&file);
+    }
+
+    dil_program_free(&program);
+    dil_tree_free(&tree);
+    dil_buffer_free(&buffer);
+    return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
 
 /* Start the program. */
 int main(int argumentCount, char const* const* arguments)
@@ -24,6 +176,16 @@ int main(int argumentCount, char const* const* arguments)
     }
     printf("\n");
 
+    if (argumentCount > 1 && strcmp(arguments[1], "--batch") == 0) {
+        return main_batch(argumentCount, arguments);
+    }
+    if (argumentCount > 1 && strcmp(arguments[1], "--generate") == 0) {
+        return main_generate(argumentCount, arguments);
+    }
+    if (argumentCount > 1 && strcmp(arguments[1], "--machine") == 0) {
+        return main_machine(argumentCount, arguments);
+    }
+
     DilBuffer buffer = {0};
     DilSource source = dil_source_load(&buffer, arguments[1]);
     DilTree   tree   = dil_parse(source);